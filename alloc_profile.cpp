@@ -0,0 +1,283 @@
+/*
+ * Trabalho de Compiladores - Perfil de Alocação
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo implementa os contadores por fase, a medição do pico de RSS e,
+ * com -DUSE_ALLOC_PROFILER, a substituição dos operator new/delete globais.
+ *
+ * Data: Outubro de 2026
+ */
+
+#include "alloc_profile.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iomanip>
+#include <new>
+#include <string>
+#include <unistd.h>
+
+static const char *NOMES_FASES[NUM_FASES] = {"outros", "léxico", "sintático", "relatório"};
+
+// Contadores globais (compartilhados entre threads); só inteiros atômicos, já
+// que nada aqui pode alocar
+struct ContadoresFase
+{
+    atomic<uint64_t> alocacoes{0};
+    atomic<uint64_t> liberacoes{0};
+    atomic<uint64_t> bytes{0};
+    atomic<uint64_t> pico_vivo{0};
+    atomic<long> pico_rss_kb{0};
+};
+
+static ContadoresFase contadores[NUM_FASES];
+static atomic<uint64_t> bytes_vivos{0};
+static thread_local AllocPhase fase_atual = FASE_OUTROS;
+
+AllocPhase set_alloc_phase(AllocPhase fase)
+{
+    AllocPhase anterior = fase_atual;
+    fase_atual = fase;
+    return anterior;
+}
+
+AllocStats alloc_stats(AllocPhase fase)
+{
+    const ContadoresFase &c = contadores[fase];
+    AllocStats st;
+    st.alocacoes = c.alocacoes.load(memory_order_relaxed);
+    st.liberacoes = c.liberacoes.load(memory_order_relaxed);
+    st.bytes = c.bytes.load(memory_order_relaxed);
+    st.pico_vivo = c.pico_vivo.load(memory_order_relaxed);
+    st.pico_rss_kb = c.pico_rss_kb.load(memory_order_relaxed);
+    return st;
+}
+
+// ==========================
+// Pico de RSS
+// ==========================
+
+// Lido com open/read para não alocar dentro do perfil
+static long ler_vmhwm_kb()
+{
+    int fd = open("/proc/self/status", O_RDONLY);
+    if (fd < 0)
+        return 0;
+    char buf[4096];
+    ssize_t n = read(fd, buf, sizeof(buf) - 1);
+    close(fd);
+    if (n <= 0)
+        return 0;
+    buf[n] = '\0';
+    const char *p = strstr(buf, "VmHWM:");
+    return p != nullptr ? strtol(p + 6, nullptr, 10) : 0;
+}
+
+// Sem permissão (ou em kernels antigos) o pico não é zerado e cada fase vê o
+// pico acumulado do processo
+static void zerar_vmhwm()
+{
+    int fd = open("/proc/self/clear_refs", O_WRONLY);
+    if (fd < 0)
+        return;
+    if (write(fd, "5", 1) != 1)
+    {
+        // ignora: o pico continua sendo o do processo
+    }
+    close(fd);
+}
+
+AllocScope::AllocScope(AllocPhase fase, bool ativo) : fase(fase), ativo(ativo)
+{
+    if (!ativo)
+        return;
+    anterior = set_alloc_phase(fase);
+    zerar_vmhwm();
+}
+
+AllocScope::~AllocScope()
+{
+    encerrar();
+}
+
+void AllocScope::encerrar()
+{
+    if (!ativo)
+        return;
+    ativo = false;
+    long rss = ler_vmhwm_kb();
+    atomic<long> &pico = contadores[fase].pico_rss_kb;
+    long atual = pico.load(memory_order_relaxed);
+    while (rss > atual && !pico.compare_exchange_weak(atual, rss, memory_order_relaxed))
+        ;
+    set_alloc_phase(anterior);
+}
+
+// ==========================
+// Relatório
+// ==========================
+
+void alloc_report(ostream &out, size_t tokens, size_t passos)
+{
+    bool alocacoes = alloc_profiler_enabled();
+    out << "\n=== Perfil de alocação ===\n";
+    if (!alocacoes)
+        out << "(alocações não medidas: compile com -DUSE_ALLOC_PROFILER)\n";
+
+    out << "fase        ";
+    if (alocacoes)
+        out << setw(14) << "alocações" << setw(14) << "liberações" << setw(14) << "bytes" << setw(14) << "pico vivo";
+    out << setw(14) << "pico RSS KB" << '\n';
+
+    for (int f = FASE_LEXICO; f <= NUM_FASES; f++)
+    {
+        AllocPhase fase = f == NUM_FASES ? FASE_OUTROS : (AllocPhase)f; // "outros" por último
+        AllocStats st = alloc_stats(fase);
+        if (fase == FASE_OUTROS && st.alocacoes == 0)
+            continue;
+        // setw conta bytes: completa pelo número de caracteres UTF-8
+        size_t caracteres = 0;
+        for (const char *c = NOMES_FASES[fase]; *c; c++)
+            caracteres += (*c & 0xC0) != 0x80;
+        out << NOMES_FASES[fase] << string(12 - caracteres, ' ');
+        if (alocacoes)
+            out << setw(12) << st.alocacoes << setw(12) << st.liberacoes << setw(14) << st.bytes << setw(14) << st.pico_vivo;
+        // Fases sem AllocScope próprio (léxico em fluxo) não têm RSS medido
+        if (st.pico_rss_kb > 0)
+            out << setw(14) << st.pico_rss_kb << '\n';
+        else
+            out << setw(14) << "-" << '\n';
+    }
+
+    if (alocacoes)
+    {
+        AllocStats lexico = alloc_stats(FASE_LEXICO);
+        AllocStats sintatico = alloc_stats(FASE_SINTATICO);
+        out << fixed << setprecision(2);
+        out << "Alocações por token (léxico): " << (tokens ? (double)lexico.alocacoes / tokens : 0.0) << " (" << tokens
+            << " tokens)\n";
+        out << "Alocações por passo (sintático): " << (passos ? (double)sintatico.alocacoes / passos : 0.0) << " (" << passos
+            << " passos)\n";
+        out.unsetf(ios::floatfield);
+    }
+}
+
+// ==========================
+// operator new/delete
+// ==========================
+
+#ifdef USE_ALLOC_PROFILER
+
+bool alloc_profiler_enabled()
+{
+    return true;
+}
+
+static void atualizar_maximo(atomic<uint64_t> &maximo, uint64_t valor)
+{
+    uint64_t atual = maximo.load(memory_order_relaxed);
+    while (valor > atual && !maximo.compare_exchange_weak(atual, valor, memory_order_relaxed))
+        ;
+}
+
+// Cabeçalho antes de cada bloco; 16 bytes mantém o alinhamento do malloc
+struct alignas(16) CabecalhoBloco
+{
+    size_t tamanho;
+    AllocPhase fase;
+};
+
+static void *alocar(size_t tamanho)
+{
+    void *bloco = malloc(sizeof(CabecalhoBloco) + tamanho);
+    if (bloco == nullptr)
+        return nullptr;
+    CabecalhoBloco *h = static_cast<CabecalhoBloco *>(bloco);
+    h->tamanho = tamanho;
+    h->fase = fase_atual;
+
+    ContadoresFase &c = contadores[h->fase];
+    c.alocacoes.fetch_add(1, memory_order_relaxed);
+    c.bytes.fetch_add(tamanho, memory_order_relaxed);
+    atualizar_maximo(c.pico_vivo, bytes_vivos.fetch_add(tamanho, memory_order_relaxed) + tamanho);
+    return h + 1;
+}
+
+static void liberar(void *p)
+{
+    if (p == nullptr)
+        return;
+    CabecalhoBloco *h = static_cast<CabecalhoBloco *>(p) - 1;
+    contadores[h->fase].liberacoes.fetch_add(1, memory_order_relaxed);
+    bytes_vivos.fetch_sub(h->tamanho, memory_order_relaxed);
+    free(h);
+}
+
+void *operator new(size_t tamanho)
+{
+    void *p = alocar(tamanho);
+    if (p == nullptr)
+        throw bad_alloc();
+    return p;
+}
+
+void *operator new[](size_t tamanho)
+{
+    return operator new(tamanho);
+}
+
+void *operator new(size_t tamanho, const nothrow_t &) noexcept
+{
+    return alocar(tamanho);
+}
+
+void *operator new[](size_t tamanho, const nothrow_t &) noexcept
+{
+    return alocar(tamanho);
+}
+
+void operator delete(void *p) noexcept
+{
+    liberar(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    liberar(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    liberar(p);
+}
+
+void operator delete[](void *p, size_t) noexcept
+{
+    liberar(p);
+}
+
+void operator delete(void *p, const nothrow_t &) noexcept
+{
+    liberar(p);
+}
+
+void operator delete[](void *p, const nothrow_t &) noexcept
+{
+    liberar(p);
+}
+
+#else
+
+bool alloc_profiler_enabled()
+{
+    return false;
+}
+
+#endif
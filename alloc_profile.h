@@ -0,0 +1,102 @@
+/*
+ * Trabalho de Compiladores - Perfil de Alocação
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo define o perfil de alocação por fase (léxico, sintático e
+ * relatório). Compilado com -DUSE_ALLOC_PROFILER, o alloc_profile.cpp
+ * substitui os operator new/delete globais: cada bloco ganha um cabeçalho com
+ * o tamanho e a fase em que foi alocado, e os contadores (alocações,
+ * liberações, bytes e pico de bytes vivos) são atribuídos à fase corrente da
+ * thread. Sem a flag os operadores padrão continuam valendo e só o pico de RSS
+ * é medido.
+ *
+ * O pico de RSS por fase vem do VmHWM do /proc/self/status, zerado no início
+ * de cada fase escrevendo "5" em /proc/self/clear_refs.
+ *
+ * Data: Outubro de 2026
+ */
+
+#ifndef ALLOC_PROFILE_H
+#define ALLOC_PROFILE_H
+
+#include "automata.h"
+#include "lexer.h"
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+using namespace std;
+
+enum AllocPhase
+{
+    FASE_OUTROS,
+    FASE_LEXICO,
+    FASE_SINTATICO,
+    FASE_RELATORIO,
+    NUM_FASES
+};
+
+struct AllocStats
+{
+    uint64_t alocacoes = 0;
+    uint64_t liberacoes = 0; // de blocos alocados nesta fase
+    uint64_t bytes = 0;
+    uint64_t pico_vivo = 0;  // maior total de bytes vivos (de todas as fases) durante a fase
+    long pico_rss_kb = 0;
+};
+
+// true se os operadores de alocação foram substituídos (-DUSE_ALLOC_PROFILER)
+bool alloc_profiler_enabled();
+
+// Troca a fase da thread atual e retorna a anterior. É barato (sem syscalls),
+// então pode ser usado por token; o RSS só é medido pelo AllocScope.
+AllocPhase set_alloc_phase(AllocPhase fase);
+
+AllocStats alloc_stats(AllocPhase fase);
+
+// Relatório das fases, com alocações por token (léxico) e por passo do parser
+// (sintático)
+void alloc_report(ostream &out, size_t tokens, size_t passos);
+
+// Fase de granularidade grossa: além de trocar a fase, zera o pico de RSS na
+// entrada e guarda o pico medido na saída. Com ativo = false não faz nada.
+class AllocScope
+{
+public:
+    AllocScope(AllocPhase fase, bool ativo = true);
+    ~AllocScope();
+    // Fecha a fase antes do fim do escopo (ex.: antes de imprimir o relatório)
+    void encerrar();
+
+private:
+    AllocPhase fase;
+    AllocPhase anterior = FASE_OUTROS;
+    bool ativo;
+};
+
+// Atribui ao léxico o que o lexer aloca quando ele é puxado pelo parser
+// (modo em fluxo, onde as duas fases se intercalam token a token)
+class PhaseLexer : public LexerBackend
+{
+public:
+    PhaseLexer(LexerBackend &lexer) : lexer(lexer) {}
+    Token *scan() override
+    {
+        AllocPhase anterior = set_alloc_phase(FASE_LEXICO);
+        Token *tok = lexer.scan();
+        set_alloc_phase(anterior);
+        tokens += tok != nullptr;
+        return tok;
+    }
+    size_t tokens = 0;
+
+private:
+    LexerBackend &lexer;
+};
+
+#endif // ALLOC_PROFILE_H
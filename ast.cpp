@@ -0,0 +1,310 @@
+/*
+ * Trabalho de Compiladores - Árvore Sintática Abstrata
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo implementa a conversão da árvore de derivação do parser LL(1)
+ * para a AST definida em ast.h.
+ *
+ * Data: Outubro de 2026
+ */
+
+#include "ast.h"
+
+static Stmt *build_stmt(const ParseNode *node);
+static Expr *build_numexpr(const ParseNode *node);
+
+static Ident build_ident(const ParseNode *node)
+{
+    return Ident{node->token->lexeme, node->token};
+}
+
+// Tag do operador de um token de operador (Relop/Arithop guardam o operador à parte)
+static Tag operador(const ParseNode *node)
+{
+    return std::get<Tag>(node->simbolo);
+}
+
+// PARLIST ::= int id PARLIST_ | ε
+// PARLIST_ ::= comma int id PARLIST_ | ε
+static void build_params(const ParseNode *node, vector<Ident> &params)
+{
+    while (node->producao == PROD_PARLIST_INT || node->producao == PROD_PARLIST__COMMA)
+    {
+        int base = node->producao == PROD_PARLIST_INT ? 0 : 1;
+        params.push_back(build_ident(node->filhos[base + 1]));
+        node = node->filhos[base + 2];
+    }
+}
+
+// VARLIST ::= id VARLIST_
+// VARLIST_ ::= comma id VARLIST_ | ε
+static void build_varlist(const ParseNode *node, vector<Ident> &nomes)
+{
+    nomes.push_back(build_ident(node->filhos[0]));
+    node = node->filhos[1];
+    while (node->producao == PROD_VARLIST__COMMA)
+    {
+        nomes.push_back(build_ident(node->filhos[1]));
+        node = node->filhos[2];
+    }
+}
+
+// FCALL ::= idfun lparen PARLISTCALL rparen
+static Chamada *build_chamada(const ParseNode *node)
+{
+    Chamada *chamada = new Chamada();
+    chamada->funcao = build_ident(node->filhos[0]);
+
+    const ParseNode *lista = node->filhos[2];
+    if (lista->producao == PROD_PARLISTCALL_ID)
+    {
+        chamada->args.push_back(build_ident(lista->filhos[0]));
+        lista = lista->filhos[1];
+        while (lista->producao == PROD_PARLISTCALL__COMMA)
+        {
+            chamada->args.push_back(build_ident(lista->filhos[1]));
+            lista = lista->filhos[2];
+        }
+    }
+    return chamada;
+}
+
+// FACTOR ::= lparen NUMEXPR rparen | id | num
+static Expr *build_factor(const ParseNode *node)
+{
+    switch (node->producao)
+    {
+    case PROD_FACTOR_NUMEXPR:
+        return build_numexpr(node->filhos[1]);
+    case PROD_FACTOR_ID:
+    {
+        Expr *e = new Expr(EXPR_VAR);
+        e->var = build_ident(node->filhos[0]);
+        e->token = node->filhos[0]->token;
+        return e;
+    }
+    default:
+    {
+        Expr *e = new Expr(EXPR_NUM);
+        e->token = node->filhos[0]->token;
+        e->valor = static_cast<Num *>(e->token)->value;
+        return e;
+    }
+    }
+}
+
+static Expr *build_bin(Tag op, Expr *esq, Expr *dir, Token *token)
+{
+    Expr *e = new Expr(EXPR_BIN);
+    e->op = op;
+    e->esq = esq;
+    e->dir = dir;
+    e->token = token;
+    return e;
+}
+
+// TERM ::= FACTOR TERM_
+// TERM_ ::= times FACTOR TERM_ | divide FACTOR TERM_ | ε
+static Expr *build_term(const ParseNode *node)
+{
+    Expr *acc = build_factor(node->filhos[0]);
+    const ParseNode *resto = node->filhos[1];
+    while (resto->producao != PROD_TERM__EPSILON)
+    {
+        acc = build_bin(operador(resto->filhos[0]), acc, build_factor(resto->filhos[1]), resto->filhos[0]->token);
+        resto = resto->filhos[2];
+    }
+    return acc;
+}
+
+// NUMEXPR ::= TERM NUMEXPR_
+// NUMEXPR_ ::= plus TERM NUMEXPR_ | minus TERM NUMEXPR_ | ε
+static Expr *build_numexpr(const ParseNode *node)
+{
+    Expr *acc = build_term(node->filhos[0]);
+    const ParseNode *resto = node->filhos[1];
+    while (resto->producao != PROD_NUMEXPR__EPSILON)
+    {
+        acc = build_bin(operador(resto->filhos[0]), acc, build_term(resto->filhos[1]), resto->filhos[0]->token);
+        resto = resto->filhos[2];
+    }
+    return acc;
+}
+
+// EXPR ::= NUMEXPR EXPR_
+// EXPR_ ::= relop NUMEXPR | ε
+static Expr *build_expr(const ParseNode *node)
+{
+    Expr *esq = build_numexpr(node->filhos[0]);
+    const ParseNode *resto = node->filhos[1];
+    if (resto->producao == PROD_EXPR__EPSILON)
+    {
+        return esq;
+    }
+    return build_bin(operador(resto->filhos[0]), esq, build_numexpr(resto->filhos[1]), resto->filhos[0]->token);
+}
+
+// STMTLIST ::= STMT STMTLIST | ε
+static void build_stmtlist(const ParseNode *node, vector<Stmt *> &corpo)
+{
+    while (node->producao == PROD_STMTLIST_STMT)
+    {
+        corpo.push_back(build_stmt(node->filhos[0]));
+        node = node->filhos[1];
+    }
+}
+
+static Stmt *build_stmt(const ParseNode *node)
+{
+    Stmt *s = nullptr;
+    switch (node->producao)
+    {
+    case PROD_STMT_INT:
+        s = new Stmt(STMT_DECL);
+        s->token = node->filhos[0]->token;
+        build_varlist(node->filhos[1], s->nomes);
+        break;
+    case PROD_STMT_ATRIBST:
+    {
+        // ATRIBST ::= id assign ATRIBST_
+        const ParseNode *atrib = node->filhos[0];
+        const ParseNode *valor = atrib->filhos[2];
+        s = new Stmt(STMT_ATRIB);
+        s->alvo = build_ident(atrib->filhos[0]);
+        s->token = s->alvo.token;
+        if (valor->producao == PROD_ATRIBST__FCALL)
+            s->chamada = build_chamada(valor->filhos[0]);
+        else
+            s->expr = build_expr(valor->filhos[0]);
+        break;
+    }
+    case PROD_STMT_BLOCK:
+        s = new Stmt(STMT_BLOCO);
+        s->token = node->filhos[0]->token;
+        build_stmtlist(node->filhos[1], s->corpo);
+        break;
+    case PROD_STMT_PRINT:
+        // PRINTST ::= print EXPR
+        s = new Stmt(STMT_PRINT);
+        s->token = node->filhos[0]->filhos[0]->token;
+        s->expr = build_expr(node->filhos[0]->filhos[1]);
+        break;
+    case PROD_STMT_RETURN:
+    {
+        // RETURNST ::= return RETURNST_
+        const ParseNode *ret = node->filhos[0];
+        s = new Stmt(STMT_RETURN);
+        s->token = ret->filhos[0]->token;
+        if (ret->filhos[1]->producao == PROD_RETURNST__ID)
+            s->alvo = build_ident(ret->filhos[1]->filhos[0]);
+        break;
+    }
+    case PROD_STMT_IF:
+    {
+        // IFSTMT ::= if lparen EXPR rparen lbrace STMT rbrace IFSTMT_
+        const ParseNode *ifst = node->filhos[0];
+        s = new Stmt(STMT_IF);
+        s->token = ifst->filhos[0]->token;
+        s->expr = build_expr(ifst->filhos[2]);
+        s->entao = build_stmt(ifst->filhos[5]);
+        if (ifst->filhos[7]->producao == PROD_IFSTMT__ELSE)
+            s->senao = build_stmt(ifst->filhos[7]->filhos[2]);
+        break;
+    }
+    case PROD_STMT_FCALL:
+        s = new Stmt(STMT_CHAMADA);
+        s->chamada = build_chamada(node->filhos[0]);
+        s->token = s->chamada->funcao.token;
+        break;
+    default: // PROD_STMT_SEMICOLON
+        s = new Stmt(STMT_VAZIO);
+        s->token = node->filhos[0]->token;
+        break;
+    }
+    return s;
+}
+
+// FDEF ::= def IDFUN lparen PARLIST rparen lbrace STMTLIST rbrace
+static Funcao *build_funcao(const ParseNode *node)
+{
+    Funcao *f = new Funcao();
+    f->nome = build_ident(node->filhos[1]);
+    build_params(node->filhos[3], f->params);
+    build_stmtlist(node->filhos[6], f->corpo);
+    return f;
+}
+
+Programa *build_ast(const ParseNode *raiz)
+{
+    Programa *programa = new Programa();
+
+    // S ::= MAIN $
+    const ParseNode *main = raiz->filhos[0];
+    switch (main->producao)
+    {
+    case PROD_MAIN_FLIST:
+    {
+        // FLIST ::= FDEF FLIST_
+        // FLIST_ ::= FDEF FLIST_ | ε
+        const ParseNode *lista = main->filhos[0];
+        programa->funcoes.push_back(build_funcao(lista->filhos[0]));
+        lista = lista->filhos[1];
+        while (lista->producao == PROD_FLIST__FDEF)
+        {
+            programa->funcoes.push_back(build_funcao(lista->filhos[0]));
+            lista = lista->filhos[1];
+        }
+        break;
+    }
+    case PROD_MAIN_STMT:
+    {
+        Funcao *f = new Funcao();
+        f->corpo.push_back(build_stmt(main->filhos[0]));
+        programa->funcoes.push_back(f);
+        break;
+    }
+    default: // MAIN ::= ε
+        break;
+    }
+    return programa;
+}
+
+static void free_expr(Expr *e)
+{
+    if (e == nullptr)
+        return;
+    free_expr(e->esq);
+    free_expr(e->dir);
+    delete e;
+}
+
+static void free_stmt(Stmt *s)
+{
+    if (s == nullptr)
+        return;
+    free_expr(s->expr);
+    delete s->chamada;
+    free_stmt(s->entao);
+    free_stmt(s->senao);
+    for (Stmt *filho : s->corpo)
+        free_stmt(filho);
+    delete s;
+}
+
+void free_ast(Programa *programa)
+{
+    if (programa == nullptr)
+        return;
+    for (Funcao *f : programa->funcoes)
+    {
+        for (Stmt *s : f->corpo)
+            free_stmt(s);
+        delete f;
+    }
+    delete programa;
+}
@@ -0,0 +1,105 @@
+/*
+ * Trabalho de Compiladores - Árvore Sintática Abstrata
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo define a AST da linguagem e a conversão da árvore de derivação
+ * do parser LL(1) para ela. A gramática é fatorada à esquerda (EXPR_, NUMEXPR_,
+ * TERM_, ...), então a conversão remonta as expressões com associatividade à
+ * esquerda e descarta os não-terminais auxiliares.
+ *
+ * Data: Outubro de 2026
+ */
+
+#ifndef AST_H
+#define AST_H
+
+#include "parser.h"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Identificador junto do token de onde veio (para mensagens de erro)
+struct Ident
+{
+    string nome;
+    Token *token = nullptr;
+};
+
+enum ExprTipo
+{
+    EXPR_NUM,
+    EXPR_VAR,
+    EXPR_BIN
+};
+
+struct Expr
+{
+    ExprTipo tipo;
+    int valor = 0;        // EXPR_NUM
+    Ident var;            // EXPR_VAR
+    Tag op = UNK;         // EXPR_BIN: PLUS, MINUS, TIMES, DIVIDE, LT, LE, GT, GE, EQ, NE
+    Expr *esq = nullptr;  // EXPR_BIN
+    Expr *dir = nullptr;  // EXPR_BIN
+    Token *token = nullptr;
+
+    Expr(ExprTipo tipo) : tipo(tipo) {}
+};
+
+struct Chamada
+{
+    Ident funcao;
+    vector<Ident> args;
+};
+
+enum StmtTipo
+{
+    STMT_DECL,     // int VARLIST;
+    STMT_ATRIB,    // id = EXPR; ou id = FCALL;
+    STMT_CHAMADA,  // FCALL;
+    STMT_PRINT,    // print EXPR;
+    STMT_RETURN,   // return; ou return id;
+    STMT_IF,       // if (EXPR) { STMT } [else { STMT }]
+    STMT_BLOCO,    // { STMTLIST }
+    STMT_VAZIO     // ;
+};
+
+struct Stmt
+{
+    StmtTipo tipo;
+    vector<Ident> nomes;        // STMT_DECL
+    Ident alvo;                 // STMT_ATRIB; STMT_RETURN (nome vazio = sem valor)
+    Expr *expr = nullptr;       // STMT_ATRIB sem chamada, STMT_PRINT, condição do STMT_IF
+    Chamada *chamada = nullptr; // STMT_ATRIB com chamada, STMT_CHAMADA
+    Stmt *entao = nullptr;      // STMT_IF
+    Stmt *senao = nullptr;      // STMT_IF (opcional)
+    vector<Stmt *> corpo;       // STMT_BLOCO
+    Token *token = nullptr;
+
+    Stmt(StmtTipo tipo) : tipo(tipo) {}
+};
+
+struct Funcao
+{
+    Ident nome; // vazio quando o programa é um STMT solto (MAIN ::= STMT)
+    vector<Ident> params;
+    vector<Stmt *> corpo;
+};
+
+struct Programa
+{
+    vector<Funcao *> funcoes;
+};
+
+// Converte a árvore de derivação (raiz NT_S) produzida por parse_tokens
+Programa *build_ast(const ParseNode *raiz);
+
+// Libera a AST (os tokens apontados pelos nós continuam com o lexer)
+void free_ast(Programa *programa);
+
+#endif // AST_H
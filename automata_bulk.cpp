@@ -0,0 +1,276 @@
+/*
+ * Trabalho de Compiladores - Classificação em Lote
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo implementa a compilação da tabela densa, o laço escalar, o
+ * de 16 pistas com AVX2, a divisão entre threads e o
+ * --bench-automata, que compara com o run_automata.
+ *
+ * Data: Outubro de 2026
+ */
+
+#include "automata_bulk.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <random>
+#if defined(USE_AVX2_GATHER) && defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// Abaixo disso, dividir entre threads custa mais do que rodar direto
+static const size_t LOTE_MINIMO_THREADS = 1 << 15;
+
+BulkAutomata::BulkAutomata(const Automata &automata)
+{
+    int num_estados = automata.transition_table.size();
+    morto = num_estados;
+    transicoes.assign((num_estados + 1) * 256, morto * 256);
+    final.assign(num_estados + 1, 0);
+    for (int e = 0; e < num_estados; e++)
+    {
+        for (const auto &simbolo : automata.input_symbol_index)
+        {
+            int proximo = automata.transition_table[e][simbolo.second];
+            if (proximo != -1)
+                transicoes[e * 256 + static_cast<unsigned char>(simbolo.first)] = proximo * 256;
+        }
+        final[e] = automata.final_states.count(e) > 0;
+    }
+}
+
+bool BulkAutomata::accepts(string_view cadeia) const
+{
+    const int32_t *tabela = transicoes.data();
+    int32_t estado = 0;
+    for (unsigned char c : cadeia)
+        estado = tabela[estado + c];
+    return final[estado >> 8];
+}
+
+#if defined(USE_AVX2_GATHER) && defined(__AVX2__)
+static const size_t PISTAS = 16; // dois vetores de 8, para esconder a latência dos gathers
+
+// Cada pista percorre uma faixa contínua de cadeias, byte a byte; ao chegar
+// ao fim de uma cadeia, grava o resultado e recomeça do estado inicial na
+// seguinte. Os bytes são lidos com o gather de 32 bits terminando na posição
+// (base - 3), então o chamador garante 3 bytes legíveis antes de
+// dados + offsets[inicio]. Uma pista que terminou fica parada lendo a
+// posição 0, que é válida, até as outras acabarem.
+void BulkAutomata::run_lanes(const char *dados, const uint64_t *offsets, size_t inicio, size_t fim,
+                             uint8_t *resultados) const
+{
+    const char *base = dados + offsets[inicio];
+    const uint8_t *aceita = final.data();
+    size_t faixa = (fim - inicio + PISTAS - 1) / PISTAS;
+    size_t atual[PISTAS], limite[PISTAS];
+    alignas(32) int32_t pos[PISTAS], fim_cadeia[PISTAS], estado[PISTAS];
+    size_t vivas = 0;
+
+    // Fecha as cadeias que a pista l terminou (inclusive vazias) e carrega a próxima
+    auto avancar = [&](size_t l)
+    {
+        while (atual[l] < limite[l] && offsets[atual[l] + 1] - offsets[inicio] == (uint64_t)pos[l])
+        {
+            resultados[atual[l]++] = aceita[estado[l] >> 8];
+            estado[l] = 0;
+        }
+        if (atual[l] < limite[l])
+        {
+            fim_cadeia[l] = offsets[atual[l] + 1] - offsets[inicio];
+            return true;
+        }
+        pos[l] = 0;
+        fim_cadeia[l] = -1;
+        return false;
+    };
+    for (size_t l = 0; l < PISTAS; l++)
+    {
+        atual[l] = min(fim, inicio + l * faixa);
+        limite[l] = min(fim, inicio + (l + 1) * faixa);
+        pos[l] = offsets[atual[l]] - offsets[inicio];
+        estado[l] = 0;
+        vivas += avancar(l);
+    }
+
+    const int *tabela = transicoes.data();
+    const int *bytes_base = reinterpret_cast<const int *>(base - 3);
+    const __m256i um = _mm256_set1_epi32(1);
+    __m256i p[2], e[2], f[2];
+    auto carregar = [&](int v)
+    {
+        p[v] = _mm256_load_si256(reinterpret_cast<const __m256i *>(pos + 8 * v));
+        e[v] = _mm256_load_si256(reinterpret_cast<const __m256i *>(estado + 8 * v));
+        f[v] = _mm256_load_si256(reinterpret_cast<const __m256i *>(fim_cadeia + 8 * v));
+    };
+    carregar(0);
+    carregar(1);
+    while (vivas > 0)
+    {
+        for (int v = 0; v < 2; v++)
+        {
+            __m256i bytes = _mm256_srli_epi32(_mm256_i32gather_epi32(bytes_base, p[v], 1), 24);
+            e[v] = _mm256_i32gather_epi32(tabela, _mm256_add_epi32(e[v], bytes), 4);
+            p[v] = _mm256_add_epi32(p[v], um);
+            int terminou = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(p[v], f[v])));
+            if (terminou == 0)
+                continue;
+            _mm256_store_si256(reinterpret_cast<__m256i *>(pos + 8 * v), p[v]);
+            _mm256_store_si256(reinterpret_cast<__m256i *>(estado + 8 * v), e[v]);
+            for (; terminou != 0; terminou &= terminou - 1)
+                if (!avancar(8 * v + __builtin_ctz(terminou)))
+                    vivas--;
+            carregar(v);
+        }
+    }
+}
+#endif
+
+void BulkAutomata::run_range(const char *dados, const uint64_t *offsets, size_t inicio, size_t fim,
+                             uint8_t *resultados) const
+{
+    const int32_t *tabela = transicoes.data();
+    const uint8_t *aceita = final.data();
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(dados);
+    auto escalar = [&](size_t de, size_t ate)
+    {
+        for (size_t i = de; i < ate; i++)
+        {
+            int32_t estado = 0;
+            for (uint64_t p = offsets[i]; p < offsets[i + 1]; p++)
+                estado = tabela[estado + bytes[p]];
+            resultados[i] = aceita[estado >> 8];
+        }
+    };
+
+#if defined(USE_AVX2_GATHER) && defined(__AVX2__)
+    // O gather precisa de 3 bytes antes da primeira cadeia, e as posições
+    // dentro de um bloco cabem em int32
+    const size_t BLOCO = 1 << 16;
+    size_t i = inicio;
+    while (i < fim && offsets[i] < offsets[0] + 3)
+        i++;
+    escalar(inicio, i);
+    while (i < fim)
+    {
+        size_t ate = min(fim, i + BLOCO);
+        if (ate - i >= PISTAS * 4 && offsets[ate] - offsets[i] < INT32_MAX)
+            run_lanes(dados, offsets, i, ate, resultados);
+        else
+            escalar(i, ate);
+        i = ate;
+    }
+#else
+    escalar(inicio, fim);
+#endif
+}
+
+void BulkAutomata::run(const char *dados, const uint64_t *offsets, size_t n, uint8_t *resultados, ThreadPool *pool) const
+{
+    if (pool == nullptr || pool->size() == 1 || n < LOTE_MINIMO_THREADS)
+    {
+        run_range(dados, offsets, 0, n, resultados);
+        return;
+    }
+
+    // Alguns pedaços por thread, para equilibrar cadeias de tamanhos diferentes
+    size_t pedaco = max(LOTE_MINIMO_THREADS / 4, n / (pool->size() * 4));
+    size_t pedacos = (n + pedaco - 1) / pedaco;
+    pool->parallel_for(pedacos, [&](size_t k)
+                       { run_range(dados, offsets, k * pedaco, min(n, (k + 1) * pedaco), resultados); });
+}
+
+// ==========================
+// --bench-automata
+// ==========================
+
+// Cadeias de uma "coluna": metade válida para o autômato, metade com um
+// caractere trocado por algo fora do alfabeto ou fora de lugar
+static void gerar_coluna(Tag tag, size_t n, mt19937_64 &rng, string &dados, vector<uint64_t> &offsets,
+                         vector<string> &cadeias)
+{
+    const string minusculas = "abcdefghijklmnopqrstuvwxyz", maiusculas = "ABCDEFGHIJKLMNOPQRSTUVWXYZ",
+                 digitos = "0123456789", outros = "_-+$ .;";
+    const string alnum = minusculas + maiusculas + digitos;
+    auto sorteio = [&](const string &s) { return s[rng() % s.size()]; };
+
+    dados.clear();
+    offsets.assign(1, 0);
+    cadeias.clear();
+    for (size_t i = 0; i < n; i++)
+    {
+        size_t tamanho = 1 + rng() % 12;
+        string s;
+        if (tag == NUM)
+        {
+            for (size_t k = 0; k < tamanho; k++)
+                s += sorteio(digitos);
+        }
+        else
+        {
+            s += sorteio(tag == IDFUN ? maiusculas : minusculas + maiusculas);
+            for (size_t k = 1; k < tamanho; k++)
+                s += sorteio(alnum);
+        }
+        if (rng() % 2)
+            s[rng() % s.size()] = rng() % 2 ? sorteio(outros) : sorteio(tag == NUM ? minusculas : digitos);
+        dados += s;
+        offsets.push_back(dados.size());
+        cadeias.push_back(s);
+    }
+}
+
+int bench_automata(size_t n, size_t threads)
+{
+    ThreadPool pool(threads);
+    mt19937_64 rng(1);
+    const pair<Tag, const char *> colunas[] = {{ID, "ID"}, {IDFUN, "IDFUN"}, {NUM, "NUM"}};
+
+#if defined(USE_AVX2_GATHER) && defined(__AVX2__)
+    const char *laco = "16 pistas AVX2";
+#else
+    const char *laco = "escalar";
+#endif
+    cout << n << " cadeias por coluna (1 a 12 bytes), laço " << laco << ", " << pool.size() << " threads"
+         << endl;
+    cout << left << setw(8) << "coluna" << right << setw(16) << "run_automata" << setw(16) << "lote" << setw(16)
+         << "lote+threads" << "   (milhões de cadeias/s)" << endl;
+
+    bool iguais = true;
+    string dados;
+    vector<uint64_t> offsets;
+    vector<string> cadeias;
+    for (const auto &coluna : colunas)
+    {
+        const Automata &automata = automatas.at(coluna.first);
+        gerar_coluna(coluna.first, n, rng, dados, offsets, cadeias);
+        BulkAutomata lote(automata);
+
+        auto inicio = chrono::steady_clock::now();
+        vector<uint8_t> esperado(n);
+        for (size_t i = 0; i < n; i++)
+            esperado[i] = run_automata(cadeias[i], automata);
+        double s_um = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+
+        vector<uint8_t> resultado(n), resultado_threads(n);
+        inicio = chrono::steady_clock::now();
+        lote.run(dados.data(), offsets.data(), n, resultado.data());
+        double s_lote = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+
+        inicio = chrono::steady_clock::now();
+        lote.run(dados.data(), offsets.data(), n, resultado_threads.data(), &pool);
+        double s_threads = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+
+        bool ok = resultado == esperado && resultado_threads == esperado;
+        iguais &= ok;
+        cout << left << setw(8) << coluna.second << right << fixed << setprecision(1) << setw(16) << n / s_um / 1e6
+             << setw(16) << n / s_lote / 1e6 << setw(16) << n / s_threads / 1e6 << (ok ? "" : "   [FAIL]") << endl;
+    }
+    cout << (iguais ? "Mesmo resultado do run_automata em todas as cadeias." : "Resultados diferentes!") << endl;
+    return iguais ? 0 : 1;
+}
@@ -0,0 +1,64 @@
+/*
+ * Trabalho de Compiladores - Classificação em Lote
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo define a versão em lote do run_automata: um autômato da
+ * Parte A é compilado para uma tabela densa (256 colunas por estado, com um
+ * estado morto que absorve os símbolos fora do alfabeto) e roda sobre muitas
+ * cadeias guardadas juntas em um buffer, com offsets. Cada passo é uma única
+ * leitura na tabela, sem desvios nem busca no unordered_map do alfabeto.
+ * Com -DUSE_AVX2_GATHER (e -mavx2), 16 pistas percorrem faixas diferentes
+ * do lote ao mesmo tempo, com os estados intercalados em registradores e um
+ * gather por passo para os bytes e outro para as transições. Lotes grandes
+ * são divididos entre as threads de um ThreadPool. O resultado é um byte por
+ * cadeia, igual ao run_automata.
+ *
+ * Data: Outubro de 2026
+ */
+
+#ifndef AUTOMATA_BULK_H
+#define AUTOMATA_BULK_H
+
+#include "automata.h"
+#include "thread_pool.h"
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+class BulkAutomata
+{
+public:
+    explicit BulkAutomata(const Automata &automata);
+
+    // A cadeia i é dados[offsets[i], offsets[i + 1]) (offsets tem n + 1
+    // posições); resultados[i] = 1 se ela é aceita, senão 0. Com pool, lotes
+    // grandes são divididos entre as threads.
+    void run(const char *dados, const uint64_t *offsets, size_t n, uint8_t *resultados, ThreadPool *pool = nullptr) const;
+
+    bool accepts(string_view cadeia) const;
+
+    int num_states() const { return morto + 1; }
+
+private:
+    vector<int32_t> transicoes; // transicoes[estado * 256 + byte], já multiplicado por 256
+    vector<uint8_t> final;      // por estado
+    int32_t morto;              // estado sem saída e não final
+
+    void run_range(const char *dados, const uint64_t *offsets, size_t inicio, size_t fim, uint8_t *resultados) const;
+#if defined(USE_AVX2_GATHER) && defined(__AVX2__)
+    void run_lanes(const char *dados, const uint64_t *offsets, size_t inicio, size_t fim, uint8_t *resultados) const;
+#endif
+};
+
+// --bench-automata: n cadeias por coluna (ID, IDFUN, NUM), comparando
+// run_automata, o lote e o lote com threads; 0 se todos concordam
+int bench_automata(size_t n, size_t threads);
+
+#endif // AUTOMATA_BULK_H
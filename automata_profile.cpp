@@ -0,0 +1,399 @@
+/*
+ * Trabalho de Compiladores - Perfil dos Autômatos
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo implementa o dimensionamento dos contadores e a saída do
+ * perfil em texto, JSON e Graphviz.
+ *
+ * Data: Outubro de 2026
+ */
+
+#include "automata_profile.h"
+#include <cmath>
+#include <cstdio>
+#include <iomanip>
+#include <map>
+#include <string>
+
+AutomataProfile::AutomataProfile()
+{
+    for (const auto &[tag, a] : automatas)
+    {
+        AutomataCounters &c = automatos[tag];
+        size_t estados = a.transition_table.size();
+        c.num_simbolos = estados ? a.transition_table[0].size() : 0;
+        c.transicoes.assign(estados * c.num_simbolos, 0);
+        c.becos.assign(estados, 0);
+        c.fins.assign(estados, 0);
+    }
+}
+
+// Mesma simulação do run_automata (automata.cpp), contando cada passo. Fica
+// fora do automata.cpp para não tirar de lá a expansão inline do find, que
+// deixa o run_automata comum mais lento
+bool run_automata(const string &input, const Automata &automata, AutomataCounters &c)
+{
+    c.execucoes++;
+    int estado = 0;
+
+    for (char simbolo : input)
+    {
+        auto it = automata.input_symbol_index.find(simbolo);
+        if (it == automata.input_symbol_index.end())
+        {
+            c.rejeicoes_simbolo++;
+            c.becos[estado]++;
+            return false;
+        }
+        int idx = it->second;
+        int proximo = automata.transition_table[estado][idx];
+        if (proximo == -1)
+        {
+            c.rejeicoes_transicao++;
+            c.becos[estado]++;
+            return false;
+        }
+        c.transicoes[estado * c.num_simbolos + idx]++;
+        estado = proximo;
+    }
+
+    c.fins[estado]++;
+    bool aceita = automata.final_states.count(estado) > 0;
+    if (aceita)
+        c.aceitas++;
+    else
+        c.rejeicoes_final++;
+    return aceita;
+}
+
+// Autômatos na ordem das tags, para a saída não depender do unordered_map
+static vector<Tag> tags_automatos()
+{
+    vector<Tag> tags;
+    for (int t = 0; t <= EOF_TOKEN; t++)
+        if (automatas.count((Tag)t))
+            tags.push_back((Tag)t);
+    return tags;
+}
+
+// O nome "$" do EOF não serve de identificador no Graphviz
+static string nome_automato(Tag tag)
+{
+    return tag == EOF_TOKEN ? "EOF" : TAG_TO_STRING.at(tag);
+}
+
+// Símbolo de cada coluna da tabela
+static vector<char> simbolos(const Automata &a, size_t num_simbolos)
+{
+    vector<char> s(num_simbolos, '?');
+    for (const auto &[c, idx] : a.input_symbol_index)
+        s[idx] = c;
+    return s;
+}
+
+static uint64_t visitas(const AutomataCounters &c, size_t estado)
+{
+    uint64_t v = c.becos[estado] + c.fins[estado];
+    for (size_t s = 0; s < c.num_simbolos; s++)
+        v += c.transicoes[estado * c.num_simbolos + s];
+    return v;
+}
+
+static uint64_t total_transicoes(const AutomataCounters &c)
+{
+    uint64_t t = 0;
+    for (uint64_t n : c.transicoes)
+        t += n;
+    return t;
+}
+
+// Baldes até o último não vazio: "1: 10, 2: 3, 64+: 1"
+static void escrever_histograma(ostream &out, const vector<uint64_t> &h)
+{
+    size_t ultimo = h.size();
+    while (ultimo > 0 && h[ultimo - 1] == 0)
+        ultimo--;
+    bool primeiro = true;
+    for (size_t i = 0; i < ultimo; i++)
+    {
+        if (h[i] == 0)
+            continue;
+        out << (primeiro ? "" : ", ") << i << (i == h.size() - 1 ? "+" : "") << ": " << h[i];
+        primeiro = false;
+    }
+    if (primeiro)
+        out << "-";
+}
+
+static double media(const vector<uint64_t> &h)
+{
+    uint64_t n = 0, soma = 0;
+    for (size_t i = 0; i < h.size(); i++)
+    {
+        n += h[i];
+        soma += i * h[i];
+    }
+    return n ? (double)soma / n : 0.0;
+}
+
+void automata_profile_report(ostream &out, const AutomataProfile &perfil)
+{
+    vector<Tag> tags = tags_automatos();
+    sort(tags.begin(), tags.end(), [&](Tag a, Tag b)
+         {
+             uint64_t ta = total_transicoes(perfil.automatos[a]), tb = total_transicoes(perfil.automatos[b]);
+             return ta != tb ? ta > tb : perfil.automatos[a].execucoes > perfil.automatos[b].execucoes;
+         });
+
+    // setw conta bytes: completa pelo número de caracteres UTF-8
+    auto celula = [&](const string &texto, size_t largura, bool esquerda = false)
+    {
+        size_t caracteres = 0;
+        for (char c : texto)
+            caracteres += (c & 0xC0) != 0x80;
+        string espacos(largura > caracteres ? largura - caracteres : 0, ' ');
+        out << (esquerda ? texto + espacos : espacos + texto);
+    };
+
+    out << "\n=== Perfil dos autômatos ===\n";
+    celula("autômato", 10, true);
+    celula("execuções", 12);
+    celula("aceitas", 12);
+    celula("transições", 12);
+    celula("rej. símbolo", 14);
+    celula("rej. transição", 16);
+    celula("rej. final", 12);
+    celula("estados", 10);
+    celula("transições", 12);
+    out << '\n';
+    uint64_t execucoes = 0;
+    for (Tag tag : tags)
+    {
+        const AutomataCounters &c = perfil.automatos[tag];
+        const Automata &a = automatas.at(tag);
+        execucoes += c.execucoes;
+
+        // Cobertura: estados visitados e transições da tabela usadas
+        size_t estados = a.transition_table.size(), estados_visitados = 0, definidas = 0, usadas = 0;
+        for (size_t e = 0; e < estados; e++)
+        {
+            estados_visitados += visitas(c, e) > 0;
+            for (size_t s = 0; s < c.num_simbolos; s++)
+            {
+                definidas += a.transition_table[e][s] != -1;
+                usadas += c.transicoes[e * c.num_simbolos + s] > 0;
+            }
+        }
+        celula(nome_automato(tag), 10, true);
+        celula(to_string(c.execucoes), 12);
+        celula(to_string(c.aceitas), 12);
+        celula(to_string(total_transicoes(c)), 12);
+        celula(to_string(c.rejeicoes_simbolo), 14);
+        celula(to_string(c.rejeicoes_transicao), 16);
+        celula(to_string(c.rejeicoes_final), 12);
+        celula(to_string(estados_visitados) + "/" + to_string(estados), 10);
+        celula(to_string(usadas) + "/" + to_string(definidas), 12);
+        out << '\n';
+    }
+
+    out << fixed << setprecision(2);
+    out << "Tokens: " << perfil.tokens << " (desconhecidos: " << perfil.desconhecidos << "), run_automata por token: "
+        << (perfil.tokens ? (double)execucoes / perfil.tokens : 0.0) << '\n';
+    out << "Comprimento dos tokens (média " << media(perfil.comprimentos) << "): ";
+    escrever_histograma(out, perfil.comprimentos);
+    out << "\nRetrocesso em caracteres (média " << media(perfil.retrocessos) << "): ";
+    escrever_histograma(out, perfil.retrocessos);
+    out << '\n';
+}
+
+static string escapar_json(char c)
+{
+    if (c == '"' || c == '\\')
+        return string("\\") + c;
+    if ((unsigned char)c < 0x20)
+    {
+        char buf[8];
+        snprintf(buf, sizeof buf, "\\u%04x", c);
+        return buf;
+    }
+    return string(1, c);
+}
+
+static void escrever_lista(ostream &out, const vector<uint64_t> &h)
+{
+    size_t ultimo = h.size();
+    while (ultimo > 0 && h[ultimo - 1] == 0)
+        ultimo--;
+    out << "[";
+    for (size_t i = 0; i < ultimo; i++)
+        out << (i ? ", " : "") << h[i];
+    out << "]";
+}
+
+void write_automata_profile_json(ostream &out, const AutomataProfile &perfil)
+{
+    out << "{\n";
+    out << "  \"tokens\": " << perfil.tokens << ",\n";
+    out << "  \"desconhecidos\": " << perfil.desconhecidos << ",\n";
+    out << "  \"comprimentos\": ";
+    escrever_lista(out, perfil.comprimentos);
+    out << ",\n  \"retrocessos\": ";
+    escrever_lista(out, perfil.retrocessos);
+    out << ",\n  \"automatos\": [";
+
+    bool primeiro_automato = true;
+    for (Tag tag : tags_automatos())
+    {
+        const AutomataCounters &c = perfil.automatos[tag];
+        const Automata &a = automatas.at(tag);
+        vector<char> sim = simbolos(a, c.num_simbolos);
+
+        out << (primeiro_automato ? "" : ",") << "\n    {\"tag\": \"" << nome_automato(tag) << "\", \"execucoes\": "
+            << c.execucoes << ", \"aceitas\": " << c.aceitas << ", \"rejeicoes\": {\"simbolo\": " << c.rejeicoes_simbolo
+            << ", \"transicao\": " << c.rejeicoes_transicao << ", \"final\": " << c.rejeicoes_final
+            << "},\n     \"estados\": [";
+        primeiro_automato = false;
+
+        for (size_t e = 0; e < a.transition_table.size(); e++)
+        {
+            out << (e ? "," : "") << "\n       {\"estado\": " << e
+                << ", \"final\": " << (a.final_states.count(e) ? "true" : "false") << ", \"visitas\": " << visitas(c, e)
+                << ", \"becos\": " << c.becos[e] << ", \"fins\": " << c.fins[e] << ", \"transicoes\": [";
+            bool primeira = true;
+            for (size_t s = 0; s < c.num_simbolos; s++)
+            {
+                int destino = a.transition_table[e][s];
+                if (destino == -1)
+                    continue;
+                out << (primeira ? "" : ", ") << "{\"simbolo\": \"" << escapar_json(sim[s]) << "\", \"destino\": "
+                    << destino << ", \"contagem\": " << c.transicoes[e * c.num_simbolos + s] << "}";
+                primeira = false;
+            }
+            out << "]}";
+        }
+        out << "]}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+// Quente em vermelho, frio em azul (escala logarítmica); branco se nunca visitado
+static string cor(uint64_t n, uint64_t maximo)
+{
+    if (n == 0 || maximo == 0)
+        return "0.000 0.000 1.000";
+    double t = log1p((double)n) / log1p((double)maximo);
+    char buf[32];
+    snprintf(buf, sizeof buf, "%.3f %.3f 1.000", 0.66 * (1 - t), 0.25 + 0.6 * t);
+    return buf;
+}
+
+// Símbolos de uma aresta, com as sequências de 3 ou mais juntadas: "a-z0-9"
+static string rotulo_simbolos(vector<char> cs)
+{
+    sort(cs.begin(), cs.end());
+    string r;
+    for (size_t i = 0; i < cs.size();)
+    {
+        size_t j = i;
+        while (j + 1 < cs.size() && cs[j + 1] == cs[j] + 1)
+            j++;
+        auto escapar = [](char c) { return (c == '"' || c == '\\') ? string("\\") + c : string(1, c); };
+        if (j - i >= 2)
+            r += escapar(cs[i]) + "-" + escapar(cs[j]);
+        else
+            for (size_t k = i; k <= j; k++)
+                r += escapar(cs[k]);
+        i = j + 1;
+    }
+    return r;
+}
+
+// Uma aresta por par de estados: os símbolos e a soma das contagens
+typedef map<pair<size_t, int>, pair<vector<char>, uint64_t>> Arestas;
+
+static Arestas arestas(const Automata &a, const AutomataCounters &c)
+{
+    vector<char> sim = simbolos(a, c.num_simbolos);
+    Arestas r;
+    for (size_t e = 0; e < a.transition_table.size(); e++)
+    {
+        for (size_t s = 0; s < c.num_simbolos; s++)
+        {
+            int destino = a.transition_table[e][s];
+            if (destino == -1)
+                continue;
+            auto &aresta = r[{e, destino}];
+            aresta.first.push_back(sim[s]);
+            aresta.second += c.transicoes[e * c.num_simbolos + s];
+        }
+    }
+    return r;
+}
+
+void write_automata_profile_dot(ostream &out, const AutomataProfile &perfil)
+{
+    // Uma só escala para todos os autômatos, para comparar entre eles
+    uint64_t max_estado = 0, max_aresta = 0;
+    for (Tag tag : tags_automatos())
+    {
+        const AutomataCounters &c = perfil.automatos[tag];
+        for (size_t e = 0; e < c.becos.size(); e++)
+            max_estado = max(max_estado, visitas(c, e));
+        for (const auto &[par, aresta] : arestas(automatas.at(tag), c))
+            max_aresta = max(max_aresta, aresta.second);
+    }
+
+    out << "digraph automatos {\n";
+    out << "  rankdir=LR;\n";
+    out << "  node [shape=circle, style=filled, fontname=\"monospace\"];\n";
+    out << "  edge [fontname=\"monospace\", fontsize=10];\n";
+    for (Tag tag : tags_automatos())
+    {
+        const AutomataCounters &c = perfil.automatos[tag];
+        const Automata &a = automatas.at(tag);
+        string nome = nome_automato(tag);
+
+        out << "  subgraph cluster_" << nome << " {\n";
+        out << "    label=\"" << nome << ": " << c.execucoes << " execuções, " << c.aceitas << " aceitas, rejeições "
+            << c.rejeicoes_simbolo << " símbolo / " << c.rejeicoes_transicao << " transição / " << c.rejeicoes_final
+            << " final\";\n";
+        for (size_t e = 0; e < a.transition_table.size(); e++)
+        {
+            uint64_t v = visitas(c, e);
+            out << "    " << nome << "_" << e << " [label=\"" << e << "\\n" << v << "\", fillcolor=\"" << cor(v, max_estado)
+                << "\"" << (a.final_states.count(e) ? ", shape=doublecircle" : "") << "];\n";
+        }
+
+        for (const auto &[par, aresta] : arestas(a, c))
+        {
+            out << "    " << nome << "_" << par.first << " -> " << nome << "_" << par.second << " [label=\""
+                << rotulo_simbolos(aresta.first) << " (" << aresta.second << ")\"";
+            if (aresta.second == 0)
+                out << ", style=dashed, color=gray";
+            else
+                out << ", color=\"" << cor(aresta.second, max_aresta) << "\", penwidth="
+                    << 1 + 4 * log1p((double)aresta.second) / log1p((double)max_aresta);
+            out << "];\n";
+        }
+
+        // Becos sem saída de cada estado vão para um nó de rejeição
+        bool tem_becos = false;
+        for (size_t e = 0; e < c.becos.size(); e++)
+        {
+            if (c.becos[e] == 0)
+                continue;
+            if (!tem_becos)
+                out << "    " << nome << "_rejeita [label=\"rejeita\", shape=plaintext, style=\"\"];\n";
+            tem_becos = true;
+            out << "    " << nome << "_" << e << " -> " << nome << "_rejeita [label=\"" << c.becos[e]
+                << "\", style=dotted, color=red];\n";
+        }
+        out << "  }\n";
+    }
+    out << "}\n";
+}
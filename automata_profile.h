@@ -0,0 +1,84 @@
+/*
+ * Trabalho de Compiladores - Perfil dos Autômatos
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo define o perfil do lexer de autômatos: quais autômatos e
+ * estados fazem o trabalho e quais tokens causam retrocesso. Com um
+ * AutomataProfile ligado ao Lexer (set_profile), cada run_automata conta as
+ * transições por (autômato, estado, símbolo), os becos sem saída por estado
+ * (símbolo fora do alfabeto ou sem transição) e onde cada cadeia terminou
+ * (estado final ou não). O Lexer::scan acrescenta o histograma do
+ * comprimento dos tokens e da distância do retrocesso (caracteres lidos além
+ * do melhor token).
+ *
+ * O perfil pertence a um Lexer e só é escrito pela thread que o executa; sem
+ * perfil, o run_automata segue o caminho de sempre. Os contadores saem em
+ * texto, em JSON ou em Graphviz, com cada estado colorido pela quantidade de
+ * visitas e as transições nunca usadas tracejadas.
+ *
+ * Data: Outubro de 2026
+ */
+
+#ifndef AUTOMATA_PROFILE_H
+#define AUTOMATA_PROFILE_H
+
+#include "automata.h"
+#include <algorithm>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+using namespace std;
+
+// Contadores de um autômato
+struct AutomataCounters
+{
+    size_t num_simbolos = 0;
+    uint64_t execucoes = 0;
+    uint64_t aceitas = 0;
+    uint64_t rejeicoes_simbolo = 0;   // símbolo fora do alfabeto
+    uint64_t rejeicoes_transicao = 0; // sem transição (-1)
+    uint64_t rejeicoes_final = 0;     // a cadeia acabou em estado não final
+    vector<uint64_t> transicoes;      // [estado * num_simbolos + símbolo]
+    vector<uint64_t> becos;           // rejeições no meio da cadeia, por estado
+    vector<uint64_t> fins;            // cadeias que terminaram em cada estado
+};
+
+// Baldes dos histogramas: 0 a 63 exatos, o último conta 64 ou mais
+const size_t BALDES_HISTOGRAMA = 65;
+
+struct AutomataProfile
+{
+    AutomataCounters automatos[EOF_TOKEN + 1]; // pela tag de automatas
+    uint64_t tokens = 0;
+    uint64_t desconhecidos = 0; // lexemas que nenhum autômato aceitou
+    vector<uint64_t> comprimentos = vector<uint64_t>(BALDES_HISTOGRAMA);
+    vector<uint64_t> retrocessos = vector<uint64_t>(BALDES_HISTOGRAMA);
+
+    // Dimensiona os contadores de cada autômato de automatas
+    AutomataProfile();
+
+    void registrar_token(size_t comprimento, size_t retrocesso)
+    {
+        tokens++;
+        comprimentos[min(comprimento, BALDES_HISTOGRAMA - 1)]++;
+        retrocessos[min(retrocesso, BALDES_HISTOGRAMA - 1)]++;
+    }
+};
+
+// Mesmo resultado do run_automata, contando as transições e rejeições em c
+bool run_automata(const string &input, const Automata &automata, AutomataCounters &c);
+
+// Resumo por autômato (mais transições primeiro) e os dois histogramas
+void automata_profile_report(ostream &out, const AutomataProfile &perfil);
+
+// Mapa de calor dos estados e transições
+void write_automata_profile_json(ostream &out, const AutomataProfile &perfil);
+void write_automata_profile_dot(ostream &out, const AutomataProfile &perfil);
+
+#endif // AUTOMATA_PROFILE_H
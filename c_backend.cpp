@@ -0,0 +1,429 @@
+/*
+ * Trabalho de Compiladores - Geração de C
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo implementa a tradução da IR para C (o texto fixo do começo do
+ * programa gerado, uma função C por função da IR e o main) e a verificação
+ * que compila o C, executa o binário e compara com o avaliador.
+ *
+ * Data: Outubro de 2026
+ */
+
+#include "c_backend.h"
+#include "evaluator.h"
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <unordered_map>
+
+// Texto fixo do começo do programa: buffer de saída, erros e divisão
+static const char *const PRELUDIO = R"(#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static char saida[1 << 16];
+static size_t usados;
+static size_t profundidade = 1;
+
+static inline void descarregar(void)
+{
+    fwrite(saida, 1, usados, stdout);
+    usados = 0;
+}
+
+static inline void imprimir(int32_t v)
+{
+    char digitos[10];
+    int n = 0;
+    uint32_t u = v < 0 ? 0u - (uint32_t)v : (uint32_t)v;
+    if (usados + 12 > sizeof(saida))
+        descarregar();
+    if (v < 0)
+        saida[usados++] = '-';
+    do
+    {
+        digitos[n++] = '0' + u % 10;
+        u /= 10;
+    } while (u != 0);
+    while (n > 0)
+        saida[usados++] = digitos[--n];
+    saida[usados++] = '\n';
+}
+
+static void falhar(int posicao, const char *mensagem)
+{
+    descarregar();
+    if (posicao < 0)
+        printf("Erro de execução: %s.\n", mensagem);
+    else
+        printf("Erro de execução (%s): %s.\n", POSICAO[posicao], mensagem);
+    fflush(stdout);
+    exit(1);
+}
+
+static inline int32_t dividir(int32_t a, int32_t b, int posicao)
+{
+    if (b == 0)
+        falhar(posicao, "divisão por zero");
+    if (a == INT32_MIN && b == -1)
+        falhar(posicao, "estouro na divisão");
+    return a / b;
+}
+)";
+
+static const char *comparacao_c(Tag op)
+{
+    switch (op)
+    {
+    case LT:
+        return "<";
+    case LE:
+        return "<=";
+    case GT:
+        return ">";
+    case GE:
+        return ">=";
+    case EQ:
+        return "==";
+    default:
+        return "!=";
+    }
+}
+
+static string nome_funcao(const IRProgram &ir, int i)
+{
+    if (ir.funcoes[i].nome.empty())
+        return "g_programa";
+    return "f" + to_string(i) + "_" + ir.funcoes[i].nome;
+}
+
+static string operando_c(const Operando &op)
+{
+    if (op.tipo == Operando::VAR)
+        return "v" + to_string(op.valor);
+    if (op.tipo == Operando::CONST && op.valor == INT_MIN)
+        return "INT32_MIN";
+    return op.tipo == Operando::CONST ? to_string(op.valor) : "0";
+}
+
+static string assinatura(const IRProgram &ir, int i)
+{
+    const IRFunction &f = ir.funcoes[i];
+    string s = "static int32_t " + nome_funcao(ir, i) + "(";
+    for (int p = 0; p < f.num_params; p++)
+        s += (p ? ", int32_t v" : "int32_t v") + to_string(p);
+    return s + (f.num_params == 0 ? "void)" : ")");
+}
+
+class EmissorC
+{
+public:
+    EmissorC(const IRProgram &ir, const PositionResolver &linhas, size_t limite, ostream &out)
+        : ir(ir), linhas(linhas), limite(limite), out(out)
+    {
+        for (size_t i = 0; i < ir.funcoes.size(); i++)
+            indices[ir.funcoes[i].nome] = i;
+    }
+
+    void emitir(const string &origem)
+    {
+        // O corpo das funções vem antes, porque é ele que enche a tabela de posições
+        ostringstream corpo;
+        for (size_t i = 0; i < ir.funcoes.size(); i++)
+            emitir_funcao(i, corpo);
+
+        out << "/*\n"
+            << " * Programa C gerado por --emit-c a partir de " << origem << ".\n"
+            << " * Não editar: gere de novo após mudar o programa.\n"
+            << " */\n\n"
+            << "#define LIMITE_PROFUNDIDADE " << limite << "\n\n"
+            << "static const char *const POSICAO[] = {";
+        for (size_t p = 0; p < posicoes.size(); p++)
+            out << (p ? ", " : "") << "\"" << posicoes[p] << "\"";
+        out << (posicoes.empty() ? "\"\"" : "") << "};\n\n" << PRELUDIO << "\n";
+        for (size_t i = 0; i < ir.funcoes.size(); i++)
+            out << assinatura(ir, i) << ";\n";
+        out << "\n" << corpo.str();
+        emitir_main();
+    }
+
+private:
+    const IRProgram &ir;
+    const PositionResolver &linhas;
+    size_t limite;
+    ostream &out;
+    unordered_map<string, int> indices;
+    vector<string> posicoes;
+    unordered_map<const Token *, int> posicao_token;
+
+    // Índice em POSICAO da posição do comando; -1 se não há token
+    int posicao(const Instr &instr)
+    {
+        if (instr.token == nullptr)
+            return -1;
+        auto it = posicao_token.find(instr.token);
+        if (it != posicao_token.end())
+            return it->second;
+        posicoes.push_back(linhas.describe(instr.token->offset));
+        return posicao_token[instr.token] = posicoes.size() - 1;
+    }
+
+    void emitir_funcao(int i, ostream &c)
+    {
+        const IRFunction &f = ir.funcoes[i];
+        c << assinatura(ir, i) << "\n{\n";
+
+        // Nomes da IR em comentário; os parâmetros já são v0..v(n-1)
+        c << "    /*";
+        for (size_t v = 0; v < f.vars.size(); v++)
+            c << (v % 8 == 0 && v > 0 ? "\n     " : "") << " v" << v << " = " << f.vars[v]
+              << (v + 1 < f.vars.size() ? "," : "");
+        c << " */\n";
+        for (size_t v = f.num_params; v < f.vars.size(); v++)
+            c << "    int32_t v" << v << " = 0;\n";
+
+        // Só os blocos alcançáveis, e rótulo só nos que são alvo de desvio
+        vector<char> alcancavel(f.blocos.size(), 0), alvo(f.blocos.size(), 0);
+        vector<int> pilha = {0};
+        alcancavel[0] = 1;
+        while (!pilha.empty())
+        {
+            int b = pilha.back();
+            pilha.pop_back();
+            for (int s : f.sucessores(b))
+            {
+                alvo[s] = 1;
+                if (!alcancavel[s])
+                {
+                    alcancavel[s] = 1;
+                    pilha.push_back(s);
+                }
+            }
+        }
+        for (size_t b = 0; b < f.blocos.size(); b++)
+        {
+            if (!alcancavel[b])
+                continue;
+            if (alvo[b])
+                c << "B" << b << ":\n";
+            for (const Instr &instr : f.blocos[b].instrs)
+                emitir_instr(instr, c);
+        }
+        c << "}\n\n";
+    }
+
+    void emitir_instr(const Instr &instr, ostream &c)
+    {
+        string a = operando_c(instr.a), b = operando_c(instr.b);
+        switch (instr.op)
+        {
+        case IR_COPY:
+            c << "    v" << instr.dest << " = " << a << ";\n";
+            break;
+        case IR_BIN:
+            c << "    v" << instr.dest << " = ";
+            if (instr.binop == PLUS || instr.binop == MINUS || instr.binop == TIMES)
+            {
+                const char *op = instr.binop == PLUS ? "+" : instr.binop == MINUS ? "-" : "*";
+                c << "(int32_t)((uint32_t)" << a << " " << op << " (uint32_t)" << b << ")";
+            }
+            else if (instr.binop == DIVIDE)
+                c << "dividir(" << a << ", " << b << ", " << posicao(instr) << ")";
+            else
+                c << "(" << a << " " << comparacao_c(instr.binop) << " " << b << ")";
+            c << ";\n";
+            break;
+        case IR_PRINT:
+            c << "    imprimir(" << a << ");\n";
+            break;
+        case IR_RET:
+            c << "    return " << a << ";\n";
+            break;
+        case IR_JMP:
+            c << "    goto B" << instr.alvo << ";\n";
+            break;
+        case IR_BR:
+            c << "    if (" << a << ")\n"
+              << "        goto B" << instr.alvo << ";\n"
+              << "    goto B" << instr.alvo_senao << ";\n";
+            break;
+        case IR_CALL:
+            emitir_chamada(instr, c);
+            break;
+        }
+    }
+
+    void emitir_chamada(const Instr &instr, ostream &c)
+    {
+        auto it = indices.find(instr.funcao);
+        if (it == indices.end())
+        {
+            c << "    falhar(" << posicao(instr) << ", \"função '" << instr.funcao << "' não foi definida\");\n";
+            return;
+        }
+        // Como no avaliador: argumentos a mais são ignorados e os que faltam valem 0
+        const IRFunction &g = ir.funcoes[it->second];
+        string args;
+        for (int p = 0; p < g.num_params; p++)
+            args += (p ? ", " : "") + (p < (int)instr.args.size() ? operando_c(instr.args[p]) : string("0"));
+
+        c << "    if (++profundidade > LIMITE_PROFUNDIDADE)\n"
+          << "        falhar(" << posicao(instr) << ", \"mais de " << limite << " chamadas ativas\");\n"
+          << "    ";
+        if (instr.dest != -1)
+            c << "v" << instr.dest << " = ";
+        c << nome_funcao(ir, it->second) << "(" << args << ");\n"
+          << "    profundidade--;\n";
+    }
+
+    void emitir_main()
+    {
+        // Mesma raiz do avaliador: Main, senão o comando solto
+        int raiz = -1;
+        for (size_t i = 0; i < ir.funcoes.size() && raiz == -1; i++)
+            if (ir.funcoes[i].nome == "Main")
+                raiz = i;
+        for (size_t i = 0; i < ir.funcoes.size() && raiz == -1; i++)
+            if (ir.funcoes[i].nome.empty())
+                raiz = i;
+
+        out << "static void *executar(void *arg)\n"
+            << "{\n"
+            << "    (void)arg;\n";
+        if (raiz == -1)
+        {
+            out << "    falhar(-1, \"o programa não tem a função Main\");\n";
+        }
+        else
+        {
+            string zeros;
+            for (int p = 0; p < ir.funcoes[raiz].num_params; p++)
+                zeros += p ? ", 0" : "0";
+            out << "    " << nome_funcao(ir, raiz) << "(" << zeros << ");\n";
+        }
+        out << "    return NULL;\n"
+            << "}\n\n"
+            << "int main(void)\n"
+            << "{\n"
+            << "    /* Pilha para LIMITE_PROFUNDIDADE chamadas; a memória só é usada se a recursão chegar lá */\n"
+            << "    pthread_attr_t atributos;\n"
+            << "    pthread_t thread;\n"
+            << "    pthread_attr_init(&atributos);\n"
+            << "    pthread_attr_setstacksize(&atributos, (size_t)1 << 30);\n"
+            << "    if (pthread_create(&thread, &atributos, executar, NULL) == 0)\n"
+            << "        pthread_join(thread, NULL);\n"
+            << "    else\n"
+            << "        executar(NULL);\n"
+            << "    descarregar();\n"
+            << "    return 0;\n"
+            << "}\n";
+    }
+};
+
+void emit_c_program(const IRProgram &ir, const PositionResolver &linhas, const string &origem,
+                    size_t limite_profundidade, ostream &out)
+{
+    EmissorC emissor(ir, linhas, limite_profundidade, out);
+    emissor.emitir(origem);
+}
+
+// ==========================
+// Verificação
+// ==========================
+
+// Executa o comando com a saída padrão capturada; retorna o código de saída
+// (128 + sinal se terminou por sinal, -1 se não pôde ser executado)
+static int executar_comando(const string &comando, string &saida)
+{
+    FILE *p = popen(comando.c_str(), "r");
+    if (p == nullptr)
+        return -1;
+    char buffer[1 << 16];
+    size_t lidos;
+    while ((lidos = fread(buffer, 1, sizeof(buffer), p)) > 0)
+        saida.append(buffer, lidos);
+    int status = pclose(p);
+    if (status == -1)
+        return -1;
+    if (WIFSIGNALED(status))
+        return 128 + WTERMSIG(status);
+    return WEXITSTATUS(status);
+}
+
+bool verify_c_program(const IRProgram &ir, const PositionResolver &linhas, const string &origem, CVerifyResult &r,
+                      string &erro)
+{
+    r = CVerifyResult();
+    ExecOptions opcoes;
+    ExecStats st;
+    ErroExecucao erro_execucao;
+    ostringstream saida;
+    auto inicio = chrono::steady_clock::now();
+    bool ok = execute_program(ir, opcoes, saida, st, erro_execucao);
+    r.ms_avaliador = chrono::duration<double, milli>(chrono::steady_clock::now() - inicio).count();
+    r.saida_avaliador = saida.str();
+    if (!ok)
+        r.saida_avaliador += describe_exec_error(erro_execucao, linhas) + "\n";
+    r.codigo_avaliador = ok ? 0 : 1;
+
+    const char *tmp = getenv("TMPDIR");
+    string modelo = string(tmp != nullptr && *tmp ? tmp : "/tmp") + "/verify-c-XXXXXX";
+    if (mkdtemp(&modelo[0]) == nullptr)
+    {
+        erro = "não foi possível criar a pasta temporária " + modelo;
+        return false;
+    }
+    string fonte = modelo + "/programa.c", binario = modelo + "/programa";
+    auto limpar = [&]()
+    {
+        unlink(fonte.c_str());
+        unlink(binario.c_str());
+        rmdir(modelo.c_str());
+    };
+    {
+        ofstream out(fonte);
+        emit_c_program(ir, linhas, origem, opcoes.limite_profundidade, out);
+        if (!out)
+        {
+            limpar();
+            erro = "não foi possível gravar " + fonte;
+            return false;
+        }
+    }
+
+    const char *cc = getenv("CC");
+    string compilar = string(cc != nullptr && *cc ? cc : "cc") + " -O2 -o '" + binario + "' '" + fonte + "' -lpthread 2>&1";
+    string mensagens;
+    inicio = chrono::steady_clock::now();
+    int codigo = executar_comando(compilar, mensagens);
+    r.ms_compilacao = chrono::duration<double, milli>(chrono::steady_clock::now() - inicio).count();
+    if (codigo != 0)
+    {
+        limpar();
+        erro = "falha ao compilar (" + compilar + "):\n" + mensagens;
+        return false;
+    }
+
+    inicio = chrono::steady_clock::now();
+    r.codigo_binario = executar_comando("'" + binario + "'", r.saida_binario);
+    r.ms_binario = chrono::duration<double, milli>(chrono::steady_clock::now() - inicio).count();
+    limpar();
+    if (r.codigo_binario == -1)
+    {
+        erro = "não foi possível executar " + binario;
+        return false;
+    }
+    r.igual = r.saida_binario == r.saida_avaliador && r.codigo_binario == r.codigo_avaliador;
+    return true;
+}
@@ -0,0 +1,58 @@
+/*
+ * Trabalho de Compiladores - Geração de C
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo define o backend que traduz a IR para um programa C
+ * independente, para ser compilado com gcc ou clang (-O2). Cada função vira
+ * uma função C com as variáveis da IR como locais int32_t (iniciadas com 0),
+ * cada bloco básico vira um rótulo e os terminadores viram goto/return. O
+ * ponto de entrada é Main (ou o comando solto). Main roda em uma thread com
+ * pilha grande, e os prints vão para um buffer de 64 KB despejado com
+ * fwrite.
+ *
+ * A semântica é a do avaliador de referência (evaluator.h): soma, subtração
+ * e multiplicação em complemento de dois (feitas em uint32_t, sem o
+ * comportamento indefinido do int do C), divisão por zero e INT_MIN / -1
+ * testadas antes de dividir, o mesmo limite de chamadas ativas e as mesmas
+ * mensagens de erro, com a posição no código-fonte. O C é gerado da IR como
+ * saiu da AST, sem os passes de otimização: assim ele faz as mesmas chamadas
+ * que o --run sem --ir, e o limite de chamadas ativas estoura no mesmo ponto
+ * (o inline muda a profundidade). Quem otimiza é o compilador C.
+ *
+ * Data: Outubro de 2026
+ */
+
+#ifndef C_BACKEND_H
+#define C_BACKEND_H
+
+#include "ir.h"
+#include "line_index.h"
+#include <ostream>
+#include <string>
+
+using namespace std;
+
+// origem vai no comentário do cabeçalho; limite_profundidade como em ExecOptions
+void emit_c_program(const IRProgram &ir, const PositionResolver &linhas, const string &origem,
+                    size_t limite_profundidade, ostream &out);
+
+struct CVerifyResult
+{
+    bool igual = false;        // mesma saída e mesmo código de saída
+    string saida_avaliador, saida_binario;
+    int codigo_avaliador = 0, codigo_binario = 0;
+    double ms_avaliador = 0, ms_compilacao = 0, ms_binario = 0;
+};
+
+// Executa o programa no avaliador, gera o C em uma pasta temporária, compila
+// com "$CC -O2" (cc se CC não está definida), executa o binário e compara.
+// false (com erro) se não foi possível compilar ou executar.
+bool verify_c_program(const IRProgram &ir, const PositionResolver &linhas, const string &origem, CVerifyResult &r,
+                      string &erro);
+
+#endif // C_BACKEND_H
@@ -0,0 +1,390 @@
+/*
+ * Trabalho de Compiladores - Cache de Resultados
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo implementa o XXH64 e o cache em disco de tokens e resultados.
+ *
+ * Data: Outubro de 2026
+ */
+
+#include "cache.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// ==========================
+// XXH64
+// ==========================
+
+static const uint64_t PRIME64_1 = 0x9E3779B185EBCA87ULL;
+static const uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+static const uint64_t PRIME64_3 = 0x165667B19E3779F9ULL;
+static const uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+static const uint64_t PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+static inline uint64_t rotl64(uint64_t x, int r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t le64(const unsigned char *p)
+{
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return v;
+}
+
+static inline uint32_t le32(const unsigned char *p)
+{
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+static inline uint64_t xxh_round(uint64_t acc, uint64_t input)
+{
+    acc += input * PRIME64_2;
+    acc = rotl64(acc, 31);
+    return acc * PRIME64_1;
+}
+
+static inline uint64_t xxh_merge(uint64_t acc, uint64_t val)
+{
+    acc ^= xxh_round(0, val);
+    return acc * PRIME64_1 + PRIME64_4;
+}
+
+uint64_t xxhash64(const void *dados, size_t tamanho, uint64_t semente)
+{
+    const unsigned char *p = static_cast<const unsigned char *>(dados);
+    const unsigned char *fim = p + tamanho;
+    uint64_t h;
+
+    if (tamanho >= 32)
+    {
+        uint64_t v1 = semente + PRIME64_1 + PRIME64_2;
+        uint64_t v2 = semente + PRIME64_2;
+        uint64_t v3 = semente;
+        uint64_t v4 = semente - PRIME64_1;
+        const unsigned char *limite = fim - 32;
+        do
+        {
+            v1 = xxh_round(v1, le64(p));
+            v2 = xxh_round(v2, le64(p + 8));
+            v3 = xxh_round(v3, le64(p + 16));
+            v4 = xxh_round(v4, le64(p + 24));
+            p += 32;
+        } while (p <= limite);
+
+        h = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+        h = xxh_merge(h, v1);
+        h = xxh_merge(h, v2);
+        h = xxh_merge(h, v3);
+        h = xxh_merge(h, v4);
+    }
+    else
+    {
+        h = semente + PRIME64_5;
+    }
+
+    h += tamanho;
+
+    while (p + 8 <= fim)
+    {
+        h ^= xxh_round(0, le64(p));
+        h = rotl64(h, 27) * PRIME64_1 + PRIME64_4;
+        p += 8;
+    }
+    if (p + 4 <= fim)
+    {
+        h ^= static_cast<uint64_t>(le32(p)) * PRIME64_1;
+        h = rotl64(h, 23) * PRIME64_2 + PRIME64_3;
+        p += 4;
+    }
+    while (p < fim)
+    {
+        h ^= (*p) * PRIME64_5;
+        h = rotl64(h, 11) * PRIME64_1;
+        p++;
+    }
+
+    h ^= h >> 33;
+    h *= PRIME64_2;
+    h ^= h >> 29;
+    h *= PRIME64_3;
+    h ^= h >> 32;
+    return h;
+}
+
+// ==========================
+// Formato binário
+// ==========================
+
+static const char CACHE_MAGIC[4] = {'L', 'L', 'C', '1'};
+
+struct CacheHeader
+{
+    char magic[4];
+    uint8_t aceito;
+    uint8_t reservado[3];
+    uint64_t chave;
+    uint64_t tamanho_fonte;
+    uint32_t num_tokens;
+    uint32_t tam_posicoes;
+    uint32_t tam_diagnostico;
+    uint32_t reservado2;
+};
+
+static_assert(sizeof(CacheHeader) == 40, "CacheHeader deve ter layout fixo");
+
+static void put_varint(string &out, uint64_t v)
+{
+    while (v >= 0x80)
+    {
+        out += static_cast<char>((v & 0x7F) | 0x80);
+        v >>= 7;
+    }
+    out += static_cast<char>(v);
+}
+
+static bool get_varint(const unsigned char *&p, const unsigned char *fim, uint64_t &v)
+{
+    v = 0;
+    for (int shift = 0; p < fim && shift < 64; shift += 7)
+    {
+        unsigned char b = *p++;
+        v |= static_cast<uint64_t>(b & 0x7F) << shift;
+        if (!(b & 0x80))
+            return true;
+    }
+    return false;
+}
+
+// Tag passada ao create_token para reconstruir o token
+static Tag tag_original(const Token *tok)
+{
+    if (const Relop *relop = dynamic_cast<const Relop *>(tok))
+        return relop->relop;
+    if (const Arithop *arithop = dynamic_cast<const Arithop *>(tok))
+        return arithop->arithop;
+    return tok->tag;
+}
+
+// ==========================
+// ParseCache
+// ==========================
+
+ParseCache::ParseCache(const string &diretorio, uint64_t versao, uint64_t limite)
+    : diretorio(diretorio), versao(versao), limite(limite)
+{
+    mkdir(diretorio.c_str(), 0755);
+}
+
+string ParseCache::caminho(const string &fonte) const
+{
+    char nome[32];
+    snprintf(nome, sizeof(nome), "%016llx.llc", static_cast<unsigned long long>(xxhash64(fonte.data(), fonte.size(), versao)));
+    return diretorio + "/" + nome;
+}
+
+bool ParseCache::lookup(const string &fonte, CacheEntry &entrada)
+{
+    string arquivo = caminho(fonte);
+    int fd = open(arquivo.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        falhas++;
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(CacheHeader))
+    {
+        close(fd);
+        falhas++;
+        return false;
+    }
+
+    void *mapa = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapa == MAP_FAILED)
+    {
+        falhas++;
+        return false;
+    }
+
+    const unsigned char *base = static_cast<const unsigned char *>(mapa);
+    CacheHeader h;
+    memcpy(&h, base, sizeof(h));
+
+    uint64_t chave = xxhash64(fonte.data(), fonte.size(), versao);
+    bool valido = memcmp(h.magic, CACHE_MAGIC, 4) == 0 && h.chave == chave && h.tamanho_fonte == fonte.size() &&
+                  sizeof(CacheHeader) + (uint64_t)h.num_tokens + h.tam_posicoes + h.tam_diagnostico == (uint64_t)st.st_size;
+
+    vector<Token *> tokens;
+    if (valido)
+    {
+        const unsigned char *tags = base + sizeof(CacheHeader);
+        const unsigned char *p = tags + h.num_tokens;
+        const unsigned char *fim_posicoes = p + h.tam_posicoes;
+        uint64_t pos = 0;
+        tokens.reserve(h.num_tokens);
+
+        for (uint32_t i = 0; i < h.num_tokens && valido; i++)
+        {
+            uint64_t distancia, tamanho;
+            if (!get_varint(p, fim_posicoes, distancia) || !get_varint(p, fim_posicoes, tamanho) ||
+                pos + distancia + tamanho > fonte.size() || tags[i] > EOF_TOKEN)
+            {
+                valido = false;
+                break;
+            }
+            pos += distancia;
+            // Confere contra colisões de hash: nenhum token começa com espaço
+            if (tamanho == 0 || isspace(static_cast<unsigned char>(fonte[pos])))
+            {
+                valido = false;
+                break;
+            }
+
+            Tag tag = static_cast<Tag>(tags[i]);
+            if (tag == UNK)
+                tokens.push_back(create_unknown(fonte, pos, pos + tamanho));
+            else
+                tokens.push_back(create_token(tag, fonte.substr(pos, tamanho), pos));
+            pos += tamanho;
+        }
+
+        if (valido)
+        {
+            entrada.tokens = std::move(tokens);
+            entrada.aceito = h.aceito != 0;
+            entrada.diagnostico.assign(reinterpret_cast<const char *>(fim_posicoes), h.tam_diagnostico);
+        }
+        else
+        {
+            for (Token *tok : tokens)
+                delete tok;
+        }
+    }
+    munmap(mapa, st.st_size);
+
+    if (!valido)
+    {
+        falhas++;
+        return false;
+    }
+
+    // Marca como usado recentemente para o LRU
+    utimensat(AT_FDCWD, arquivo.c_str(), nullptr, 0);
+    acertos++;
+    return true;
+}
+
+void ParseCache::store(const string &fonte, const CacheEntry &entrada)
+{
+    string tags, posicoes;
+    tags.reserve(entrada.tokens.size());
+
+    size_t pos = 0;
+    for (const Token *tok : entrada.tokens)
+    {
+        size_t inicio = tok->offset;
+        if (inicio < pos || fonte.compare(inicio, tok->lexeme.size(), tok->lexeme) != 0)
+            return; // tokens não correspondem ao código; não guarda nada
+
+        tags += static_cast<char>(tag_original(tok));
+        put_varint(posicoes, inicio - pos);
+        put_varint(posicoes, tok->lexeme.size());
+        pos = inicio + tok->lexeme.size();
+    }
+
+    CacheHeader h = {};
+    memcpy(h.magic, CACHE_MAGIC, 4);
+    h.aceito = entrada.aceito;
+    h.chave = xxhash64(fonte.data(), fonte.size(), versao);
+    h.tamanho_fonte = fonte.size();
+    h.num_tokens = entrada.tokens.size();
+    h.tam_posicoes = posicoes.size();
+    h.tam_diagnostico = entrada.diagnostico.size();
+
+    string dados(reinterpret_cast<const char *>(&h), sizeof(h));
+    dados += tags;
+    dados += posicoes;
+    dados += entrada.diagnostico;
+    if (dados.size() > limite)
+        return;
+
+    // Escreve em um arquivo temporário e renomeia, para nunca expor entradas pela metade
+    string arquivo = caminho(fonte);
+    string temporario = arquivo + ".tmp" + to_string(getpid());
+    FILE *f = fopen(temporario.c_str(), "wb");
+    if (f == nullptr)
+        return;
+    bool ok = fwrite(dados.data(), 1, dados.size(), f) == dados.size();
+    ok = fclose(f) == 0 && ok;
+    if (!ok || rename(temporario.c_str(), arquivo.c_str()) != 0)
+    {
+        unlink(temporario.c_str());
+        return;
+    }
+
+    evict();
+}
+
+void ParseCache::evict()
+{
+    struct Arquivo
+    {
+        string caminho;
+        uint64_t tamanho;
+        struct timespec uso;
+    };
+
+    DIR *dir = opendir(diretorio.c_str());
+    if (dir == nullptr)
+        return;
+
+    vector<Arquivo> arquivos;
+    uint64_t total = 0;
+    while (struct dirent *e = readdir(dir))
+    {
+        string nome = e->d_name;
+        if (nome.size() < 4 || nome.compare(nome.size() - 4, 4, ".llc") != 0)
+            continue;
+        string completo = diretorio + "/" + nome;
+        struct stat st;
+        if (stat(completo.c_str(), &st) != 0)
+            continue;
+        arquivos.push_back(Arquivo{completo, (uint64_t)st.st_size, st.st_mtim});
+        total += st.st_size;
+    }
+    closedir(dir);
+
+    if (total <= limite)
+        return;
+
+    sort(arquivos.begin(), arquivos.end(), [](const Arquivo &a, const Arquivo &b)
+         { return a.uso.tv_sec != b.uso.tv_sec ? a.uso.tv_sec < b.uso.tv_sec : a.uso.tv_nsec < b.uso.tv_nsec; });
+    for (const auto &a : arquivos)
+    {
+        if (total <= limite)
+            break;
+        if (unlink(a.caminho.c_str()) == 0)
+        {
+            total -= a.tamanho;
+            removidas++;
+        }
+    }
+}
@@ -0,0 +1,72 @@
+/*
+ * Trabalho de Compiladores - Cache de Resultados
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo define um cache em disco, endereçado pelo conteúdo, da sequência
+ * de tokens e do resultado (aceito/rejeitado + diagnóstico) de cada entrada.
+ *
+ * A chave é o XXH64 do código-fonte com a versão da ferramenta/gramática como
+ * semente. Cada entrada é um arquivo binário que pode ser lido direto via mmap:
+ *
+ *   cabeçalho (CacheHeader, 40 bytes)
+ *   tags[num_tokens]            1 byte por token (Tag do create_token)
+ *   posições[tam_posicoes]      por token, em varint: distância desde o fim do
+ *                               token anterior e tamanho do lexema
+ *   diagnóstico[tam_diagnostico]
+ *
+ * Os lexemas não são guardados: são recortados do próprio código-fonte, que
+ * precisa estar em mãos para calcular a chave de qualquer forma.
+ *
+ * O tamanho total do diretório é limitado; ao passar do limite, as entradas
+ * usadas há mais tempo (mtime, atualizado a cada acerto) são removidas (LRU).
+ *
+ * Data: Outubro de 2026
+ */
+
+#ifndef CACHE_H
+#define CACHE_H
+
+#include "automata.h"
+#include "lexer.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+uint64_t xxhash64(const void *dados, size_t tamanho, uint64_t semente);
+
+struct CacheEntry
+{
+    vector<Token *> tokens;
+    bool aceito = false;
+    string diagnostico;
+};
+
+class ParseCache
+{
+public:
+    // versao identifica ferramenta + gramática; limite em bytes para o diretório
+    ParseCache(const string &diretorio, uint64_t versao, uint64_t limite);
+
+    // Em caso de acerto, reconstrói os tokens a partir do código-fonte
+    bool lookup(const string &fonte, CacheEntry &entrada);
+    void store(const string &fonte, const CacheEntry &entrada);
+
+    size_t acertos = 0, falhas = 0, removidas = 0;
+
+private:
+    string diretorio;
+    uint64_t versao;
+    uint64_t limite;
+
+    string caminho(const string &fonte) const;
+    void evict();
+};
+
+#endif // CACHE_H
@@ -0,0 +1,411 @@
+/*
+ * Trabalho de Compiladores - Grafo de Chamadas e Inlining
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo implementa a construção do grafo de chamadas, as componentes
+ * fortemente conexas (Tarjan, iterativo), a análise de pureza e o pass de
+ * inlining com remoção de funções inalcançáveis.
+ *
+ * Data: Outubro de 2026
+ */
+
+#include "callgraph.h"
+#include <algorithm>
+#include <sstream>
+#include <unordered_map>
+
+// ==========================
+// Grafo de chamadas
+// ==========================
+
+static unordered_map<string, int> indices_funcoes(const IRProgram &ir)
+{
+    unordered_map<string, int> indices;
+    for (size_t i = 0; i < ir.funcoes.size(); i++)
+        indices[ir.funcoes[i].nome] = i;
+    return indices;
+}
+
+// Tarjan sem recursão: dfs guarda (função, próxima aresta a visitar)
+static void tarjan(CallGraph &g)
+{
+    size_t n = g.chamadas.size();
+    vector<int> indice(n, -1), baixo(n, 0), pilha;
+    vector<char> na_pilha(n, 0);
+    int contador = 0;
+    g.componente.assign(n, -1);
+
+    auto visitar = [&](int v)
+    {
+        indice[v] = baixo[v] = contador++;
+        pilha.push_back(v);
+        na_pilha[v] = 1;
+    };
+
+    for (size_t s = 0; s < n; s++)
+    {
+        if (indice[s] != -1)
+            continue;
+        vector<pair<int, size_t>> dfs = {{(int)s, 0}};
+        visitar(s);
+        while (!dfs.empty())
+        {
+            int v = dfs.back().first;
+            size_t proxima = dfs.back().second++;
+            if (proxima < g.chamadas[v].size())
+            {
+                int w = g.chamadas[v][proxima];
+                if (indice[w] == -1)
+                {
+                    visitar(w);
+                    dfs.push_back({w, 0});
+                }
+                else if (na_pilha[w])
+                {
+                    baixo[v] = min(baixo[v], indice[w]);
+                }
+                continue;
+            }
+
+            if (baixo[v] == indice[v])
+            {
+                vector<int> comp;
+                int w;
+                do
+                {
+                    w = pilha.back();
+                    pilha.pop_back();
+                    na_pilha[w] = 0;
+                    g.componente[w] = g.componentes.size();
+                    comp.push_back(w);
+                } while (w != v);
+                g.componentes.push_back(comp);
+            }
+            dfs.pop_back();
+            if (!dfs.empty())
+                baixo[dfs.back().first] = min(baixo[dfs.back().first], baixo[v]);
+        }
+    }
+}
+
+CallGraph build_call_graph(const IRProgram &ir)
+{
+    unordered_map<string, int> indices = indices_funcoes(ir);
+    CallGraph g;
+    g.chamadas.resize(ir.funcoes.size());
+    for (size_t i = 0; i < ir.funcoes.size(); i++)
+    {
+        auto &chamadas = g.chamadas[i];
+        for (const auto &bloco : ir.funcoes[i].blocos)
+            for (const Instr &instr : bloco.instrs)
+            {
+                if (instr.op != IR_CALL)
+                    continue;
+                auto it = indices.find(instr.funcao);
+                if (it != indices.end() && find(chamadas.begin(), chamadas.end(), it->second) == chamadas.end())
+                    chamadas.push_back(it->second);
+            }
+    }
+
+    tarjan(g);
+
+    g.recursiva.assign(ir.funcoes.size(), 0);
+    for (const auto &comp : g.componentes)
+        for (int f : comp)
+            g.recursiva[f] = comp.size() > 1 || find(g.chamadas[f].begin(), g.chamadas[f].end(), f) != g.chamadas[f].end();
+    return g;
+}
+
+vector<char> CallGraph::alcancaveis(const IRProgram &ir) const
+{
+    vector<int> pilha;
+    for (size_t i = 0; i < ir.funcoes.size(); i++)
+        if (ir.funcoes[i].nome == "Main" || ir.funcoes[i].nome.empty())
+            pilha.push_back(i);
+    if (pilha.empty())
+        return vector<char>(ir.funcoes.size(), 1);
+
+    vector<char> visitada(ir.funcoes.size(), 0);
+    for (int f : pilha)
+        visitada[f] = 1;
+    while (!pilha.empty())
+    {
+        int f = pilha.back();
+        pilha.pop_back();
+        for (int g : chamadas[f])
+            if (!visitada[g])
+            {
+                visitada[g] = 1;
+                pilha.push_back(g);
+            }
+    }
+    return visitada;
+}
+
+// ==========================
+// Pureza
+// ==========================
+
+vector<char> analyze_purity(const IRProgram &ir, const CallGraph &grafo)
+{
+    unordered_map<string, int> indices = indices_funcoes(ir);
+    vector<char> pura(ir.funcoes.size(), 0);
+    for (const auto &comp : grafo.componentes)
+    {
+        int c = grafo.componente[comp[0]];
+        bool ok = true;
+        for (size_t k = 0; k < comp.size() && ok; k++)
+            for (const auto &bloco : ir.funcoes[comp[k]].blocos)
+                for (const Instr &instr : bloco.instrs)
+                {
+                    if (instr.op == IR_PRINT)
+                        ok = false;
+                    else if (instr.op == IR_CALL)
+                    {
+                        // Chamadas dentro da componente ficam a cargo das outras condições
+                        auto it = indices.find(instr.funcao);
+                        ok &= it != indices.end() && (grafo.componente[it->second] == c || pura[it->second]);
+                    }
+                }
+        for (int f : comp)
+            pura[f] = ok;
+    }
+    return pura;
+}
+
+// ==========================
+// Inlining
+// ==========================
+
+// Blocos alcançáveis a partir da entrada, em ordem crescente
+static vector<int> blocos_alcancaveis(const IRFunction &f)
+{
+    vector<char> visitado(f.blocos.size(), 0);
+    vector<int> pilha = {0};
+    visitado[0] = 1;
+    while (!pilha.empty())
+    {
+        int b = pilha.back();
+        pilha.pop_back();
+        for (int s : f.sucessores(b))
+            if (!visitado[s])
+            {
+                visitado[s] = 1;
+                pilha.push_back(s);
+            }
+    }
+    vector<int> blocos;
+    for (size_t b = 0; b < f.blocos.size(); b++)
+        if (visitado[b])
+            blocos.push_back(b);
+    return blocos;
+}
+
+// Corpo já preparado para ser copiado nos pontos de chamada
+struct Corpo
+{
+    vector<int> blocos; // só os alcançáveis
+    int tamanho = 0;
+    bool ret_sem_valor = false;
+};
+
+static Corpo preparar(const IRFunction &f)
+{
+    Corpo c;
+    c.blocos = blocos_alcancaveis(f);
+    for (int b : c.blocos)
+    {
+        c.tamanho += f.blocos[b].instrs.size();
+        const Instr &term = f.blocos[b].instrs.back();
+        if (term.op == IR_RET && term.a.tipo == Operando::NENHUM)
+            c.ret_sem_valor = true;
+    }
+    return c;
+}
+
+// Substitui a chamada em f.blocos[b].instrs[pos] por uma cópia do corpo de g:
+// o bloco é dividido na chamada, os argumentos são copiados para variáveis
+// novas no lugar dos parâmetros e cada "ret" vira cópia para o destino
+// seguida de desvio para a continuação
+static void expandir(IRFunction &f, int b, size_t pos, const IRFunction &g, const Corpo &corpo, int copia,
+                     int &proximo_temp)
+{
+    Instr chamada = f.blocos[b].instrs[pos];
+
+    int continuacao = f.blocos.size();
+    f.blocos.emplace_back();
+    auto &origem = f.blocos[b].instrs;
+    f.blocos[continuacao].instrs.assign(origem.begin() + pos + 1, origem.end());
+    origem.erase(origem.begin() + pos, origem.end());
+
+    vector<int> var(g.vars.size());
+    for (size_t v = 0; v < g.vars.size(); v++)
+    {
+        var[v] = f.vars.size();
+        if (g.temporario[v])
+            f.vars.push_back("t" + to_string(proximo_temp++));
+        else
+            f.vars.push_back(g.nome + to_string(copia) + "." + g.vars[v]);
+        f.temporario.push_back(g.temporario[v]);
+    }
+
+    vector<int> bloco(g.blocos.size(), -1);
+    for (int gb : corpo.blocos)
+    {
+        bloco[gb] = f.blocos.size();
+        f.blocos.emplace_back();
+    }
+
+    for (int p = 0; p < g.num_params; p++)
+    {
+        Instr copy(IR_COPY);
+        copy.dest = var[p];
+        copy.a = chamada.args[p];
+        f.blocos[b].instrs.push_back(copy);
+    }
+    Instr entrada(IR_JMP);
+    entrada.alvo = bloco[0];
+    f.blocos[b].instrs.push_back(entrada);
+
+    auto renomear = [&](Operando op)
+    {
+        if (op.tipo == Operando::VAR)
+            op.valor = var[op.valor];
+        return op;
+    };
+
+    for (int gb : corpo.blocos)
+    {
+        auto &destino = f.blocos[bloco[gb]].instrs;
+        for (const Instr &original : g.blocos[gb].instrs)
+        {
+            if (original.op == IR_RET)
+            {
+                if (chamada.dest != -1)
+                {
+                    Instr copy(IR_COPY);
+                    copy.dest = chamada.dest;
+                    copy.a = renomear(original.a);
+                    destino.push_back(copy);
+                }
+                Instr volta(IR_JMP);
+                volta.alvo = continuacao;
+                destino.push_back(volta);
+                continue;
+            }
+
+            Instr instr = original;
+            if (instr.dest != -1)
+                instr.dest = var[instr.dest];
+            instr.a = renomear(instr.a);
+            instr.b = renomear(instr.b);
+            for (auto &arg : instr.args)
+                arg = renomear(arg);
+            if (instr.alvo != -1)
+                instr.alvo = bloco[instr.alvo];
+            if (instr.alvo_senao != -1)
+                instr.alvo_senao = bloco[instr.alvo_senao];
+            destino.push_back(instr);
+        }
+    }
+}
+
+int InlinePass::run_program(IRProgram &ir)
+{
+    expandidas = 0;
+    recursivas.clear();
+    removidas.clear();
+    instrs_removidas = 0;
+
+    unordered_map<string, int> indices = indices_funcoes(ir);
+    CallGraph grafo = build_call_graph(ir);
+    for (size_t i = 0; i < ir.funcoes.size(); i++)
+        if (grafo.recursiva[i])
+            recursivas.push_back(ir.funcoes[i].nome);
+
+    // Chamadas antes de quem chama: cada corpo copiado já está expandido
+    vector<Corpo> corpos(ir.funcoes.size());
+    for (const auto &comp : grafo.componentes)
+        for (int i : comp)
+        {
+            IRFunction &f = ir.funcoes[i];
+            int tamanho = f.num_instrs();
+            int proximo_temp = count(f.temporario.begin(), f.temporario.end(), true);
+            vector<int> copias(ir.funcoes.size(), 0);
+
+            // Os blocos criados no fim também são percorridos: a continuação
+            // pode ter outras chamadas
+            for (size_t b = 0; b < f.blocos.size(); b++)
+                for (size_t pos = 0; pos < f.blocos[b].instrs.size(); pos++)
+                {
+                    const Instr &instr = f.blocos[b].instrs[pos];
+                    if (instr.op != IR_CALL)
+                        continue;
+                    auto it = indices.find(instr.funcao);
+                    if (it == indices.end() || grafo.recursiva[it->second])
+                        continue;
+                    int j = it->second;
+                    const Corpo &corpo = corpos[j];
+                    const IRFunction &g = ir.funcoes[j];
+                    if (corpo.tamanho > limite_funcao || tamanho + corpo.tamanho > limite_crescimento ||
+                        (int)instr.args.size() != g.num_params || (instr.dest != -1 && corpo.ret_sem_valor))
+                        continue;
+
+                    expandir(f, b, pos, g, corpo, ++copias[j], proximo_temp);
+                    tamanho = f.num_instrs();
+                    expandidas++;
+                    break; // o resto do bloco foi para a continuação
+                }
+            corpos[i] = preparar(f);
+        }
+
+    // Funções que ficaram sem quem as chame
+    CallGraph final = build_call_graph(ir);
+    vector<char> vivas = final.alcancaveis(ir);
+    vector<IRFunction> mantidas;
+    for (size_t i = 0; i < ir.funcoes.size(); i++)
+    {
+        if (vivas[i])
+        {
+            mantidas.push_back(std::move(ir.funcoes[i]));
+        }
+        else
+        {
+            removidas.push_back(ir.funcoes[i].nome);
+            instrs_removidas += ir.funcoes[i].num_instrs();
+        }
+    }
+    ir.funcoes = std::move(mantidas);
+
+    return expandidas + removidas.size();
+}
+
+// Os primeiros nomes; programas gerados podem ter milhares de funções
+static string juntar_nomes(const vector<string> &nomes)
+{
+    const size_t MAX_NOMES = 10;
+    string s;
+    for (size_t i = 0; i < nomes.size() && i < MAX_NOMES; i++)
+        s += (i ? ", " : "") + nomes[i];
+    if (nomes.size() > MAX_NOMES)
+        s += ", ... (+" + to_string(nomes.size() - MAX_NOMES) + ")";
+    return s;
+}
+
+string InlinePass::resumo() const
+{
+    ostringstream out;
+    out << "inline: " << expandidas << " chamada(s) expandida(s), " << removidas.size() << " função(ões) removida(s) ("
+        << instrs_removidas << " instruções)";
+    if (!removidas.empty())
+        out << ": " << juntar_nomes(removidas);
+    out << "\n";
+    if (!recursivas.empty())
+        out << "inline: recursivas (não expandidas): " << juntar_nomes(recursivas) << "\n";
+    return out.str();
+}
@@ -0,0 +1,81 @@
+/*
+ * Trabalho de Compiladores - Grafo de Chamadas e Inlining
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo define o grafo de chamadas da IR (uma aresta para cada
+ * "call IDFUN" distinto), a detecção de recursão pelas componentes
+ * fortemente conexas de Tarjan e o pass interprocedural "inline":
+ *
+ * - as funções são visitadas de baixo para cima (Tarjan devolve as
+ *   componentes com as chamadas antes de quem chama), então quando uma
+ *   função é expandida em quem a chama ela já recebeu os próprios inlines;
+ * - uma chamada é expandida se a função chamada não é recursiva (não está
+ *   em uma componente com mais de uma função nem chama a si mesma), tem no
+ *   máximo limite_funcao instruções alcançáveis e a função que chama não
+ *   passa de limite_crescimento instruções;
+ * - depois, funções que não são alcançáveis a partir das raízes (Main ou o
+ *   programa sem funções) são removidas. Sem raiz, nada é removido.
+ *
+ * Também define a análise de pureza: uma função é pura se não tem print e
+ * só chama funções puras. Como os parâmetros são int passados por valor e
+ * não há variáveis globais, o resultado de uma função pura depende só dos
+ * argumentos (é o que permite a memoização em evaluator.h).
+ *
+ * Data: Outubro de 2026
+ */
+
+#ifndef CALLGRAPH_H
+#define CALLGRAPH_H
+
+#include "ir.h"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+struct CallGraph
+{
+    vector<vector<int>> chamadas; // índice da função -> funções chamadas (sem repetição)
+    vector<int> componente;       // índice da função -> componente de Tarjan
+    vector<vector<int>> componentes; // em ordem topológica reversa (chamadas primeiro)
+    vector<char> recursiva;       // índice da função -> está em um ciclo
+
+    // Funções alcançáveis a partir de Main (ou da função global); todas se
+    // não há raiz
+    vector<char> alcancaveis(const IRProgram &ir) const;
+};
+
+CallGraph build_call_graph(const IRProgram &ir);
+
+// Índice da função -> é pura. As componentes são visitadas com as chamadas
+// primeiro; uma função recursiva é pura se nenhuma função da componente tem
+// print ou chama algo impuro (ou não definido) fora dela.
+vector<char> analyze_purity(const IRProgram &ir, const CallGraph &grafo);
+
+class InlinePass : public Pass
+{
+public:
+    explicit InlinePass(int limite_funcao = 16, int limite_crescimento = 2000)
+        : limite_funcao(limite_funcao), limite_crescimento(limite_crescimento) {}
+
+    string nome() const override { return "inline"; }
+    int run(IRFunction &) override { return 0; } // só faz sentido no programa inteiro
+    int run_program(IRProgram &ir) override;
+    string resumo() const override;
+
+private:
+    int limite_funcao;
+    int limite_crescimento;
+
+    int expandidas = 0;           // chamadas substituídas pelo corpo
+    vector<string> recursivas;
+    vector<string> removidas;
+    int instrs_removidas = 0;     // instruções das funções removidas
+};
+
+#endif // CALLGRAPH_H
@@ -0,0 +1,355 @@
+/*
+ * Trabalho de Compiladores - Entrada Comprimida
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo implementa o reconhecimento do formato, os descompressores
+ * de gzip (zlib) e zstd em passos sobre buffers e a thread auxiliar do
+ * DecompressingReader.
+ *
+ * Data: Outubro de 2026
+ */
+
+#include "compressed_input.h"
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <unistd.h>
+#include <zlib.h>
+#ifdef USE_ZSTD
+#include <zstd.h>
+#endif
+
+Compressao detect_compression(const char *dados, size_t n)
+{
+    const unsigned char *p = reinterpret_cast<const unsigned char *>(dados);
+    if (n >= 2 && p[0] == 0x1f && p[1] == 0x8b)
+        return GZIP;
+    if (n >= 4 && p[0] == 0x28 && p[1] == 0xb5 && p[2] == 0x2f && p[3] == 0xfd)
+        return ZSTD;
+    return SEM_COMPRESSAO;
+}
+
+const char *compression_name(Compressao formato)
+{
+    switch (formato)
+    {
+    case GZIP:
+        return "gzip";
+    case ZSTD:
+        return "zstd";
+    default:
+        return "sem compressão";
+    }
+}
+
+// Um passo de descompressão: consome parte de [entrada, entrada + n_entrada)
+// e escreve até n_saida bytes, atualizando os dois com o que foi usado
+class Descompressor
+{
+public:
+    virtual ~Descompressor() {}
+    // false em dados inválidos (com erro)
+    virtual bool passo(const char *&entrada, size_t &n_entrada, char *saida, size_t &n_saida, string &erro) = 0;
+    // Há um membro (gzip) ou quadro (zstd) começado e não terminado
+    bool incompleto() const { return em_membro; }
+
+protected:
+    bool em_membro = false;
+};
+
+class DescompressorGzip : public Descompressor
+{
+public:
+    DescompressorGzip()
+    {
+        memset(&z, 0, sizeof z);
+        iniciado = inflateInit2(&z, 15 + 16) == Z_OK; // 16: cabeçalho gzip
+    }
+    ~DescompressorGzip() override
+    {
+        if (iniciado)
+            inflateEnd(&z);
+    }
+
+    bool passo(const char *&entrada, size_t &n_entrada, char *saida, size_t &n_saida, string &erro) override
+    {
+        if (!iniciado)
+        {
+            erro = "não foi possível iniciar a zlib";
+            return false;
+        }
+        // Bytes depois do fim de um membro são o próximo membro
+        if (n_entrada > 0)
+            em_membro = true;
+        z.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(entrada));
+        z.avail_in = static_cast<uInt>(n_entrada);
+        z.next_out = reinterpret_cast<Bytef *>(saida);
+        z.avail_out = static_cast<uInt>(n_saida);
+        int r = inflate(&z, Z_NO_FLUSH);
+        entrada += n_entrada - z.avail_in;
+        n_entrada = z.avail_in;
+        n_saida -= z.avail_out;
+        if (r == Z_STREAM_END)
+        {
+            em_membro = false;
+            inflateReset(&z);
+            return true;
+        }
+        if (r == Z_OK || r == Z_BUF_ERROR) // Z_BUF_ERROR: sem progresso possível agora
+            return true;
+        erro = string("dados gzip inválidos") + (z.msg ? string(": ") + z.msg : "");
+        return false;
+    }
+
+private:
+    z_stream z;
+    bool iniciado;
+};
+
+#ifdef USE_ZSTD
+class DescompressorZstd : public Descompressor
+{
+public:
+    DescompressorZstd() : ds(ZSTD_createDStream())
+    {
+        if (ds != nullptr)
+            ZSTD_initDStream(ds);
+    }
+    ~DescompressorZstd() override { ZSTD_freeDStream(ds); }
+
+    bool passo(const char *&entrada, size_t &n_entrada, char *saida, size_t &n_saida, string &erro) override
+    {
+        if (ds == nullptr)
+        {
+            erro = "não foi possível iniciar o zstd";
+            return false;
+        }
+        ZSTD_inBuffer in = {entrada, n_entrada, 0};
+        ZSTD_outBuffer out = {saida, n_saida, 0};
+        size_t r = ZSTD_decompressStream(ds, &out, &in);
+        if (ZSTD_isError(r))
+        {
+            erro = string("dados zstd inválidos: ") + ZSTD_getErrorName(r);
+            return false;
+        }
+        entrada += in.pos;
+        n_entrada -= in.pos;
+        n_saida = out.pos;
+        em_membro = r != 0; // 0: o quadro terminou e foi todo escrito
+        return true;
+    }
+
+private:
+    ZSTD_DStream *ds;
+};
+#endif
+
+static Descompressor *criar_descompressor(Compressao formato, string &erro)
+{
+    if (formato == GZIP)
+        return new DescompressorGzip();
+#ifdef USE_ZSTD
+    if (formato == ZSTD)
+        return new DescompressorZstd();
+#endif
+    if (formato == ZSTD)
+        erro = "entrada zstd, mas o suporte a zstd não foi compilado (use -DUSE_ZSTD e -lzstd)";
+    else
+        erro = "a entrada não está comprimida";
+    return nullptr;
+}
+
+DecompressingReader::DecompressingReader(int fd, Compressao formato, string prefixo, size_t tamanho_bloco,
+                                         size_t num_blocos)
+    : fd(fd), formato(formato), prefixo(move(prefixo)), tamanho_bloco(tamanho_bloco),
+      blocos(num_blocos, vector<char>(tamanho_bloco)), cheios(num_blocos), livres(num_blocos)
+{
+    for (uint32_t i = 0; i < num_blocos; i++)
+        livres.push(&i, 1);
+    auxiliar = thread(&DecompressingReader::descomprimir, this);
+}
+
+DecompressingReader::~DecompressingReader()
+{
+    cancelado.store(true, memory_order_relaxed);
+    auxiliar.join();
+}
+
+// Thread auxiliar: lê o descritor, descomprime em blocos livres e os publica
+void DecompressingReader::descomprimir()
+{
+    string falha;
+    unique_ptr<Descompressor> d(criar_descompressor(formato, falha));
+
+    vector<char> comprimido(tamanho_bloco);
+    const char *entrada = prefixo.data();
+    size_t n_entrada = prefixo.size();
+    bool fim_arquivo = false;
+
+    uint32_t bloco = 0;
+    size_t usados = 0;
+    bool tem_bloco = false;
+
+    while (d != nullptr)
+    {
+        if (!tem_bloco)
+        {
+            unsigned tentativas = 0;
+            while (livres.pop(&bloco, 1) == 0)
+            {
+                if (cancelado.load(memory_order_relaxed))
+                    return;
+                esperar_fila(tentativas);
+            }
+            tem_bloco = true;
+            usados = 0;
+        }
+
+        if (n_entrada == 0 && !fim_arquivo)
+        {
+            ssize_t n;
+            do
+            {
+                n = ::read(fd, comprimido.data(), comprimido.size());
+            } while (n < 0 && errno == EINTR);
+            if (n < 0)
+            {
+                falha = string("erro ao ler a entrada: ") + strerror(errno);
+                break;
+            }
+            fim_arquivo = n == 0;
+            entrada = comprimido.data();
+            n_entrada = n;
+        }
+
+        bool sem_entrada = n_entrada == 0;
+        if (sem_entrada && !d->incompleto())
+            break;
+
+        size_t n_saida = tamanho_bloco - usados;
+        if (!d->passo(entrada, n_entrada, blocos[bloco].data() + usados, n_saida, falha))
+            break;
+        usados += n_saida;
+
+        // Sem entrada e sem saída: o arquivo acabou no meio de um membro
+        if (sem_entrada && n_saida == 0 && d->incompleto())
+        {
+            falha = string("entrada ") + compression_name(formato) + " truncada";
+            break;
+        }
+
+        if (usados == tamanho_bloco)
+        {
+            Pedaco p{bloco, static_cast<uint32_t>(usados)};
+            cheios.push(&p, 1); // nunca cheia: há tantos lugares quanto blocos
+            tem_bloco = false;
+        }
+    }
+
+    if (tem_bloco && usados > 0)
+    {
+        Pedaco p{bloco, static_cast<uint32_t>(usados)};
+        cheios.push(&p, 1);
+    }
+    erro = falha;
+    terminou.store(true, memory_order_release);
+}
+
+size_t DecompressingReader::read(char *destino, size_t n)
+{
+    size_t copiados = 0;
+    while (copiados < n)
+    {
+        if (!tem_atual)
+        {
+            unsigned tentativas = 0;
+            while (cheios.pop(&atual, 1) == 0)
+            {
+                // Só espera se ainda não há nada para devolver
+                if (copiados > 0)
+                    return copiados;
+                if (terminou.load(memory_order_acquire))
+                {
+                    // O último bloco pode ter sido publicado antes de terminou
+                    if (cheios.pop(&atual, 1) == 1)
+                        break;
+                    return 0;
+                }
+                esperar_fila(tentativas);
+            }
+            tem_atual = true;
+            posicao = 0;
+        }
+
+        size_t k = min(n - copiados, atual.tamanho - posicao);
+        memcpy(destino + copiados, blocos[atual.bloco].data() + posicao, k);
+        posicao += k;
+        copiados += k;
+        if (posicao == atual.tamanho)
+        {
+            livres.push(&atual.bloco, 1);
+            tem_atual = false;
+        }
+    }
+    return copiados;
+}
+
+bool decompress_buffer(string_view comprimido, Compressao formato, string &saida, string &erro)
+{
+    unique_ptr<Descompressor> d(criar_descompressor(formato, erro));
+    if (d == nullptr)
+        return false;
+
+    saida.clear();
+    const char *entrada = comprimido.data();
+    size_t n_entrada = comprimido.size();
+    size_t usados = 0;
+    while (n_entrada > 0 || d->incompleto())
+    {
+        if (saida.size() - usados < 64 * 1024)
+            saida.resize(max<size_t>(2 * saida.size(), usados + 64 * 1024));
+        size_t n_saida = saida.size() - usados;
+        bool sem_entrada = n_entrada == 0;
+        if (!d->passo(entrada, n_entrada, &saida[usados], n_saida, erro))
+            return false;
+        usados += n_saida;
+        if (sem_entrada && n_saida == 0)
+        {
+            erro = string("entrada ") + compression_name(formato) + " truncada";
+            return false;
+        }
+    }
+    saida.resize(usados);
+    return true;
+}
+
+bool read_input_file(const string &caminho, string &texto, Compressao &formato, string &erro)
+{
+    ifstream arquivo(caminho, ios::binary);
+    if (!arquivo.is_open())
+    {
+        erro = "Erro ao abrir arquivo: " + caminho;
+        return false;
+    }
+    stringstream ss;
+    ss << arquivo.rdbuf();
+    texto = ss.str();
+
+    formato = detect_compression(texto.data(), texto.size());
+    if (formato == SEM_COMPRESSAO)
+        return true;
+    string comprimido = move(texto);
+    if (!decompress_buffer(comprimido, formato, texto, erro))
+    {
+        erro = caminho + ": " + erro;
+        return false;
+    }
+    return true;
+}
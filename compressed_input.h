@@ -0,0 +1,103 @@
+/*
+ * Trabalho de Compiladores - Entrada Comprimida
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo define a leitura transparente de entradas comprimidas. O
+ * formato é reconhecido pelos primeiros bytes (gzip: 1f 8b; zstd: 28 b5 2f
+ * fd), não pela extensão, e vários membros gzip ou quadros zstd seguidos
+ * são lidos como um só texto. O gzip usa a zlib; o zstd só é compilado com
+ * -DUSE_ZSTD (e -lzstd), e sem ele uma entrada zstd é recusada com uma
+ * mensagem.
+ *
+ * O DecompressingReader descomprime em uma thread auxiliar: ela lê o
+ * arquivo comprimido do descritor e preenche blocos de tamanho fixo, que
+ * passam para quem lê por uma SpscRing. Os blocos vazios voltam por outra.
+ * Assim a descompressão do próximo bloco acontece enquanto o lexer consome o
+ * atual, e a memória usada não depende do tamanho do arquivo. É o que o
+ * StreamInput usa quando a entrada padrão ou um arquivo do --check vem
+ * comprimido; os outros modos descomprimem o arquivo inteiro
+ * (read_input_file).
+ *
+ * Data: Outubro de 2026
+ */
+
+#ifndef COMPRESSED_INPUT_H
+#define COMPRESSED_INPUT_H
+
+#include "spsc_ring.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+enum Compressao
+{
+    SEM_COMPRESSAO,
+    GZIP,
+    ZSTD
+};
+
+// Pelo início do conteúdo (bastam 4 bytes)
+Compressao detect_compression(const char *dados, size_t n);
+const char *compression_name(Compressao formato);
+
+class DecompressingReader
+{
+public:
+    // prefixo: bytes do início do arquivo que já foram lidos do descritor
+    // (os usados para reconhecer o formato)
+    DecompressingReader(int fd, Compressao formato, string prefixo, size_t tamanho_bloco = 64 * 1024,
+                        size_t num_blocos = 4);
+    ~DecompressingReader();
+    DecompressingReader(const DecompressingReader &) = delete;
+    DecompressingReader &operator=(const DecompressingReader &) = delete;
+
+    // Copia até n bytes descomprimidos; 0 no fim da entrada ou em erro
+    size_t read(char *destino, size_t n);
+
+    // Vazio se a entrada terminou bem ou se a descompressão ainda não acabou
+    string error() const { return terminou.load(memory_order_acquire) ? erro : string(); }
+
+private:
+    struct Pedaco
+    {
+        uint32_t bloco;
+        uint32_t tamanho;
+    };
+
+    int fd;
+    Compressao formato;
+    string prefixo;
+    size_t tamanho_bloco;
+    vector<vector<char>> blocos;
+    SpscRing<Pedaco> cheios;   // thread auxiliar -> leitor
+    SpscRing<uint32_t> livres; // leitor -> thread auxiliar
+    thread auxiliar;
+    atomic<bool> terminou{false};  // a thread publicou o último bloco
+    atomic<bool> cancelado{false}; // o leitor foi destruído antes do fim
+    string erro;                   // escrito antes de terminou (release)
+
+    // Bloco sendo lido
+    Pedaco atual{0, 0};
+    size_t posicao = 0;
+    bool tem_atual = false;
+
+    void descomprimir();
+};
+
+// Descomprime um conteúdo inteiro em memória (saida é reaproveitada)
+bool decompress_buffer(string_view comprimido, Compressao formato, string &saida, string &erro);
+
+// Lê o arquivo inteiro, descomprimindo se o conteúdo for gzip ou zstd
+bool read_input_file(const string &caminho, string &texto, Compressao &formato, string &erro);
+
+#endif // COMPRESSED_INPUT_H
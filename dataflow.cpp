@@ -0,0 +1,300 @@
+/*
+ * Trabalho de Compiladores - Análise de Fluxo de Dados
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo implementa os vetores de bits, o resolvedor com lista de
+ * trabalho e as análises de atribuição definida e vivacidade.
+ *
+ * Data: Outubro de 2026
+ */
+
+#include "dataflow.h"
+#include <algorithm>
+#include <deque>
+
+// ==========================
+// Vetor de bits
+// ==========================
+
+BitVector::BitVector(size_t bits, bool valor) : bits(bits), palavras((bits + 63) / 64, 0)
+{
+    if (valor)
+        fill(true);
+}
+
+void BitVector::fill(bool valor)
+{
+    std::fill(palavras.begin(), palavras.end(), valor ? ~uint64_t(0) : 0);
+    if (valor && bits % 64 != 0)
+        palavras.back() = (uint64_t(1) << (bits % 64)) - 1;
+}
+
+// Os laços abaixo são sobre palavras inteiras e sem dependência entre
+// iterações, para o compilador usar registradores SIMD
+
+bool BitVector::unir(const BitVector &outro)
+{
+    uint64_t *__restrict a = palavras.data();
+    const uint64_t *__restrict b = outro.palavras.data();
+    uint64_t mudou = 0;
+    for (size_t w = 0; w < palavras.size(); w++)
+    {
+        uint64_t novo = a[w] | b[w];
+        mudou |= novo ^ a[w];
+        a[w] = novo;
+    }
+    return mudou != 0;
+}
+
+bool BitVector::intersectar(const BitVector &outro)
+{
+    uint64_t *__restrict a = palavras.data();
+    const uint64_t *__restrict b = outro.palavras.data();
+    uint64_t mudou = 0;
+    for (size_t w = 0; w < palavras.size(); w++)
+    {
+        uint64_t novo = a[w] & b[w];
+        mudou |= novo ^ a[w];
+        a[w] = novo;
+    }
+    return mudou != 0;
+}
+
+void BitVector::subtrair(const BitVector &outro)
+{
+    uint64_t *__restrict a = palavras.data();
+    const uint64_t *__restrict b = outro.palavras.data();
+    for (size_t w = 0; w < palavras.size(); w++)
+        a[w] &= ~b[w];
+}
+
+bool BitVector::transferir(const BitVector &entrada, const BitVector &gen, const BitVector &kill)
+{
+    uint64_t *__restrict a = palavras.data();
+    const uint64_t *__restrict e = entrada.palavras.data();
+    const uint64_t *__restrict g = gen.palavras.data();
+    const uint64_t *__restrict k = kill.palavras.data();
+    uint64_t mudou = 0;
+    for (size_t w = 0; w < palavras.size(); w++)
+    {
+        uint64_t novo = g[w] | (e[w] & ~k[w]);
+        mudou |= novo ^ a[w];
+        a[w] = novo;
+    }
+    return mudou != 0;
+}
+
+size_t BitVector::count() const
+{
+    size_t total = 0;
+    for (uint64_t p : palavras)
+        total += __builtin_popcountll(p);
+    return total;
+}
+
+// ==========================
+// Resolvedor
+// ==========================
+
+// Pós-ordem reversa a partir da entrada; os blocos inalcançáveis vão no fim
+static vector<int> ordem_reversa(const vector<vector<int>> &sucessores)
+{
+    size_t n = sucessores.size();
+    vector<int> ordem;
+    vector<char> visitado(n, 0);
+    vector<pair<int, size_t>> dfs;
+    if (n > 0)
+    {
+        dfs.push_back({0, 0});
+        visitado[0] = 1;
+    }
+    while (!dfs.empty())
+    {
+        int b = dfs.back().first;
+        size_t proximo = dfs.back().second++;
+        if (proximo < sucessores[b].size())
+        {
+            int s = sucessores[b][proximo];
+            if (!visitado[s])
+            {
+                visitado[s] = 1;
+                dfs.push_back({s, 0});
+            }
+            continue;
+        }
+        ordem.push_back(b);
+        dfs.pop_back();
+    }
+    reverse(ordem.begin(), ordem.end());
+    for (size_t b = 0; b < n; b++)
+        if (!visitado[b])
+            ordem.push_back(b);
+    return ordem;
+}
+
+DataflowResult solve_dataflow(const IRFunction &f, const DataflowProblem &problema)
+{
+    size_t n = f.blocos.size();
+    vector<vector<int>> sucessores(n), predecessores(n);
+    for (size_t b = 0; b < n; b++)
+    {
+        sucessores[b] = f.sucessores(b);
+        for (int s : sucessores[b])
+            predecessores[s].push_back(b);
+    }
+
+    bool frente = problema.direcao == Direcao::FRENTE;
+    bool intersecao = problema.juncao == Juncao::INTERSECAO;
+    DataflowResult r;
+    r.entrada.assign(n, BitVector(problema.bits, intersecao));
+    r.saida.assign(n, BitVector(problema.bits, intersecao));
+
+    // Para trás: mesmo esquema com as arestas invertidas
+    const auto &anteriores = frente ? predecessores : sucessores;
+    const auto &seguintes = frente ? sucessores : predecessores;
+    auto &antes = frente ? r.entrada : r.saida;
+    auto &depois = frente ? r.saida : r.entrada;
+
+    vector<int> ordem = ordem_reversa(sucessores);
+    if (!frente)
+        reverse(ordem.begin(), ordem.end());
+    deque<int> lista(ordem.begin(), ordem.end());
+    vector<char> na_lista(n, 1);
+
+    BitVector juntado(problema.bits);
+    while (!lista.empty())
+    {
+        int b = lista.front();
+        lista.pop_front();
+        na_lista[b] = 0;
+        r.avaliacoes++;
+
+        // Entrada da função (ou bloco de saída, para trás): o contorno entra
+        // na junção como uma aresta a mais
+        bool borda = frente ? b == 0 : anteriores[b].empty();
+        if (borda || !anteriores[b].empty())
+        {
+            juntado = borda ? problema.contorno : depois[anteriores[b][0]];
+            for (size_t i = borda ? 0 : 1; i < anteriores[b].size(); i++)
+            {
+                if (intersecao)
+                    juntado.intersectar(depois[anteriores[b][i]]);
+                else
+                    juntado.unir(depois[anteriores[b][i]]);
+            }
+            antes[b] = juntado;
+        }
+
+        if (depois[b].transferir(antes[b], problema.gen[b], problema.kill[b]))
+            for (int s : seguintes[b])
+                if (!na_lista[s])
+                {
+                    na_lista[s] = 1;
+                    lista.push_back(s);
+                }
+    }
+    return r;
+}
+
+// ==========================
+// Clientes
+// ==========================
+
+// Chama f(id) para cada variável lida pela instrução
+template <typename F>
+static void leituras(const Instr &instr, F f)
+{
+    if (instr.a.tipo == Operando::VAR)
+        f(instr.a.valor);
+    if (instr.b.tipo == Operando::VAR)
+        f(instr.b.valor);
+    for (const Operando &arg : instr.args)
+        if (arg.tipo == Operando::VAR)
+            f(arg.valor);
+}
+
+DataflowResult definite_assignment(const IRFunction &f)
+{
+    DataflowProblem p;
+    p.direcao = Direcao::FRENTE;
+    p.juncao = Juncao::INTERSECAO;
+    p.bits = f.vars.size();
+    p.gen.assign(f.blocos.size(), BitVector(p.bits));
+    p.kill.assign(f.blocos.size(), BitVector(p.bits));
+    p.contorno = BitVector(p.bits);
+    for (int i = 0; i < f.num_params; i++)
+        p.contorno.set(i);
+
+    for (size_t b = 0; b < f.blocos.size(); b++)
+        for (const Instr &instr : f.blocos[b].instrs)
+            if (instr.dest != -1)
+                p.gen[b].set(instr.dest);
+    return solve_dataflow(f, p);
+}
+
+DataflowResult liveness(const IRFunction &f)
+{
+    DataflowProblem p;
+    p.direcao = Direcao::TRAS;
+    p.juncao = Juncao::UNIAO;
+    p.bits = f.vars.size();
+    p.gen.assign(f.blocos.size(), BitVector(p.bits));
+    p.kill.assign(f.blocos.size(), BitVector(p.bits));
+    p.contorno = BitVector(p.bits);
+
+    // gen = lidas antes de serem definidas no bloco; kill = definidas
+    for (size_t b = 0; b < f.blocos.size(); b++)
+        for (const Instr &instr : f.blocos[b].instrs)
+        {
+            leituras(instr, [&](int v)
+                     {
+                         if (!p.kill[b].test(v))
+                             p.gen[b].set(v);
+                     });
+            if (instr.dest != -1)
+                p.kill[b].set(instr.dest);
+        }
+    return solve_dataflow(f, p);
+}
+
+vector<LeituraSemAtribuicao> check_definite_assignment(const IRProgram &ir)
+{
+    vector<LeituraSemAtribuicao> resultado;
+    for (const IRFunction &f : ir.funcoes)
+    {
+        DataflowResult r = definite_assignment(f);
+        BitVector reportadas(f.vars.size());
+        size_t inicio = resultado.size();
+        for (size_t b = 0; b < f.blocos.size(); b++)
+        {
+            BitVector &atribuidas = r.entrada[b]; // não é mais usado depois
+            for (const Instr &instr : f.blocos[b].instrs)
+            {
+                leituras(instr, [&](int v)
+                         {
+                             if (f.temporario[v] || atribuidas.test(v) || reportadas.test(v))
+                                 return;
+                             reportadas.set(v);
+                             resultado.push_back({f.nome, f.vars[v], instr.token});
+                         });
+                if (instr.dest != -1)
+                    atribuidas.set(instr.dest);
+            }
+        }
+
+        // Na ordem do código, não na dos blocos
+        stable_sort(resultado.begin() + inicio, resultado.end(),
+                    [](const LeituraSemAtribuicao &a, const LeituraSemAtribuicao &b)
+                    {
+                        size_t oa = a.token != nullptr ? a.token->offset : 0;
+                        size_t ob = b.token != nullptr ? b.token->offset : 0;
+                        return oa < ob;
+                    });
+    }
+    return resultado;
+}
@@ -0,0 +1,119 @@
+/*
+ * Trabalho de Compiladores - Análise de Fluxo de Dados
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo define o framework de fluxo de dados sobre o grafo de blocos
+ * básicos da IR: conjuntos como vetores de bits densos (operações feitas
+ * palavra a palavra, 64 variáveis por vez, em laços que o compilador
+ * vetoriza), um problema descrito por gen/kill por bloco, direção e junção,
+ * e um resolvedor com lista de trabalho. Os clientes são a atribuição
+ * definida (leitura de variável que pode não ter sido atribuída em algum
+ * caminho) e a vivacidade, usada pela eliminação de atribuições mortas.
+ *
+ * Data: Outubro de 2026
+ */
+
+#ifndef DATAFLOW_H
+#define DATAFLOW_H
+
+#include "ir.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class BitVector
+{
+public:
+    explicit BitVector(size_t bits = 0, bool valor = false);
+
+    size_t size() const { return bits; }
+    bool test(size_t i) const { return (palavras[i >> 6] >> (i & 63)) & 1; }
+    void set(size_t i) { palavras[i >> 6] |= uint64_t(1) << (i & 63); }
+    void reset(size_t i) { palavras[i >> 6] &= ~(uint64_t(1) << (i & 63)); }
+    void fill(bool valor);
+
+    // Retornam true se o conjunto mudou
+    bool unir(const BitVector &outro);
+    bool intersectar(const BitVector &outro);
+    void subtrair(const BitVector &outro);
+    // this = gen ∪ (entrada - kill); true se mudou
+    bool transferir(const BitVector &entrada, const BitVector &gen, const BitVector &kill);
+
+    size_t count() const;
+    bool operator==(const BitVector &outro) const { return palavras == outro.palavras; }
+    bool operator!=(const BitVector &outro) const { return palavras != outro.palavras; }
+
+    // Chama f(i) para cada bit ligado, em ordem crescente
+    template <typename F>
+    void for_each(F f) const
+    {
+        for (size_t w = 0; w < palavras.size(); w++)
+            for (uint64_t p = palavras[w]; p != 0; p &= p - 1)
+                f(w * 64 + __builtin_ctzll(p));
+    }
+
+private:
+    size_t bits;
+    vector<uint64_t> palavras; // bits além de size() ficam sempre desligados
+};
+
+enum class Direcao
+{
+    FRENTE,
+    TRAS
+};
+
+enum class Juncao
+{
+    UNIAO,     // "em algum caminho"
+    INTERSECAO // "em todos os caminhos"
+};
+
+struct DataflowProblem
+{
+    Direcao direcao = Direcao::FRENTE;
+    Juncao juncao = Juncao::UNIAO;
+    size_t bits = 0;
+    vector<BitVector> gen, kill; // um por bloco
+    // Valor na entrada da função (FRENTE) ou na saída dos blocos sem
+    // sucessores (TRAS)
+    BitVector contorno;
+};
+
+struct DataflowResult
+{
+    vector<BitVector> entrada, saida; // por bloco, no início e no fim dele
+    int avaliacoes = 0;               // blocos processados pela lista de trabalho
+};
+
+// Resolve o problema até o ponto fixo. Blocos sem caminho desde a entrada
+// ficam com o valor inicial (tudo ligado na interseção, nada na união).
+DataflowResult solve_dataflow(const IRFunction &f, const DataflowProblem &problema);
+
+// Variáveis com certeza atribuídas no início/fim de cada bloco (parâmetros
+// contam como atribuídos na entrada)
+DataflowResult definite_assignment(const IRFunction &f);
+
+// Variáveis vivas no início/fim de cada bloco
+DataflowResult liveness(const IRFunction &f);
+
+struct LeituraSemAtribuicao
+{
+    string funcao;
+    string var;
+    Token *token; // comando onde a leitura acontece (pode ser nulo)
+};
+
+// Leituras de variáveis (não temporários) que podem acontecer antes de
+// qualquer atribuição em algum caminho; uma por variável e função, na
+// primeira leitura. Deve rodar na IR recém-gerada, antes das otimizações.
+vector<LeituraSemAtribuicao> check_definite_assignment(const IRProgram &ir);
+
+#endif // DATAFLOW_H
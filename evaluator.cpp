@@ -0,0 +1,389 @@
+/*
+ * Trabalho de Compiladores - Execução da IR
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo implementa a conversão da IR para uma forma plana (desvios
+ * como índices de instrução, chamadas resolvidas para índices de função), o
+ * laço de execução com pilha de quadros própria e a cache de memoização.
+ *
+ * Data: Outubro de 2026
+ */
+
+#include "evaluator.h"
+#include "callgraph.h"
+#include <algorithm>
+#include <unordered_map>
+
+// ==========================
+// Forma plana da IR
+// ==========================
+
+// Constante ou índice da variável no quadro; Operando::NENHUM vira a constante 0
+struct OperandoExec
+{
+    bool cte = true;
+    int valor = 0;
+};
+
+struct InstrExec
+{
+    IROp op;
+    Tag binop = UNK;
+    int dest = -1;
+    OperandoExec a, b;
+    int funcao = -1;                   // IR_CALL: índice da função (-1 se não definida)
+    uint32_t args = 0, num_args = 0;   // IR_CALL: faixa em ProgramaExec::args
+    uint32_t alvo = 0, alvo_senao = 0; // IR_JMP / IR_BR: índices em ProgramaExec::instrs
+    const Instr *origem = nullptr;
+};
+
+struct FuncaoExec
+{
+    uint32_t inicio = 0; // primeira instrução do bloco de entrada
+    int num_vars = 0;
+    int num_params = 0;
+    bool pura = false;
+};
+
+struct ProgramaExec
+{
+    vector<InstrExec> instrs;
+    vector<OperandoExec> args;
+    vector<FuncaoExec> funcoes;
+    int aridade_pura = 0; // maior número de parâmetros de uma função pura
+};
+
+static OperandoExec converter(const Operando &op)
+{
+    OperandoExec o;
+    if (op.tipo == Operando::VAR)
+        o.cte = false;
+    if (op.tipo != Operando::NENHUM)
+        o.valor = op.valor;
+    return o;
+}
+
+static ProgramaExec aplanar(const IRProgram &ir, const vector<char> &pura)
+{
+    ProgramaExec p;
+    unordered_map<string, int> indices;
+    for (size_t i = 0; i < ir.funcoes.size(); i++)
+        indices[ir.funcoes[i].nome] = i;
+
+    for (size_t i = 0; i < ir.funcoes.size(); i++)
+    {
+        const IRFunction &f = ir.funcoes[i];
+        FuncaoExec fe;
+        fe.inicio = p.instrs.size();
+        fe.num_vars = f.vars.size();
+        fe.num_params = f.num_params;
+        fe.pura = pura[i];
+        if (fe.pura)
+            p.aridade_pura = max(p.aridade_pura, f.num_params);
+        p.funcoes.push_back(fe);
+
+        // Os blocos ficam em sequência; o início de cada um resolve os desvios
+        vector<uint32_t> inicio_bloco(f.blocos.size());
+        uint32_t pos = fe.inicio;
+        for (size_t b = 0; b < f.blocos.size(); b++)
+        {
+            inicio_bloco[b] = pos;
+            pos += f.blocos[b].instrs.size();
+        }
+        for (const auto &bloco : f.blocos)
+            for (const Instr &instr : bloco.instrs)
+            {
+                InstrExec ie;
+                ie.op = instr.op;
+                ie.binop = instr.binop;
+                ie.dest = instr.dest;
+                ie.a = converter(instr.a);
+                ie.b = converter(instr.b);
+                ie.origem = &instr;
+                if (instr.op == IR_CALL)
+                {
+                    auto it = indices.find(instr.funcao);
+                    if (it != indices.end())
+                        ie.funcao = it->second;
+                    ie.args = p.args.size();
+                    ie.num_args = instr.args.size();
+                    for (const Operando &arg : instr.args)
+                        p.args.push_back(converter(arg));
+                }
+                if (instr.alvo != -1)
+                    ie.alvo = inicio_bloco[instr.alvo];
+                if (instr.alvo_senao != -1)
+                    ie.alvo_senao = inicio_bloco[instr.alvo_senao];
+                p.instrs.push_back(ie);
+            }
+    }
+    return p;
+}
+
+// ==========================
+// Cache de memoização
+// ==========================
+
+static const size_t VIAS = 4;
+
+class MemoCache
+{
+public:
+    MemoCache(size_t capacidade, int aridade) : aridade(aridade)
+    {
+        size_t n = VIAS;
+        while (n < capacidade)
+            n <<= 1;
+        entradas.resize(n);
+        chaves.resize(n * aridade);
+    }
+
+    static uint64_t hash(int funcao, const int *args, int n)
+    {
+        uint64_t h = 0x9E3779B97F4A7C15ull * (funcao + 1);
+        for (int i = 0; i < n; i++)
+            h = (h ^ static_cast<uint32_t>(args[i])) * 0xBF58476D1CE4E5B9ull;
+        h ^= h >> 31;
+        return h | 1; // 0 marca entrada vazia
+    }
+
+    bool buscar(uint64_t h, int funcao, const int *args, int n, int &resultado) const
+    {
+        size_t via0 = h & (entradas.size() - 1) & ~(VIAS - 1);
+        for (size_t v = via0; v < via0 + VIAS; v++)
+        {
+            const Entrada &e = entradas[v];
+            if (e.hash == h && e.funcao == funcao && equal(args, args + n, chaves.begin() + v * aridade))
+            {
+                resultado = e.resultado;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void guardar(uint64_t h, int funcao, const int *args, int n, int resultado)
+    {
+        size_t via0 = h & (entradas.size() - 1) & ~(VIAS - 1);
+        size_t v = via0;
+        while (v < via0 + VIAS && entradas[v].hash != 0)
+            v++;
+        if (v == via0 + VIAS)
+        {
+            // Vias cheias: a vítima sai de outros bits do hash
+            v = via0 + ((h >> 32) & (VIAS - 1));
+            substituicoes++;
+        }
+        else
+        {
+            ocupadas++;
+        }
+        entradas[v] = Entrada{h, funcao, resultado};
+        copy(args, args + n, chaves.begin() + v * aridade);
+    }
+
+    size_t capacidade() const { return entradas.size(); }
+
+    size_t ocupadas = 0;
+    uint64_t substituicoes = 0;
+
+private:
+    struct Entrada
+    {
+        uint64_t hash = 0;
+        int funcao = -1;
+        int resultado = 0;
+    };
+    vector<Entrada> entradas;
+    vector<int> chaves; // aridade argumentos por entrada
+    int aridade;
+};
+
+// ==========================
+// Execução
+// ==========================
+
+struct Quadro
+{
+    int funcao;
+    uint32_t pc;
+    uint32_t base;    // primeira variável em valores
+    int dest;         // variável de quem chamou que recebe o resultado (-1 = nenhuma)
+    uint32_t pendente; // chave em pendentes a guardar no retorno (SEM_CHAVE = nenhuma)
+    uint64_t hash;
+};
+
+static const uint32_t SEM_CHAVE = UINT32_MAX;
+static const size_t TAMANHO_BUFFER = 1 << 16;
+
+static inline int ler(const int *quadro, const OperandoExec &o)
+{
+    return o.cte ? o.valor : quadro[o.valor];
+}
+
+bool execute_program(const IRProgram &ir, const ExecOptions &opcoes, ostream &saida, ExecStats &stats,
+                     ErroExecucao &erro)
+{
+    stats = ExecStats();
+    vector<char> pura = analyze_purity(ir, build_call_graph(ir));
+    for (size_t i = 0; i < ir.funcoes.size(); i++)
+        if (pura[i] && !ir.funcoes[i].nome.empty())
+            stats.puras.push_back(ir.funcoes[i].nome);
+
+    int raiz = -1;
+    for (size_t i = 0; i < ir.funcoes.size() && raiz == -1; i++)
+        if (ir.funcoes[i].nome == "Main")
+            raiz = i;
+    for (size_t i = 0; i < ir.funcoes.size() && raiz == -1; i++)
+        if (ir.funcoes[i].nome.empty())
+            raiz = i;
+    if (raiz == -1)
+    {
+        erro = ErroExecucao{"o programa não tem a função Main", nullptr};
+        return false;
+    }
+
+    ProgramaExec p = aplanar(ir, pura);
+    MemoCache cache(opcoes.memoizar ? opcoes.capacidade_memo : 0, p.aridade_pura);
+    if (opcoes.memoizar)
+        stats.capacidade = cache.capacidade();
+
+    string buffer;
+    vector<int> valores(p.funcoes[raiz].num_vars, 0);
+    vector<int> argumentos, pendentes;
+    vector<Quadro> quadros = {Quadro{raiz, p.funcoes[raiz].inicio, 0, -1, SEM_CHAVE, 0}};
+    stats.profundidade_maxima = 1;
+
+    auto terminar = [&]()
+    {
+        saida << buffer;
+        stats.entradas = cache.ocupadas;
+        stats.substituicoes = cache.substituicoes;
+    };
+    auto falhar = [&](const InstrExec &in, const string &mensagem)
+    {
+        terminar();
+        erro = ErroExecucao{mensagem, in.origem->token};
+        return false;
+    };
+
+    while (true)
+    {
+        Quadro &q = quadros.back();
+        const InstrExec &in = p.instrs[q.pc];
+        int *v = valores.data() + q.base;
+        stats.instrucoes++;
+        switch (in.op)
+        {
+        case IR_COPY:
+            v[in.dest] = ler(v, in.a);
+            q.pc++;
+            break;
+        case IR_BIN:
+        {
+            int r;
+            if (!eval_binop(in.binop, ler(v, in.a), ler(v, in.b), r))
+                return falhar(in, ler(v, in.b) == 0 ? "divisão por zero" : "estouro na divisão");
+            v[in.dest] = r;
+            q.pc++;
+            break;
+        }
+        case IR_PRINT:
+            buffer += to_string(ler(v, in.a));
+            buffer += '\n';
+            if (buffer.size() >= TAMANHO_BUFFER)
+            {
+                saida << buffer;
+                buffer.clear();
+            }
+            q.pc++;
+            break;
+        case IR_JMP:
+            q.pc = in.alvo;
+            break;
+        case IR_BR:
+            q.pc = ler(v, in.a) != 0 ? in.alvo : in.alvo_senao;
+            break;
+        case IR_CALL:
+        {
+            if (in.funcao == -1)
+                return falhar(in, "função '" + in.origem->funcao + "' não foi definida");
+            const FuncaoExec &g = p.funcoes[in.funcao];
+            stats.chamadas++;
+            // Um parâmetro sem argumento vale 0, como uma variável não atribuída
+            argumentos.assign(g.num_params, 0);
+            for (int i = 0; i < g.num_params && i < (int)in.num_args; i++)
+                argumentos[i] = ler(v, p.args[in.args + i]);
+
+            uint32_t pendente = SEM_CHAVE;
+            uint64_t h = 0;
+            if (g.pura)
+            {
+                stats.chamadas_puras++;
+                if (opcoes.memoizar)
+                {
+                    int r;
+                    h = MemoCache::hash(in.funcao, argumentos.data(), g.num_params);
+                    if (cache.buscar(h, in.funcao, argumentos.data(), g.num_params, r))
+                    {
+                        stats.acertos++;
+                        if (in.dest != -1)
+                            v[in.dest] = r;
+                        q.pc++;
+                        break;
+                    }
+                    stats.falhas++;
+                    // Os parâmetros podem ser reatribuídos no corpo: a chave é guardada à parte
+                    pendente = pendentes.size();
+                    pendentes.insert(pendentes.end(), argumentos.begin(), argumentos.end());
+                }
+            }
+
+            if (quadros.size() >= opcoes.limite_profundidade)
+                return falhar(in, "mais de " + to_string(opcoes.limite_profundidade) + " chamadas ativas");
+            uint32_t base = valores.size();
+            valores.resize(base + g.num_vars, 0);
+            copy(argumentos.begin(), argumentos.end(), valores.begin() + base);
+            quadros.push_back(Quadro{in.funcao, g.inicio, base, in.dest, pendente, h});
+            stats.profundidade_maxima = max(stats.profundidade_maxima, quadros.size());
+            break;
+        }
+        case IR_RET:
+        {
+            int r = ler(v, in.a);
+            Quadro fim = q;
+            quadros.pop_back();
+            valores.resize(fim.base);
+            if (fim.pendente != SEM_CHAVE)
+            {
+                int n = pendentes.size() - fim.pendente;
+                cache.guardar(fim.hash, fim.funcao, pendentes.data() + fim.pendente, n, r);
+                pendentes.resize(fim.pendente);
+            }
+            if (quadros.empty())
+            {
+                terminar();
+                return true;
+            }
+            Quadro &chamador = quadros.back();
+            if (fim.dest != -1)
+                valores[chamador.base + fim.dest] = r;
+            chamador.pc++;
+            break;
+        }
+        }
+    }
+}
+
+string describe_exec_error(const ErroExecucao &e, const PositionResolver &linhas)
+{
+    string texto = "Erro de execução";
+    if (e.token != nullptr)
+        texto += " (" + linhas.describe(e.token->offset) + ")";
+    return texto + ": " + e.mensagem + ".";
+}
@@ -0,0 +1,75 @@
+/*
+ * Trabalho de Compiladores - Execução da IR
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo define o avaliador de referência da linguagem, que executa a
+ * IR a partir de Main (ou do programa sem funções). As variáveis são int de
+ * 32 bits com estouro em complemento de dois (a mesma eval_binop da dobra de
+ * constantes), uma variável lida antes de ser atribuída vale 0, um return
+ * sem valor devolve 0 e cada print escreve o valor e uma quebra de linha. Os
+ * quadros das chamadas ficam em uma pilha própria, então a profundidade da
+ * recursão é limitada por limite_profundidade, não pela pilha do processo.
+ *
+ * Com memoizar, as chamadas a funções puras (analyze_purity, em
+ * callgraph.h) passam por uma cache de tamanho fixo indexada pela função e
+ * pelos argumentos: um acerto devolve o resultado sem executar o corpo, e
+ * uma falha executa e guarda o resultado no retorno. A cache é uma tabela
+ * hash associativa de 4 vias; com as 4 vias ocupadas, uma delas é
+ * substituída.
+ *
+ * Data: Outubro de 2026
+ */
+
+#ifndef EVALUATOR_H
+#define EVALUATOR_H
+
+#include "ir.h"
+#include "line_index.h"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+struct ExecOptions
+{
+    bool memoizar = false;
+    size_t capacidade_memo = 1 << 16;     // entradas (arredondada para potência de 2)
+    size_t limite_profundidade = 1 << 20; // quadros de chamada ativos
+};
+
+struct ExecStats
+{
+    uint64_t instrucoes = 0; // instruções executadas
+    uint64_t chamadas = 0;   // inclusive as respondidas pela cache
+    uint64_t chamadas_puras = 0;
+    uint64_t acertos = 0;
+    uint64_t falhas = 0;
+    uint64_t substituicoes = 0; // entradas descartadas para dar lugar a outras
+    size_t entradas = 0;        // ocupadas ao final
+    size_t capacidade = 0;
+    size_t profundidade_maxima = 0;
+    vector<string> puras; // nomes das funções puras
+};
+
+struct ErroExecucao
+{
+    string mensagem;
+    Token *token = nullptr; // comando onde ocorreu (nullptr se não há)
+};
+
+// Executa o programa, escrevendo os prints em saida; false em erro de
+// execução (divisão por zero, recursão além do limite, programa sem Main)
+bool execute_program(const IRProgram &ir, const ExecOptions &opcoes, ostream &saida, ExecStats &stats,
+                     ErroExecucao &erro);
+
+// "Erro de execução (linha L, coluna C): divisão por zero."
+string describe_exec_error(const ErroExecucao &e, const PositionResolver &linhas);
+
+#endif // EVALUATOR_H
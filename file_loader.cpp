@@ -0,0 +1,559 @@
+/*
+ * Trabalho de Compiladores - Leitura de Arquivos em Lote
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo implementa o anel do io_uring direto sobre as chamadas de
+ * sistema (sem liburing), a máquina de estados de cada leitura em voo e o
+ * caminho alternativo com pread em um ThreadPool.
+ *
+ * Data: Outubro de 2026
+ */
+
+#include "file_loader.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fnmatch.h>
+#include <mutex>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#define TEM_IO_URING 1
+#endif
+
+const vector<string> PADROES_FONTE = {"*.txt", "*.txt.gz", "*.txt.zst"};
+
+static bool casa_algum(const string &nome, const vector<string> &padroes)
+{
+    for (const string &padrao : padroes)
+        if (fnmatch(padrao.c_str(), nome.c_str(), 0) == 0)
+            return true;
+    return false;
+}
+
+void expand_paths(const vector<string> &entradas, vector<string> &arquivos, const vector<string> &padroes)
+{
+    namespace fs = std::filesystem;
+    for (const string &entrada : entradas)
+    {
+        error_code ec;
+        if (!fs::is_directory(entrada, ec))
+        {
+            arquivos.push_back(entrada);
+            continue;
+        }
+        vector<string> achados;
+        for (auto it = fs::recursive_directory_iterator(entrada, ec); !ec && it != fs::recursive_directory_iterator();
+             it.increment(ec))
+        {
+            error_code ec_entrada; // entrada ilegível só fica de fora
+            string nome = it->path().filename().string();
+            if (nome[0] == '.')
+            {
+                if (it->is_directory(ec_entrada))
+                    it.disable_recursion_pending();
+                continue;
+            }
+            if (it->is_regular_file(ec_entrada) && casa_algum(nome, padroes))
+                achados.push_back(it->path().string());
+        }
+        sort(achados.begin(), achados.end());
+        arquivos.insert(arquivos.end(), achados.begin(), achados.end());
+    }
+}
+
+static string erro_abrir(const string &caminho)
+{
+    return "Erro ao abrir arquivo: " + caminho;
+}
+
+static string erro_ler(const string &caminho, int codigo)
+{
+    return "Erro ao ler arquivo: " + caminho + " (" + strerror(codigo) + ")";
+}
+
+// Leitura síncrona do arquivo inteiro, reaproveitando o buffer
+static bool ler_inteiro(const string &caminho, vector<char> &buffer, size_t &lidos, string &erro)
+{
+    lidos = 0;
+    int fd = open(caminho.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+    {
+        if (fd >= 0)
+            close(fd);
+        erro = erro_abrir(caminho);
+        return false;
+    }
+    size_t tamanho = st.st_size;
+    if (buffer.size() < tamanho)
+        buffer.resize(tamanho);
+    while (lidos < tamanho)
+    {
+        ssize_t r = pread(fd, buffer.data() + lidos, tamanho - lidos, lidos);
+        if (r < 0 && errno == EINTR)
+            continue;
+        if (r < 0)
+            erro = erro_ler(caminho, errno);
+        if (r <= 0)
+            break;
+        lidos += r;
+    }
+    close(fd);
+    return erro.empty();
+}
+
+// ==========================
+// io_uring
+// ==========================
+
+#ifdef TEM_IO_URING
+
+// Leituras em voo ao mesmo tempo, cada uma com seu buffer fixo
+static const unsigned VAGAS = 64;
+static const size_t TAM_BUFFER = 64 * 1024;
+// Por vaga, no máximo três entradas submetidas de uma vez
+static const unsigned ENTRADAS = 256;
+
+enum OperacaoAnel
+{
+    OP_ABRIR,
+    OP_STATX,
+    OP_LER,
+    OP_FECHAR
+};
+
+struct IoUring
+{
+    int fd = -1;
+    io_uring_params params;
+    void *sq_mapa = MAP_FAILED, *cq_mapa = MAP_FAILED;
+    size_t sq_tam = 0, cq_tam = 0;
+    io_uring_sqe *sqes = (io_uring_sqe *)MAP_FAILED;
+    unsigned *sq_head, *sq_tail, *sq_mask, *sq_array;
+    unsigned *cq_head, *cq_tail, *cq_mask;
+    io_uring_cqe *cqes;
+    unsigned tail_local = 0; // entradas preparadas, ainda não publicadas
+    unsigned a_submeter = 0;
+
+    char *buffers = (char *)MAP_FAILED; // VAGAS * TAM_BUFFER
+    bool registrados = false;           // buffers registrados: IORING_OP_READ_FIXED
+    bool encadeado = false;             // openat -> read -> close em uma cadeia
+
+    ~IoUring();
+    bool abrir();
+    io_uring_sqe *preparar(uint64_t dados);
+    bool enviar(unsigned esperar);
+};
+
+IoUring::~IoUring()
+{
+    if (buffers != MAP_FAILED)
+        munmap(buffers, (size_t)VAGAS * TAM_BUFFER);
+    if (sqes != MAP_FAILED)
+        munmap(sqes, params.sq_entries * sizeof(io_uring_sqe));
+    if (cq_mapa != MAP_FAILED && cq_mapa != sq_mapa)
+        munmap(cq_mapa, cq_tam);
+    if (sq_mapa != MAP_FAILED)
+        munmap(sq_mapa, sq_tam);
+    if (fd != -1)
+        close(fd);
+}
+
+bool IoUring::abrir()
+{
+    memset(&params, 0, sizeof(params));
+    fd = syscall(__NR_io_uring_setup, ENTRADAS, &params);
+    if (fd < 0)
+    {
+        fd = -1;
+        return false;
+    }
+
+    // Operações que o kernel precisa ter (openat, statx, read e close: 5.6)
+    vector<char> sonda(sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op), 0);
+    io_uring_probe *probe = reinterpret_cast<io_uring_probe *>(sonda.data());
+    if (syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe, 256) < 0)
+        return false;
+    for (int op : {IORING_OP_OPENAT, IORING_OP_STATX, IORING_OP_READ, IORING_OP_READ_FIXED, IORING_OP_CLOSE})
+        if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED))
+            return false;
+
+    sq_tam = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_tam = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool unico = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (unico)
+        sq_tam = cq_tam = max(sq_tam, cq_tam);
+    sq_mapa = mmap(nullptr, sq_tam, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (sq_mapa == MAP_FAILED)
+        return false;
+    cq_mapa = unico ? sq_mapa
+                    : mmap(nullptr, cq_tam, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+    if (cq_mapa == MAP_FAILED)
+        return false;
+    sqes = (io_uring_sqe *)mmap(nullptr, params.sq_entries * sizeof(io_uring_sqe), PROT_READ | PROT_WRITE,
+                                MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED)
+        return false;
+
+    char *sq = (char *)sq_mapa, *cq = (char *)cq_mapa;
+    sq_head = (unsigned *)(sq + params.sq_off.head);
+    sq_tail = (unsigned *)(sq + params.sq_off.tail);
+    sq_mask = (unsigned *)(sq + params.sq_off.ring_mask);
+    sq_array = (unsigned *)(sq + params.sq_off.array);
+    cq_head = (unsigned *)(cq + params.cq_off.head);
+    cq_tail = (unsigned *)(cq + params.cq_off.tail);
+    cq_mask = (unsigned *)(cq + params.cq_off.ring_mask);
+    cqes = (io_uring_cqe *)(cq + params.cq_off.cqes);
+    tail_local = *sq_tail;
+    // A posição i do anel sempre aponta para a entrada i
+    for (unsigned i = 0; i < params.sq_entries; i++)
+        sq_array[i] = i;
+
+    buffers = (char *)mmap(nullptr, (size_t)VAGAS * TAM_BUFFER, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1,
+                           0);
+    if (buffers == MAP_FAILED)
+        return false;
+    // Sem registro (ex.: RLIMIT_MEMLOCK baixo) os mesmos buffers servem ao IORING_OP_READ
+    vector<iovec> iovs(VAGAS);
+    for (unsigned i = 0; i < VAGAS; i++)
+        iovs[i] = {buffers + (size_t)i * TAM_BUFFER, TAM_BUFFER};
+    registrados = syscall(__NR_io_uring_register, fd, IORING_REGISTER_BUFFERS, iovs.data(), VAGAS) == 0;
+
+    // A cadeia precisa que o read encontre o arquivo que o openat acabou de
+    // colocar na tabela, o que só vale com IORING_FEAT_LINKED_FILE
+    if (params.features & IORING_FEAT_LINKED_FILE)
+    {
+        vector<int> vazios(VAGAS, -1);
+        encadeado = syscall(__NR_io_uring_register, fd, IORING_REGISTER_FILES, vazios.data(), VAGAS) == 0;
+    }
+    return true;
+}
+
+io_uring_sqe *IoUring::preparar(uint64_t dados)
+{
+    // O anel tem espaço para tudo que as vagas podem pedir de uma vez
+    io_uring_sqe *sqe = &sqes[tail_local & *sq_mask];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->user_data = dados;
+    tail_local++;
+    a_submeter++;
+    return sqe;
+}
+
+// Publica as entradas preparadas e espera por pelo menos "esperar" conclusões
+bool IoUring::enviar(unsigned esperar)
+{
+    __atomic_store_n(sq_tail, tail_local, __ATOMIC_RELEASE);
+    while (true)
+    {
+        int r = syscall(__NR_io_uring_enter, fd, a_submeter, esperar, esperar > 0 ? IORING_ENTER_GETEVENTS : 0,
+                        nullptr, 0);
+        if (r >= 0)
+        {
+            a_submeter -= min<unsigned>(r, a_submeter);
+            if (a_submeter == 0 || esperar > 0)
+                return true;
+            continue;
+        }
+        if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+            return false;
+    }
+}
+
+// Estado de cada vaga. Com IORING_FEAT_LINKED_FILE (5.17) cada arquivo é
+// uma única cadeia openat -> read -> close sobre a posição v da tabela de
+// arquivos registrados, que o kernel costuma executar inteira dentro do
+// io_uring_enter quando os dados estão no cache; arquivos que enchem o
+// buffer fixo são relidos inteiros no fim. Sem isso, openat e statx vão
+// juntos e a leitura (do tamanho certo) só é submetida quando os dois voltam.
+struct Leitura
+{
+    size_t arquivo;
+    int fd;        // sem cadeia; -1 se não abriu
+    bool abriu;    // com cadeia
+    int pendentes; // respostas que faltam antes de decidir o próximo passo
+    int erro;      // errno da primeira falha
+    struct statx info;
+    char *destino;
+    size_t tamanho, lidos;
+    vector<char> grande; // arquivos que não cabem no buffer fixo
+};
+
+static uint64_t dados_sqe(unsigned vaga, OperacaoAnel op)
+{
+    return (uint64_t)vaga << 2 | op;
+}
+
+void FileLoader::load_uring(const vector<string> &caminhos,
+                            const function<void(size_t, string_view, const string &)> &consumir)
+{
+    IoUring &r = *anel;
+    vector<Leitura> vagas(VAGAS);
+    vector<unsigned> livres;
+    for (unsigned v = VAGAS; v-- > 0;)
+        livres.push_back(v);
+    size_t proximo = 0, fechando = 0;
+
+    auto buffer_fixo = [&](unsigned v) { return r.buffers + (size_t)v * TAM_BUFFER; };
+    auto ler = [&](unsigned v)
+    {
+        Leitura &l = vagas[v];
+        size_t resta = min(l.tamanho - l.lidos, (size_t)1 << 30);
+        bool fixo = r.registrados && l.destino == buffer_fixo(v);
+        io_uring_sqe *sqe = r.preparar(dados_sqe(v, OP_LER));
+        sqe->opcode = fixo ? IORING_OP_READ_FIXED : IORING_OP_READ;
+        sqe->fd = l.fd;
+        sqe->addr = (uint64_t)(l.destino + l.lidos);
+        sqe->len = resta;
+        sqe->off = l.lidos;
+        if (fixo)
+            sqe->buf_index = v;
+    };
+    auto terminar = [&](unsigned v)
+    {
+        Leitura &l = vagas[v];
+        string erro;
+        if (l.erro == 0 && r.encadeado && l.lidos == TAM_BUFFER)
+        {
+            ler_inteiro(caminhos[l.arquivo], l.grande, l.lidos, erro); // pode ser maior que o buffer
+            l.destino = l.grande.data();
+        }
+        else if (l.erro != 0)
+        {
+            bool abriu = r.encadeado ? l.abriu : l.fd >= 0;
+            erro = !abriu || l.erro == EISDIR ? erro_abrir(caminhos[l.arquivo]) : erro_ler(caminhos[l.arquivo], l.erro);
+        }
+        consumir(l.arquivo, erro.empty() ? string_view(l.destino, l.lidos) : string_view(), erro);
+        if (!r.encadeado && l.fd >= 0)
+        {
+            io_uring_sqe *sqe = r.preparar(dados_sqe(v, OP_FECHAR));
+            sqe->opcode = IORING_OP_CLOSE;
+            sqe->fd = l.fd;
+            fechando++;
+        }
+        vector<char>().swap(l.grande);
+        livres.push_back(v);
+    };
+    // Sem cadeia: openat e statx terminaram, escolhe o buffer e começa a ler
+    auto comecar = [&](unsigned v)
+    {
+        Leitura &l = vagas[v];
+        if (l.erro == 0 && !S_ISREG(l.info.stx_mode))
+            l.erro = EISDIR;
+        if (l.erro != 0)
+            return terminar(v);
+        l.tamanho = l.info.stx_size;
+        l.lidos = 0;
+        if (l.tamanho > TAM_BUFFER)
+        {
+            l.grande.resize(l.tamanho);
+            l.destino = l.grande.data();
+        }
+        if (l.tamanho == 0)
+            return terminar(v);
+        ler(v);
+    };
+    auto iniciar = [&](unsigned v, size_t arquivo)
+    {
+        Leitura &l = vagas[v];
+        l.arquivo = arquivo;
+        l.fd = -1;
+        l.abriu = false;
+        l.erro = 0;
+        l.lidos = 0;
+        l.destino = buffer_fixo(v);
+        const char *caminho = caminhos[arquivo].c_str();
+
+        io_uring_sqe *sqe = r.preparar(dados_sqe(v, OP_ABRIR));
+        sqe->opcode = IORING_OP_OPENAT;
+        sqe->fd = AT_FDCWD;
+        sqe->addr = (uint64_t)caminho;
+        sqe->open_flags = O_RDONLY | O_CLOEXEC;
+        if (!r.encadeado)
+        {
+            l.pendentes = 2;
+            sqe = r.preparar(dados_sqe(v, OP_STATX));
+            sqe->opcode = IORING_OP_STATX;
+            sqe->fd = AT_FDCWD;
+            sqe->addr = (uint64_t)caminho;
+            sqe->len = STATX_TYPE | STATX_SIZE;
+            sqe->off = (uint64_t)&l.info;
+            return;
+        }
+
+        // Se o openat falha, read e close voltam com -ECANCELED; o close
+        // roda mesmo se a leitura for curta (HARDLINK). Na tabela de
+        // registrados não existe O_CLOEXEC (o kernel recusa com EINVAL)
+        l.pendentes = 3;
+        l.tamanho = TAM_BUFFER;
+        sqe->open_flags = O_RDONLY;
+        sqe->file_index = v + 1;
+        sqe->flags = IOSQE_IO_LINK;
+        sqe = r.preparar(dados_sqe(v, OP_LER));
+        sqe->opcode = r.registrados ? IORING_OP_READ_FIXED : IORING_OP_READ;
+        sqe->fd = v;
+        sqe->flags = IOSQE_FIXED_FILE | IOSQE_IO_HARDLINK;
+        sqe->addr = (uint64_t)l.destino;
+        sqe->len = TAM_BUFFER;
+        sqe->buf_index = r.registrados ? v : 0;
+        sqe = r.preparar(dados_sqe(v, OP_FECHAR));
+        sqe->opcode = IORING_OP_CLOSE;
+        sqe->file_index = v + 1;
+    };
+    auto responder_encadeado = [&](unsigned v, OperacaoAnel op, int res)
+    {
+        Leitura &l = vagas[v];
+        if (op == OP_ABRIR && res >= 0)
+            l.abriu = true;
+        else if (op == OP_LER && res >= 0)
+            l.lidos = res;
+        else if (op != OP_FECHAR && res != -ECANCELED && l.erro == 0)
+            l.erro = -res;
+        if (--l.pendentes == 0)
+            terminar(v);
+    };
+    auto responder = [&](unsigned v, OperacaoAnel op, int res)
+    {
+        Leitura &l = vagas[v];
+        switch (op)
+        {
+        case OP_ABRIR:
+        case OP_STATX:
+            if (op == OP_ABRIR && res >= 0)
+                l.fd = res;
+            else if (res < 0 && l.erro == 0)
+                l.erro = -res;
+            if (--l.pendentes == 0)
+                comecar(v);
+            break;
+        case OP_LER:
+            if (res < 0 && res != -EINTR && res != -EAGAIN)
+                l.erro = -res;
+            else if (res == 0)
+                l.tamanho = l.lidos; // diminuiu depois do statx
+            else if (res > 0)
+                l.lidos += res;
+            if (l.erro != 0 || l.lidos == l.tamanho)
+                terminar(v);
+            else
+                ler(v);
+            break;
+        case OP_FECHAR:
+            fechando--;
+            break;
+        }
+    };
+
+    while (proximo < caminhos.size() || livres.size() < VAGAS || fechando > 0)
+    {
+        while (!livres.empty() && proximo < caminhos.size())
+        {
+            unsigned v = livres.back();
+            livres.pop_back();
+            iniciar(v, proximo++);
+        }
+        if (!r.enviar(1))
+            throw runtime_error(string("io_uring_enter: ") + strerror(errno));
+
+        unsigned head = *r.cq_head;
+        unsigned tail = __atomic_load_n(r.cq_tail, __ATOMIC_ACQUIRE);
+        for (; head != tail; head++)
+        {
+            const io_uring_cqe &cqe = r.cqes[head & *r.cq_mask];
+            unsigned v = cqe.user_data >> 2;
+            OperacaoAnel op = (OperacaoAnel)(cqe.user_data & 3);
+            if (r.encadeado)
+                responder_encadeado(v, op, cqe.res);
+            else
+                responder(v, op, cqe.res);
+        }
+        __atomic_store_n(r.cq_head, head, __ATOMIC_RELEASE);
+    }
+}
+
+#else
+
+struct IoUring
+{
+};
+
+void FileLoader::load_uring(const vector<string> &, const function<void(size_t, string_view, const string &)> &)
+{
+}
+
+#endif
+
+// ==========================
+// pread em threads
+// ==========================
+
+void FileLoader::load_pread(const vector<string> &caminhos,
+                            const function<void(size_t, string_view, const string &)> &consumir)
+{
+    mutex trava;
+    pool->parallel_for(caminhos.size(), [&](size_t i)
+                       {
+                           thread_local vector<char> buffer;
+                           string erro;
+                           size_t lidos;
+                           ler_inteiro(caminhos[i], buffer, lidos, erro);
+                           lock_guard<mutex> g(trava);
+                           consumir(i, erro.empty() ? string_view(buffer.data(), lidos) : string_view(), erro);
+                       });
+}
+
+// ==========================
+// FileLoader
+// ==========================
+
+FileLoader::FileLoader(Modo modo, size_t threads) : threads(threads)
+{
+#ifdef TEM_IO_URING
+    if (modo == AUTOMATICO)
+    {
+        anel = new IoUring();
+        if (!anel->abrir())
+        {
+            delete anel;
+            anel = nullptr;
+        }
+    }
+#else
+    (void)modo;
+#endif
+    if (anel == nullptr)
+        pool = new ThreadPool(threads);
+}
+
+FileLoader::~FileLoader()
+{
+    delete anel;
+    delete pool;
+}
+
+void FileLoader::load(const vector<string> &caminhos,
+                      const function<void(size_t, string_view, const string &)> &consumir)
+{
+    if (anel != nullptr)
+        load_uring(caminhos, consumir);
+    else
+        load_pread(caminhos, consumir);
+}
+
+const char *FileLoader::backend() const
+{
+    return anel != nullptr ? "io_uring" : "pread";
+}
@@ -0,0 +1,78 @@
+/*
+ * Trabalho de Compiladores - Leitura de Arquivos em Lote
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo define o carregador usado quando muitos arquivos pequenos são
+ * analisados de uma vez (--check sobre uma árvore de pastas). Em vez de abrir
+ * e ler um arquivo por vez, o FileLoader mantém dezenas de leituras em voo
+ * pelo io_uring. Cada leitura usa um dos buffers fixos (registrados no
+ * kernel, 64 KB cada). Cada arquivo que termina é entregue à função de
+ * consumo, que roda o lexer sobre o buffer enquanto as outras leituras
+ * continuam no kernel; o buffer volta ao pool quando ela retorna. Sem
+ * io_uring (kernel antigo, desabilitado por sysctl ou seccomp), as leituras
+ * são feitas com pread nas threads de um ThreadPool, com a mesma interface.
+ *
+ * Data: Outubro de 2026
+ */
+
+#ifndef FILE_LOADER_H
+#define FILE_LOADER_H
+
+#include "thread_pool.h"
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+// Nomes dos arquivos de código tomados das pastas: .txt, comprimido ou não
+extern const vector<string> PADROES_FONTE;
+
+// Troca as pastas de entradas pelos arquivos regulares dentro delas cujo nome
+// casa com um dos padrões (fnmatch), recursivamente e em ordem de nome.
+// Pastas e arquivos ocultos (.git, ...) ficam de fora; os caminhos que não
+// são pastas ficam como estão, com qualquer nome
+void expand_paths(const vector<string> &entradas, vector<string> &arquivos,
+                  const vector<string> &padroes = PADROES_FONTE);
+
+struct IoUring;
+
+class FileLoader
+{
+public:
+    enum Modo
+    {
+        AUTOMATICO, // io_uring se disponível, senão pread
+        PREAD
+    };
+
+    // threads = tamanho do pool do pread (0 = hardware_concurrency)
+    explicit FileLoader(Modo modo = AUTOMATICO, size_t threads = 0);
+    ~FileLoader();
+    FileLoader(const FileLoader &) = delete;
+    FileLoader &operator=(const FileLoader &) = delete;
+
+    // Chama consumir(i, conteudo, erro) uma vez para cada caminho, na ordem em
+    // que as leituras terminam e nunca em duas threads ao mesmo tempo. erro
+    // vem vazio se o arquivo foi lido; conteudo só vale durante a chamada.
+    void load(const vector<string> &caminhos, const function<void(size_t, string_view, const string &)> &consumir);
+
+    // "io_uring" ou "pread"
+    const char *backend() const;
+
+private:
+    IoUring *anel = nullptr;
+    ThreadPool *pool = nullptr;
+    size_t threads;
+
+    void load_uring(const vector<string> &caminhos, const function<void(size_t, string_view, const string &)> &consumir);
+    void load_pread(const vector<string> &caminhos, const function<void(size_t, string_view, const string &)> &consumir);
+};
+
+#endif // FILE_LOADER_H
@@ -0,0 +1,65 @@
+/*
+ * Trabalho de Compiladores - Analisador Léxico
+ * Parte B: Lexer gerado pelo Flex
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo implementa o FlexBackend, que adapta o scanner reentrante gerado
+ * a partir de lexer.l à interface LexerBackend. Precisa do lex.yy.c/lex.yy.h
+ * gerados por "flex lexer.l" e de -DUSE_FLEX na compilação.
+ *
+ * Data: Outubro de 2026
+ */
+
+#include "automata.h"
+#include "lexer.h"
+#include "lex.yy.h"
+#include <cctype>
+
+FlexBackend::FlexBackend(const string &source) : source(source)
+{
+    // yy_scan_buffer exige os dois últimos bytes iguais a YY_END_OF_BUFFER_CHAR
+    buffer.assign(source.begin(), source.end());
+    buffer.push_back('\0');
+    buffer.push_back('\0');
+
+    yyscan_t s;
+    yylex_init(&s);
+    scanner = s;
+    state = yy_scan_buffer(buffer.data(), buffer.size(), s);
+}
+
+FlexBackend::~FlexBackend()
+{
+    yy_delete_buffer(static_cast<YY_BUFFER_STATE>(state), static_cast<yyscan_t>(scanner));
+    yylex_destroy(static_cast<yyscan_t>(scanner));
+}
+
+Token *FlexBackend::scan()
+{
+    yyscan_t s = static_cast<yyscan_t>(scanner);
+    int tag;
+    while ((tag = yylex(s)) != 0)
+    {
+        // yytext aponta para dentro de buffer, então a posição sai de graça
+        size_t start = yyget_text(s) - buffer.data();
+        if (start < skip_until)
+            continue;
+
+        if (tag != UNK)
+            return create_token(static_cast<Tag>(tag), string(yyget_text(s), yyget_leng(s)), start);
+
+        // O lexer de autômatos junta em um único Unknown todo o resto da
+        // sequência sem espaços; os tokens que o flex achar ali são descartados
+        size_t end = start;
+        while (end < source.size() && !isspace(static_cast<unsigned char>(source[end])))
+            end++;
+        skip_until = end;
+        return create_unknown(source, start, end);
+    }
+    return nullptr;
+}
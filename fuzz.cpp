@@ -0,0 +1,484 @@
+/*
+ * Trabalho de Compiladores - Fuzzing de Desempenho
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo implementa o fuzzer de desempenho: mutação, medição,
+ * classificação, minimização e gravação dos casos encontrados.
+ *
+ * Data: Outubro de 2026
+ */
+
+#include "fuzz.h"
+#include "alloc_profile.h"
+#include "automata.h"
+#include "cache.h"
+#include "lexer.h"
+#include "lexgen.h"
+#include "parser.h"
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <set>
+#include <sstream>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct Medida
+{
+    bool falha = false;
+    string motivo; // texto da exceção, quando falha
+    double ns = 0;
+    uint64_t alocacoes = 0;
+};
+
+// Custo por byte das sementes
+struct Referencia
+{
+    double ns_byte = 0;
+    double alocacoes_byte = 0;
+};
+
+struct EntradaCorpus
+{
+    string dados;
+    double razao; // custo por byte / referência (o maior entre tempo e alocações)
+};
+
+static uint64_t total_alocacoes()
+{
+    uint64_t total = 0;
+    for (int f = 0; f < NUM_FASES; f++)
+        total += alloc_stats((AllocPhase)f).alocacoes;
+    return total;
+}
+
+// ==========================
+// Sinais fatais
+// ==========================
+
+// Entrada em execução e onde gravá-la se o processo morrer; o tratador só usa
+// chamadas async-signal-safe
+static const string *entrada_atual = nullptr;
+static char caminho_sinal[4096];
+
+static void tratar_sinal(int sinal)
+{
+    if (entrada_atual != nullptr)
+    {
+        int fd = open(caminho_sinal, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd >= 0)
+        {
+            if (write(fd, entrada_atual->data(), entrada_atual->size()) < 0)
+            {
+                // nada a fazer: o processo vai terminar de qualquer forma
+            }
+            close(fd);
+        }
+        const char msg[] = "\n[FALHA] sinal fatal; entrada gravada em ";
+        if (write(2, msg, sizeof(msg) - 1) < 0 || write(2, caminho_sinal, strlen(caminho_sinal)) < 0 || write(2, "\n", 1) < 0)
+        {
+        }
+    }
+    _exit(128 + sinal);
+}
+
+// ==========================
+// Execução e classificação
+// ==========================
+
+// Mesmo caminho do modo arquivo até a árvore de derivação
+static Medida executar(const string &fonte, const FuzzOptions &opcoes)
+{
+    Medida m;
+    entrada_atual = &fonte;
+    uint64_t antes = total_alocacoes();
+    auto inicio = chrono::steady_clock::now();
+    try
+    {
+        stringstream ss(fonte);
+        LexerBackend *lexer = make_lexer(opcoes.backend, ss, opcoes.tabelas);
+        vector<Token *> tokens = analise_lexica(*lexer);
+        delete lexer;
+
+        VectorLexer lexer_tokens(tokens);
+        ParseNode *arvore = nullptr;
+        string erro;
+        if (parse_tokens(lexer_tokens, &arvore, false, erro, nullptr))
+            free_parse_tree(arvore);
+        for (Token *tok : tokens)
+            delete tok;
+    }
+    catch (const LexicalError &)
+    {
+        // Entrada rejeitada com diagnóstico, como um erro de sintaxe
+    }
+    catch (const exception &e)
+    {
+        m.falha = true;
+        m.motivo = e.what();
+    }
+    m.ns = chrono::duration<double, nano>(chrono::steady_clock::now() - inicio).count();
+    m.alocacoes = total_alocacoes() - antes;
+    entrada_atual = nullptr;
+    return m;
+}
+
+// Tempo é ruidoso: fica o menor de algumas execuções
+static Medida executar_estavel(const string &fonte, const FuzzOptions &opcoes, int vezes)
+{
+    Medida melhor = executar(fonte, opcoes);
+    for (int i = 1; i < vezes && !melhor.falha; i++)
+        melhor.ns = min(melhor.ns, executar(fonte, opcoes).ns);
+    return melhor;
+}
+
+static double razao_tempo(const string &fonte, const Medida &m, const Referencia &ref)
+{
+    return fonte.empty() ? 0 : m.ns / fonte.size() / ref.ns_byte;
+}
+
+static double razao_alocacoes(const string &fonte, const Medida &m, const Referencia &ref)
+{
+    return fonte.empty() || ref.alocacoes_byte == 0 ? 0 : m.alocacoes / (double)fonte.size() / ref.alocacoes_byte;
+}
+
+// "" se a entrada é normal; senão o tipo do problema. Lentidão por tempo só é
+// confirmada com a medição estável.
+static string classificar(const string &fonte, const Medida &m, const Referencia &ref, const FuzzOptions &opcoes)
+{
+    if (m.falha)
+        return "falha: " + m.motivo;
+    if (fonte.size() < opcoes.tamanho_min)
+        return "";
+    if (razao_alocacoes(fonte, m, ref) > opcoes.fator)
+        return "lenta: alocações";
+    if (razao_tempo(fonte, m, ref) > opcoes.fator &&
+        razao_tempo(fonte, executar_estavel(fonte, opcoes, 3), ref) > opcoes.fator)
+        return "lenta: tempo";
+    return "";
+}
+
+// Agrupa as entradas lentas pela classe do byte que mais aparece (letras e
+// dígitos, pontuação ou outros bytes), para não gravar a mesma causa com cada
+// caractere possível
+static string assinatura(const string &fonte, const string &tipo)
+{
+    if (tipo.rfind("falha", 0) == 0)
+        return tipo;
+    size_t contagem[3] = {};
+    for (unsigned char c : fonte)
+        if (!isspace(c))
+            contagem[isalnum(c) ? 0 : ispunct(c) ? 1 : 2]++;
+    static const char *CLASSES[3] = {"letras/dígitos", "pontuação", "outros bytes"};
+    return tipo + " (" + CLASSES[max_element(contagem, contagem + 3) - contagem] + ")";
+}
+
+// ==========================
+// Mutação
+// ==========================
+
+static const vector<string> DICIONARIO = {
+    "def", "if", "else", "print", "return", "int", "Main", "Soma", "x", "y1",
+    "(", ")", "{", "}", ";", ",", "=", "==", "!=", "<=", ">=", "<", ">",
+    "+", "-", "*", "/", "0", "2147483647", "2147483648", "99999999999999999999"};
+
+static const string ALFABETO = "abcxyzABCXYZ0123456789 \n\t(){};,=<>!+-*/$#@_";
+
+class Mutador
+{
+public:
+    Mutador(uint64_t semente, size_t tamanho_max) : rng(semente), tamanho_max(tamanho_max) {}
+
+    size_t uniforme(size_t n) { return n == 0 ? 0 : rng() % n; }
+
+    char byte_aleatorio()
+    {
+        // Na maior parte das vezes bytes da linguagem; às vezes qualquer byte
+        return uniforme(8) == 0 ? (char)uniforme(256) : ALFABETO[uniforme(ALFABETO.size())];
+    }
+
+    // Aplica de 1 a 4 mutações empilhadas (como o "havoc" do AFL)
+    string mutar(const string &original, const vector<EntradaCorpus> &corpus)
+    {
+        string s = original;
+        size_t n = 1 + uniforme(4);
+        for (size_t i = 0; i < n; i++)
+            mutar_uma(s, corpus);
+        if (s.size() > tamanho_max)
+            s.resize(tamanho_max);
+        return s;
+    }
+
+private:
+    mt19937_64 rng;
+    size_t tamanho_max;
+
+    void mutar_uma(string &s, const vector<EntradaCorpus> &corpus)
+    {
+        size_t pos = uniforme(s.size() + 1);
+        switch (uniforme(8))
+        {
+        case 0: // inverte um bit
+            if (!s.empty())
+                s[pos % s.size()] ^= (char)(1 << uniforme(8));
+            break;
+        case 1: // troca um byte
+            if (!s.empty())
+                s[pos % s.size()] = byte_aleatorio();
+            break;
+        case 2: // insere palavra do dicionário
+        {
+            string palavra = DICIONARIO[uniforme(DICIONARIO.size())];
+            if (uniforme(2))
+                palavra += ' ';
+            s.insert(pos, palavra);
+            break;
+        }
+        case 3: // remove um trecho
+            if (!s.empty())
+                s.erase(pos % s.size(), 1 + uniforme(min<size_t>(s.size(), 32)));
+            break;
+        case 4: // duplica um trecho em outra posição
+            if (!s.empty())
+            {
+                size_t inicio = uniforme(s.size());
+                string trecho = s.substr(inicio, 1 + uniforme(min<size_t>(s.size() - inicio, 64)));
+                s.insert(uniforme(s.size() + 1), trecho);
+            }
+            break;
+        case 5: // repete um byte ou trecho curto muitas vezes ("aaaa...", "<<<<...")
+        {
+            string unidade = s.empty() || uniforme(2) ? string(1, byte_aleatorio()) : s.substr(pos % s.size(), 1 + uniforme(3));
+            size_t vezes = 1 + uniforme(max<size_t>(tamanho_max / 2 / unidade.size(), 1));
+            string repetido;
+            repetido.reserve(unidade.size() * vezes);
+            for (size_t i = 0; i < vezes; i++)
+                repetido += unidade;
+            s.insert(min(pos, s.size()), repetido);
+            break;
+        }
+        case 6: // remove os espaços de um trecho, juntando os tokens
+        {
+            size_t fim = min(s.size(), pos + 1 + uniforme(256));
+            string trecho = s.substr(min(pos, s.size()), fim - min(pos, s.size()));
+            trecho.erase(remove_if(trecho.begin(), trecho.end(), [](unsigned char c) { return isspace(c); }), trecho.end());
+            s.replace(min(pos, s.size()), fim - min(pos, s.size()), trecho);
+            break;
+        }
+        default: // mistura com outra entrada do corpus
+        {
+            const string &outra = corpus[uniforme(corpus.size())].dados;
+            if (outra.empty())
+                break;
+            size_t inicio = uniforme(outra.size());
+            s = s.substr(0, min(pos, s.size())) + outra.substr(inicio);
+            break;
+        }
+        }
+    }
+};
+
+// ==========================
+// Minimização
+// ==========================
+
+// Delta debugging simplificado: tenta remover blocos cada vez menores
+// enquanto a entrada mantém a mesma classificação
+template <typename Mantem>
+static string minimizar(string s, Mantem mantem)
+{
+    auto limite = chrono::steady_clock::now() + chrono::seconds(10);
+    size_t avaliacoes = 0;
+    for (size_t bloco = max<size_t>(s.size() / 2, 1); bloco >= 1; bloco /= 2)
+    {
+        for (size_t i = 0; i < s.size();)
+        {
+            if (++avaliacoes > 2000 || chrono::steady_clock::now() > limite)
+                return s;
+            string menor = s.substr(0, i) + s.substr(min(s.size(), i + bloco));
+            if (mantem(menor))
+                s = menor;
+            else
+                i += bloco;
+        }
+        if (bloco == 1)
+            break;
+    }
+    return s;
+}
+
+static string gravar(const FuzzOptions &opcoes, const string &prefixo, const string &dados)
+{
+    char nome[64];
+    snprintf(nome, sizeof(nome), "%s-%016llx.txt", prefixo.c_str(),
+             static_cast<unsigned long long>(xxhash64(dados.data(), dados.size(), 0)));
+    string caminho = opcoes.diretorio + "/" + nome;
+    ofstream out(caminho, ios::binary);
+    out << dados;
+    return caminho;
+}
+
+// ==========================
+// Laço principal
+// ==========================
+
+int run_fuzzer(const vector<string> &sementes, const FuzzOptions &opcoes)
+{
+    mkdir(opcoes.diretorio.c_str(), 0755);
+    snprintf(caminho_sinal, sizeof(caminho_sinal), "%s/falha-sinal.txt", opcoes.diretorio.c_str());
+    signal(SIGSEGV, tratar_sinal);
+    signal(SIGABRT, tratar_sinal);
+    signal(SIGFPE, tratar_sinal);
+    signal(SIGBUS, tratar_sinal);
+
+    vector<EntradaCorpus> corpus;
+    for (const auto &arquivo : sementes)
+    {
+        ifstream in(arquivo, ios::binary);
+        if (!in)
+        {
+            cerr << "Não foi possível abrir a semente " << arquivo << endl;
+            return 1;
+        }
+        stringstream texto;
+        texto << in.rdbuf();
+        corpus.push_back(EntradaCorpus{texto.str(), 1.0});
+    }
+    if (corpus.empty())
+    {
+        cerr << "Nenhuma semente para o fuzzer (informe arquivos ou tenha entrada_*.txt no diretório)." << endl;
+        return 1;
+    }
+
+    // Referência: o maior custo por byte entre as sementes
+    Referencia ref;
+    for (const auto &e : corpus)
+    {
+        if (e.dados.empty())
+            continue;
+        Medida m = executar_estavel(e.dados, opcoes, 5);
+        if (m.falha)
+        {
+            cerr << "A semente já falha (" << m.motivo << "); corrija-a antes de usar no fuzzer." << endl;
+            return 1;
+        }
+        ref.ns_byte = max(ref.ns_byte, m.ns / e.dados.size());
+        ref.alocacoes_byte = max(ref.alocacoes_byte, m.alocacoes / (double)e.dados.size());
+    }
+    if (ref.ns_byte == 0)
+    {
+        cerr << "As sementes estão vazias." << endl;
+        return 1;
+    }
+
+    cout << fixed << setprecision(2);
+    cout << "Fuzzer: " << corpus.size() << " sementes, " << opcoes.iteracoes << " iterações, limite " << opcoes.fator
+         << "x a referência de " << ref.ns_byte << " ns/byte";
+    if (alloc_profiler_enabled())
+        cout << " e " << ref.alocacoes_byte << " alocações/byte";
+    else
+        cout << " (alocações não medidas: compile com -DUSE_ALLOC_PROFILER)";
+    cout << endl;
+
+    Mutador mutador(opcoes.semente, opcoes.tamanho_max);
+    set<string> vistos;
+    size_t falhas = 0, lentas = 0;
+    double pior = 0;
+    auto inicio = chrono::steady_clock::now();
+
+    for (size_t it = 1; it <= opcoes.iteracoes; it++)
+    {
+        // Metade das vezes parte das entradas mais caras, metade de qualquer uma
+        size_t indice = mutador.uniforme(corpus.size());
+        if (mutador.uniforme(2))
+        {
+            size_t topo = min<size_t>(8, corpus.size());
+            partial_sort(corpus.begin(), corpus.begin() + topo, corpus.end(),
+                         [](const EntradaCorpus &a, const EntradaCorpus &b) { return a.razao > b.razao; });
+            indice = mutador.uniforme(topo);
+        }
+        const EntradaCorpus pai = corpus[indice];
+        string filho = mutador.mutar(pai.dados, corpus);
+
+        Medida m = executar(filho, opcoes);
+        double razao = max(razao_tempo(filho, m, ref), razao_alocacoes(filho, m, ref));
+        if (!m.falha && filho.size() >= opcoes.tamanho_min)
+            pior = max(pior, razao);
+
+        string tipo = classificar(filho, m, ref, opcoes);
+        if (!tipo.empty())
+        {
+            string chave = assinatura(filho, tipo);
+            if (vistos.insert(chave).second)
+            {
+                // Entradas lentas não podem encolher até ficarem no limite, senão
+                // deixam de servir de benchmark: exige ao menos metade da razão
+                bool falha = tipo.rfind("falha", 0) == 0;
+                double exigida = max(opcoes.fator, razao / 2);
+                string minimo = minimizar(filho, [&](const string &s)
+                                          {
+                                              Medida ms = executar(s, opcoes);
+                                              if (classificar(s, ms, ref, opcoes) != tipo)
+                                                  return false;
+                                              if (falha)
+                                                  return true;
+                                              if (tipo == "lenta: alocações")
+                                                  return razao_alocacoes(s, ms, ref) >= exigida;
+                                              return razao_tempo(s, executar_estavel(s, opcoes, 3), ref) >= exigida;
+                                          });
+                string caminho = gravar(opcoes, falha ? "falha" : "lenta", minimo);
+                Medida final = executar_estavel(minimo, opcoes, 3);
+                cout << (falha ? "[FALHA] " : "[LENTA] ") << caminho << ": " << chave << ", " << filho.size() << " -> "
+                     << minimo.size() << " bytes";
+                if (!falha)
+                {
+                    cout << ", " << final.ns / minimo.size() << " ns/byte (" << razao_tempo(minimo, final, ref) << "x)";
+                    if (alloc_profiler_enabled())
+                        cout << ", " << final.alocacoes / (double)minimo.size() << " alocações/byte ("
+                             << razao_alocacoes(minimo, final, ref) << "x)";
+                }
+                cout << endl;
+                (falha ? falhas : lentas)++;
+            }
+        }
+
+        // Corpus guiado pelo custo: fica o mutante que custa mais por byte que o pai
+        if (!m.falha && razao > pai.razao * 1.05)
+        {
+            if (corpus.size() >= 256)
+            {
+                auto menor = min_element(corpus.begin(), corpus.end(),
+                                         [](const EntradaCorpus &a, const EntradaCorpus &b) { return a.razao < b.razao; });
+                *menor = EntradaCorpus{filho, razao};
+            }
+            else
+            {
+                corpus.push_back(EntradaCorpus{filho, razao});
+            }
+        }
+
+        if (it % 1000 == 0)
+        {
+            double s = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+            cout << "#" << it << ": " << it / s << " exec/s, corpus " << corpus.size() << ", maior razão " << pior << "x"
+                 << endl;
+        }
+    }
+
+    double s = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+    cout << "Fim: " << opcoes.iteracoes << " execuções em " << s << " s, " << falhas << " falha(s), " << lentas
+         << " entrada(s) lenta(s), maior razão " << pior << "x" << endl;
+    cout.unsetf(ios::floatfield);
+    return falhas + lentas > 0 ? 1 : 0;
+}
@@ -0,0 +1,59 @@
+/*
+ * Trabalho de Compiladores - Fuzzing de Desempenho
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo define o modo de fuzzing (--fuzz), que procura entradas que
+ * quebram o front-end ou que o deixam super-linear. As sementes (por padrão
+ * entrada_*.txt) são mutadas no estilo do AFL/libFuzzer (troca de bits e
+ * bytes, inserção de palavras do dicionário, remoção, duplicação e repetição
+ * de trechos, remoção de espaços, mistura entre sementes) e cada entrada
+ * passa pelo lexer escolhido e pelo parser LL(1) com árvore.
+ *
+ * Para cada execução são medidos o tempo e, se compilado com
+ * -DUSE_ALLOC_PROFILER, as alocações. O custo por byte das sementes é a
+ * referência: uma entrada é marcada como lenta quando o tempo ou as alocações
+ * por byte passam de fator x referência. Como não há cobertura, o corpus é
+ * guiado pelo custo (como no PerfFuzz): um mutante entra no corpus quando
+ * custa mais por byte que a entrada de onde veio.
+ *
+ * Exceções que escapam (o erro léxico de um número grande não conta: ele é
+ * um diagnóstico) e sinais fatais são falhas. Cada falha ou entrada lenta nova é minimizada por remoção de
+ * trechos (delta debugging) mantendo a mesma classificação e gravada no
+ * diretório de saída, para virar benchmark de regressão.
+ *
+ * Data: Outubro de 2026
+ */
+
+#ifndef FUZZ_H
+#define FUZZ_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+struct DfaTables;
+
+struct FuzzOptions
+{
+    size_t iteracoes = 10000;
+    uint64_t semente = 1;
+    size_t tamanho_max = 2048;  // entradas maiores são truncadas
+    size_t tamanho_min = 64;    // abaixo disso o custo fixo domina e não se julga lentidão
+    double fator = 20;          // limite = fator x custo por byte das sementes
+    string diretorio = "fuzz_casos";
+    string backend = "automata";
+    const DfaTables *tabelas = nullptr;
+};
+
+// Roda o fuzzer a partir das sementes. Retorna 0 se nada foi encontrado e 1
+// se houve falha ou entrada lenta.
+int run_fuzzer(const vector<string> &sementes, const FuzzOptions &opcoes);
+
+#endif // FUZZ_H
@@ -0,0 +1,354 @@
+/*
+ * Trabalho de Compiladores - Representação Intermediária
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo implementa a geração da IR a partir da AST e a impressão da IR.
+ *
+ * Data: Outubro de 2026
+ */
+
+#include "ir.h"
+#include <climits>
+#include <unordered_map>
+
+int IRFunction::num_instrs() const
+{
+    int total = 0;
+    for (const auto &bloco : blocos)
+        total += bloco.instrs.size();
+    return total;
+}
+
+vector<int> IRFunction::sucessores(int bloco) const
+{
+    const Instr &term = blocos[bloco].instrs.back();
+    if (term.op == IR_JMP)
+        return {term.alvo};
+    if (term.op == IR_BR)
+        return {term.alvo, term.alvo_senao};
+    return {};
+}
+
+int IRProgram::num_instrs() const
+{
+    int total = 0;
+    for (const auto &f : funcoes)
+        total += f.num_instrs();
+    return total;
+}
+
+bool eval_binop(Tag op, int a, int b, int &resultado)
+{
+    // Soma, subtração e multiplicação com estouro em complemento de dois
+    unsigned ua = static_cast<unsigned>(a), ub = static_cast<unsigned>(b);
+    switch (op)
+    {
+    case PLUS:
+        resultado = static_cast<int>(ua + ub);
+        return true;
+    case MINUS:
+        resultado = static_cast<int>(ua - ub);
+        return true;
+    case TIMES:
+        resultado = static_cast<int>(ua * ub);
+        return true;
+    case DIVIDE:
+        if (b == 0 || (a == INT_MIN && b == -1))
+            return false;
+        resultado = a / b;
+        return true;
+    case LT:
+        resultado = a < b;
+        return true;
+    case LE:
+        resultado = a <= b;
+        return true;
+    case GT:
+        resultado = a > b;
+        return true;
+    case GE:
+        resultado = a >= b;
+        return true;
+    case EQ:
+        resultado = a == b;
+        return true;
+    case NE:
+        resultado = a != b;
+        return true;
+    default:
+        return false;
+    }
+}
+
+// ==========================
+// Geração da IR
+// ==========================
+
+class Lowering
+{
+public:
+    Lowering(IRFunction &f) : f(f) {}
+
+    void lower_funcao(const Funcao &funcao)
+    {
+        f.nome = funcao.nome.nome;
+        for (const auto &param : funcao.params)
+            variavel(param.nome);
+        f.num_params = funcao.params.size();
+
+        atual = novo_bloco();
+        for (const Stmt *s : funcao.corpo)
+            lower_stmt(s);
+
+        // Retorno implícito ao final da função
+        origem = nullptr;
+        if (!terminado())
+            emit(Instr(IR_RET));
+    }
+
+private:
+    IRFunction &f;
+    unordered_map<string, int> ids;
+    int atual = 0;
+    int num_temps = 0;
+    Token *origem = nullptr; // comando sendo gerado
+
+    int variavel(const string &nome)
+    {
+        auto it = ids.find(nome);
+        if (it != ids.end())
+            return it->second;
+        int id = f.vars.size();
+        f.vars.push_back(nome);
+        f.temporario.push_back(false);
+        ids[nome] = id;
+        return id;
+    }
+
+    int temporario()
+    {
+        int id = f.vars.size();
+        f.vars.push_back("t" + to_string(num_temps++));
+        f.temporario.push_back(true);
+        return id;
+    }
+
+    int novo_bloco()
+    {
+        f.blocos.emplace_back();
+        return f.blocos.size() - 1;
+    }
+
+    bool terminado() const
+    {
+        const auto &instrs = f.blocos[atual].instrs;
+        return !instrs.empty() && (instrs.back().op == IR_RET || instrs.back().op == IR_JMP || instrs.back().op == IR_BR);
+    }
+
+    void emit(Instr instr)
+    {
+        instr.token = origem;
+        f.blocos[atual].instrs.push_back(instr);
+    }
+
+    void jump(int alvo)
+    {
+        Instr j(IR_JMP);
+        j.alvo = alvo;
+        emit(j);
+    }
+
+    Operando lower_expr(const Expr *e)
+    {
+        switch (e->tipo)
+        {
+        case EXPR_NUM:
+            return Operando::cte(e->valor);
+        case EXPR_VAR:
+            return Operando::var(variavel(e->var.nome));
+        default:
+        {
+            Instr bin(IR_BIN);
+            bin.a = lower_expr(e->esq);
+            bin.b = lower_expr(e->dir);
+            bin.binop = e->op;
+            bin.dest = temporario();
+            emit(bin);
+            return Operando::var(bin.dest);
+        }
+        }
+    }
+
+    Instr lower_chamada(const Chamada *c, int dest)
+    {
+        Instr call(IR_CALL);
+        call.funcao = c->funcao.nome;
+        call.dest = dest;
+        for (const auto &arg : c->args)
+            call.args.push_back(Operando::var(variavel(arg.nome)));
+        return call;
+    }
+
+    void lower_stmt(const Stmt *s)
+    {
+        origem = s->token;
+        switch (s->tipo)
+        {
+        case STMT_DECL:
+            for (const auto &nome : s->nomes)
+                variavel(nome.nome);
+            break;
+        case STMT_ATRIB:
+            if (s->chamada != nullptr)
+            {
+                emit(lower_chamada(s->chamada, variavel(s->alvo.nome)));
+            }
+            else
+            {
+                Instr copy(IR_COPY);
+                copy.a = lower_expr(s->expr);
+                copy.dest = variavel(s->alvo.nome);
+                emit(copy);
+            }
+            break;
+        case STMT_CHAMADA:
+            emit(lower_chamada(s->chamada, -1));
+            break;
+        case STMT_PRINT:
+        {
+            Instr print(IR_PRINT);
+            print.a = lower_expr(s->expr);
+            emit(print);
+            break;
+        }
+        case STMT_RETURN:
+        {
+            Instr ret(IR_RET);
+            if (!s->alvo.nome.empty())
+                ret.a = Operando::var(variavel(s->alvo.nome));
+            emit(ret);
+            // O que vier depois do return vai para um bloco sem predecessores
+            atual = novo_bloco();
+            break;
+        }
+        case STMT_IF:
+        {
+            Instr br(IR_BR);
+            br.a = lower_expr(s->expr);
+            int bloco_br = atual;
+            int bloco_entao = novo_bloco();
+            int bloco_senao = s->senao != nullptr ? novo_bloco() : -1;
+            int bloco_fim = novo_bloco();
+            br.alvo = bloco_entao;
+            br.alvo_senao = bloco_senao != -1 ? bloco_senao : bloco_fim;
+            br.token = s->token;
+            f.blocos[bloco_br].instrs.push_back(br);
+
+            atual = bloco_entao;
+            lower_stmt(s->entao);
+            if (!terminado())
+                jump(bloco_fim);
+
+            if (bloco_senao != -1)
+            {
+                atual = bloco_senao;
+                lower_stmt(s->senao);
+                if (!terminado())
+                    jump(bloco_fim);
+            }
+            atual = bloco_fim;
+            break;
+        }
+        case STMT_BLOCO:
+            for (const Stmt *filho : s->corpo)
+                lower_stmt(filho);
+            break;
+        case STMT_VAZIO:
+            break;
+        }
+    }
+};
+
+IRProgram lower_program(const Programa &programa)
+{
+    IRProgram ir;
+    for (const Funcao *funcao : programa.funcoes)
+    {
+        ir.funcoes.emplace_back();
+        Lowering lowering(ir.funcoes.back());
+        lowering.lower_funcao(*funcao);
+    }
+    return ir;
+}
+
+// ==========================
+// Impressão da IR
+// ==========================
+
+static const unordered_map<Tag, string> BINOP_TO_STRING = {
+    {PLUS, "+"}, {MINUS, "-"}, {TIMES, "*"}, {DIVIDE, "/"}, {LT, "<"}, {LE, "<="}, {GT, ">"}, {GE, ">="}, {EQ, "=="}, {NE, "!="}};
+
+static string operando_str(const IRFunction &f, const Operando &op)
+{
+    if (op.tipo == Operando::CONST)
+        return to_string(op.valor);
+    return f.vars[op.valor];
+}
+
+void print_ir(ostream &out, const IRProgram &ir)
+{
+    for (const auto &f : ir.funcoes)
+    {
+        out << "func " << (f.nome.empty() ? "<global>" : f.nome) << "(";
+        for (int i = 0; i < f.num_params; i++)
+            out << (i ? ", " : "") << f.vars[i];
+        out << "):\n";
+
+        for (size_t b = 0; b < f.blocos.size(); b++)
+        {
+            out << "  B" << b << ":\n";
+            for (const Instr &instr : f.blocos[b].instrs)
+            {
+                out << "    ";
+                switch (instr.op)
+                {
+                case IR_COPY:
+                    out << f.vars[instr.dest] << " = " << operando_str(f, instr.a);
+                    break;
+                case IR_BIN:
+                    out << f.vars[instr.dest] << " = " << operando_str(f, instr.a) << " " << BINOP_TO_STRING.at(instr.binop) << " " << operando_str(f, instr.b);
+                    break;
+                case IR_CALL:
+                    if (instr.dest != -1)
+                        out << f.vars[instr.dest] << " = ";
+                    out << "call " << instr.funcao << "(";
+                    for (size_t i = 0; i < instr.args.size(); i++)
+                        out << (i ? ", " : "") << operando_str(f, instr.args[i]);
+                    out << ")";
+                    break;
+                case IR_PRINT:
+                    out << "print " << operando_str(f, instr.a);
+                    break;
+                case IR_RET:
+                    out << "ret";
+                    if (instr.a.tipo != Operando::NENHUM)
+                        out << " " << operando_str(f, instr.a);
+                    break;
+                case IR_JMP:
+                    out << "jmp B" << instr.alvo;
+                    break;
+                case IR_BR:
+                    out << "br " << operando_str(f, instr.a) << " ? B" << instr.alvo << " : B" << instr.alvo_senao;
+                    break;
+                }
+                out << "\n";
+            }
+        }
+        out << "\n";
+    }
+}
@@ -0,0 +1,187 @@
+/*
+ * Trabalho de Compiladores - Representação Intermediária
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo define a IR de três endereços gerada a partir da AST, organizada
+ * em blocos básicos. Só os temporários seguem a forma SSA (cada um é definido
+ * uma única vez). As variáveis do programa não: cada atribuição é um IR_COPY
+ * para a mesma posição, sem renomear as definições nem pôr funções φ nas
+ * junções. A propagação de constantes trabalha por variável sobre o grafo de
+ * blocos (reticulado com ponto fixo), o que dá nesses passes o mesmo
+ * resultado da versão SSA. Assim a vivacidade e a atribuição definida de
+ * dataflow.h, o inlining, o avaliador e o backend C leem a IR como ela é, sem
+ * φ e sem uma volta da forma SSA.
+ *
+ * Também define o gerenciador de passes e as otimizações: propagação/dobra de
+ * constantes, eliminação de desvios constantes, remoção de código
+ * inalcançável, junção de blocos em sequência e remoção de atribuições mortas.
+ * O pass interprocedural de inlining fica em callgraph.h e as análises de
+ * fluxo de dados em dataflow.h.
+ *
+ * Data: Outubro de 2026
+ */
+
+#ifndef IR_H
+#define IR_H
+
+#include "ast.h"
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+enum IROp
+{
+    IR_COPY,  // dest = a
+    IR_BIN,   // dest = a op b
+    IR_CALL,  // [dest =] call funcao(args)
+    IR_PRINT, // print a
+    IR_RET,   // ret [a]
+    IR_JMP,   // jmp alvo
+    IR_BR     // br a ? alvo : alvo_senao
+};
+
+struct Operando
+{
+    enum Tipo
+    {
+        NENHUM,
+        CONST,
+        VAR
+    } tipo = NENHUM;
+    int valor = 0; // CONST: o valor; VAR: o id da variável na função
+
+    static Operando cte(int v) { return Operando{CONST, v}; }
+    static Operando var(int id) { return Operando{VAR, id}; }
+};
+
+struct Instr
+{
+    IROp op;
+    int dest = -1;
+    Operando a, b;
+    Tag binop = UNK; // IR_BIN
+    string funcao;   // IR_CALL
+    vector<Operando> args;
+    int alvo = -1, alvo_senao = -1; // IR_JMP / IR_BR
+    Token *token = nullptr;         // comando de origem (para avisos)
+
+    Instr(IROp op) : op(op) {}
+};
+
+// A última instrução de todo bloco é um terminador (IR_RET, IR_JMP ou IR_BR)
+struct BasicBlock
+{
+    vector<Instr> instrs;
+};
+
+struct IRFunction
+{
+    string nome;
+    vector<string> vars;   // id -> nome; temporários são "t0", "t1", ...
+    vector<bool> temporario;
+    int num_params = 0;    // os parâmetros são as variáveis 0..num_params-1
+    vector<BasicBlock> blocos; // blocos[0] é a entrada
+
+    int num_instrs() const;
+    vector<int> sucessores(int bloco) const;
+};
+
+struct IRProgram
+{
+    vector<IRFunction> funcoes;
+
+    int num_instrs() const;
+};
+
+IRProgram lower_program(const Programa &programa);
+void print_ir(ostream &out, const IRProgram &ir);
+
+// Avalia "a op b" com a semântica de int de 32 bits da linguagem; retorna false
+// quando o resultado não pode ser calculado em tempo de compilação (divisão por zero).
+bool eval_binop(Tag op, int a, int b, int &resultado);
+
+// ==========================
+// Passes de otimização
+// ==========================
+
+class Pass
+{
+public:
+    virtual ~Pass() {}
+    virtual string nome() const = 0;
+    // Executa o pass em uma função e retorna quantas alterações fez
+    virtual int run(IRFunction &f) = 0;
+    // Passes interprocedurais sobrescrevem este; o padrão roda run em cada função
+    virtual int run_program(IRProgram &ir);
+    // Linhas extras para o relatório (vazio = nada a acrescentar)
+    virtual string resumo() const { return ""; }
+};
+
+class ConstPropPass : public Pass
+{
+public:
+    string nome() const override { return "const-prop"; }
+    int run(IRFunction &f) override;
+};
+
+class BranchFoldPass : public Pass
+{
+public:
+    string nome() const override { return "branch-fold"; }
+    int run(IRFunction &f) override;
+};
+
+class UnreachablePass : public Pass
+{
+public:
+    string nome() const override { return "unreachable"; }
+    int run(IRFunction &f) override;
+};
+
+class MergeBlocksPass : public Pass
+{
+public:
+    string nome() const override { return "merge-blocks"; }
+    int run(IRFunction &f) override;
+};
+
+class DeadStorePass : public Pass
+{
+public:
+    string nome() const override { return "dead-store"; }
+    int run(IRFunction &f) override;
+};
+
+struct PassStats
+{
+    string nome;
+    double ms = 0;
+    int instrs_antes = 0;
+    int instrs_depois = 0;
+    int alteracoes = 0;
+};
+
+class PassManager
+{
+public:
+    void add(unique_ptr<Pass> pass);
+    void run(IRProgram &ir);
+    void report(ostream &out) const;
+
+private:
+    vector<unique_ptr<Pass>> passes;
+    vector<PassStats> stats;
+};
+
+// inline, const-prop, branch-fold, unreachable, merge-blocks, const-prop, dead-store
+PassManager default_pipeline();
+
+#endif // IR_H
@@ -0,0 +1,677 @@
+/*
+ * Trabalho de Compiladores - Parser LALR(1)
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo implementa a leitura da gramática BNF, a construção das tabelas
+ * LALR(1), a compressão e o driver shift-reduce.
+ *
+ * Data: Outubro de 2026
+ */
+
+#include "lalr.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <map>
+#include <sstream>
+#include <unordered_map>
+
+// Símbolos: terminais são as Tags (0 .. LALR_TERMINAIS-1), não-terminais vêm
+// depois (LALR_TERMINAIS + índice). Conjuntos de terminais são bits de um
+// uint64_t; o bit LOOKAHEAD_MARCA é o '#' da propagação de lookaheads.
+const int LOOKAHEAD_MARCA = 63;
+typedef uint64_t Conjunto;
+
+struct Producao
+{
+    int lhs;
+    vector<int> rhs;
+    int linha;
+};
+
+struct Gramatica
+{
+    vector<string> nao_terminais; // 0 = início aumentado
+    vector<Producao> producoes;   // 0 = S' ::= S
+    vector<vector<int>> por_lhs;  // produções de cada não-terminal
+
+    static bool terminal(int simbolo) { return simbolo < LALR_TERMINAIS; }
+
+    string nome(int simbolo) const
+    {
+        if (terminal(simbolo))
+        {
+            string s = TAG_TO_STRING.at(static_cast<Tag>(simbolo));
+            transform(s.begin(), s.end(), s.begin(), ::tolower);
+            return s;
+        }
+        return nao_terminais[simbolo - LALR_TERMINAIS];
+    }
+
+    string texto(int p) const
+    {
+        string s = nome(producoes[p].lhs) + " ::=";
+        for (int x : producoes[p].rhs)
+            s += " " + nome(x);
+        if (producoes[p].rhs.empty())
+            s += " ε";
+        return s;
+    }
+};
+
+// ==========================
+// Leitura da BNF
+// ==========================
+
+static bool ler_bnf(const string &texto, Gramatica &g, string &erro)
+{
+    unordered_map<string, int> terminais;
+    for (const auto &par : TAG_TO_STRING)
+    {
+        string s = par.second;
+        transform(s.begin(), s.end(), s.begin(), ::tolower);
+        terminais[s] = par.first;
+    }
+    terminais.erase("relop");
+    terminais.erase("arithop");
+    terminais.erase("unk");
+
+    map<string, int> indice_nt;
+    map<string, int> primeira_linha; // primeiro uso de cada não-terminal
+    g.nao_terminais.push_back("");   // S', nomeado depois
+    auto nao_terminal = [&](const string &nome)
+    {
+        auto it = indice_nt.find(nome);
+        if (it != indice_nt.end())
+            return it->second;
+        int id = LALR_TERMINAIS + g.nao_terminais.size();
+        g.nao_terminais.push_back(nome);
+        indice_nt[nome] = id;
+        return id;
+    };
+
+    // Produção aumentada, completada com o símbolo inicial no fim
+    g.producoes.push_back(Producao{LALR_TERMINAIS, {}, 0});
+
+    istringstream in(texto);
+    string linha;
+    int numero = 0;
+    int lhs = -1;
+    while (getline(in, linha))
+    {
+        numero++;
+        size_t comentario = linha.find('#');
+        if (comentario != string::npos)
+            linha.erase(comentario);
+
+        istringstream palavras(linha);
+        vector<string> simbolos;
+        string w;
+        while (palavras >> w)
+            simbolos.push_back(w);
+        if (simbolos.empty())
+            continue;
+
+        size_t k = 0;
+        if (simbolos.size() >= 2 && simbolos[1] == "::=")
+        {
+            if (terminais.count(simbolos[0]))
+            {
+                erro = "linha " + to_string(numero) + ": terminal '" + simbolos[0] + "' do lado esquerdo";
+                return false;
+            }
+            lhs = nao_terminal(simbolos[0]);
+            k = 2;
+        }
+        else if (simbolos[0] != "|")
+        {
+            erro = "linha " + to_string(numero) + ": esperado 'NOME ::=' ou '|'";
+            return false;
+        }
+        if (lhs == -1)
+        {
+            erro = "linha " + to_string(numero) + ": alternativa sem regra";
+            return false;
+        }
+        if (k < simbolos.size() && simbolos[k] == "|")
+            k++;
+
+        // Alternativas separadas por '|'; "ε" ou nada = vazia
+        Producao p{lhs, {}, numero};
+        for (; k <= simbolos.size(); k++)
+        {
+            if (k == simbolos.size() || simbolos[k] == "|")
+            {
+                g.producoes.push_back(p);
+                p.rhs.clear();
+                continue;
+            }
+            const string &s = simbolos[k];
+            if (s == "ε" || s == "%empty")
+                continue;
+            auto t = terminais.find(s);
+            if (t != terminais.end())
+                p.rhs.push_back(t->second);
+            else if (!s.empty() && isupper(static_cast<unsigned char>(s[0])))
+            {
+                p.rhs.push_back(nao_terminal(s));
+                primeira_linha.emplace(s, numero);
+            }
+            else
+            {
+                erro = "linha " + to_string(numero) + ": símbolo '" + s + "' não é uma Tag nem um não-terminal";
+                return false;
+            }
+        }
+    }
+
+    if (g.producoes.size() == 1)
+    {
+        erro = "a gramática não tem produções";
+        return false;
+    }
+
+    g.nao_terminais[0] = g.nao_terminais[1] + "'";
+    g.producoes[0].rhs = {LALR_TERMINAIS + 1};
+    g.por_lhs.assign(g.nao_terminais.size(), {});
+    for (size_t p = 0; p < g.producoes.size(); p++)
+        g.por_lhs[g.producoes[p].lhs - LALR_TERMINAIS].push_back(p);
+
+    for (size_t a = 1; a < g.nao_terminais.size(); a++)
+    {
+        if (g.por_lhs[a].empty())
+        {
+            erro = "linha " + to_string(primeira_linha[g.nao_terminais[a]]) + ": não-terminal '" + g.nao_terminais[a] +
+                   "' sem produções";
+            return false;
+        }
+    }
+    return true;
+}
+
+// ==========================
+// Construção LALR(1)
+// ==========================
+
+class Construtor
+{
+public:
+    const Gramatica &g;
+    vector<int> inicio_itens; // item (p, ponto) = inicio_itens[p] + ponto
+    vector<int> prod_do_item, ponto_do_item;
+
+    vector<char> anulavel;
+    vector<Conjunto> first;
+
+    vector<vector<int>> kernels; // itens do kernel de cada estado, ordenados
+    vector<map<int, int>> transicoes;
+
+    Construtor(const Gramatica &g) : g(g)
+    {
+        for (size_t p = 0; p < g.producoes.size(); p++)
+        {
+            inicio_itens.push_back(prod_do_item.size());
+            for (size_t d = 0; d <= g.producoes[p].rhs.size(); d++)
+            {
+                prod_do_item.push_back(p);
+                ponto_do_item.push_back(d);
+            }
+        }
+        calcular_first();
+    }
+
+    // Símbolo depois do ponto, ou -1 se o item é completo
+    int depois_do_ponto(int item) const
+    {
+        const auto &rhs = g.producoes[prod_do_item[item]].rhs;
+        int d = ponto_do_item[item];
+        return d < (int)rhs.size() ? rhs[d] : -1;
+    }
+
+    // FIRST de rhs[d..] e se essa sequência é anulável
+    Conjunto first_sequencia(const vector<int> &rhs, size_t d, bool &anula) const
+    {
+        Conjunto r = 0;
+        for (; d < rhs.size(); d++)
+        {
+            int x = rhs[d];
+            if (Gramatica::terminal(x))
+            {
+                anula = false;
+                return r | (1ULL << x);
+            }
+            r |= first[x - LALR_TERMINAIS];
+            if (!anulavel[x - LALR_TERMINAIS])
+            {
+                anula = false;
+                return r;
+            }
+        }
+        anula = true;
+        return r;
+    }
+
+    void calcular_first()
+    {
+        size_t n = g.nao_terminais.size();
+        anulavel.assign(n, 0);
+        first.assign(n, 0);
+        bool mudou = true;
+        while (mudou)
+        {
+            mudou = false;
+            for (const auto &p : g.producoes)
+            {
+                int a = p.lhs - LALR_TERMINAIS;
+                bool anula;
+                Conjunto f = first_sequencia(p.rhs, 0, anula);
+                if ((first[a] | f) != first[a])
+                {
+                    first[a] |= f;
+                    mudou = true;
+                }
+                if (anula && !anulavel[a])
+                {
+                    anulavel[a] = 1;
+                    mudou = true;
+                }
+            }
+        }
+    }
+
+    vector<int> fecho_lr0(const vector<int> &kernel) const
+    {
+        vector<int> itens = kernel;
+        vector<char> nt_visto(g.nao_terminais.size(), 0);
+        for (size_t i = 0; i < itens.size(); i++)
+        {
+            int x = depois_do_ponto(itens[i]);
+            if (x == -1 || Gramatica::terminal(x) || nt_visto[x - LALR_TERMINAIS])
+                continue;
+            nt_visto[x - LALR_TERMINAIS] = 1;
+            for (int p : g.por_lhs[x - LALR_TERMINAIS])
+                itens.push_back(inicio_itens[p]);
+        }
+        return itens;
+    }
+
+    // Fecho LR(1) com conjuntos de lookahead por item
+    map<int, Conjunto> fecho_lr1(const map<int, Conjunto> &kernel) const
+    {
+        map<int, Conjunto> itens = kernel;
+        vector<int> pendentes;
+        for (const auto &par : itens)
+            pendentes.push_back(par.first);
+        while (!pendentes.empty())
+        {
+            int item = pendentes.back();
+            pendentes.pop_back();
+            int x = depois_do_ponto(item);
+            if (x == -1 || Gramatica::terminal(x))
+                continue;
+
+            bool anula;
+            Conjunto la = first_sequencia(g.producoes[prod_do_item[item]].rhs, ponto_do_item[item] + 1, anula);
+            if (anula)
+                la |= itens[item];
+            for (int p : g.por_lhs[x - LALR_TERMINAIS])
+            {
+                Conjunto &atual = itens[inicio_itens[p]];
+                if ((atual | la) != atual)
+                {
+                    atual |= la;
+                    pendentes.push_back(inicio_itens[p]);
+                }
+            }
+        }
+        return itens;
+    }
+
+    void colecao_lr0()
+    {
+        map<vector<int>, int> ids;
+        kernels.push_back({inicio_itens[0]});
+        ids[kernels[0]] = 0;
+        for (size_t e = 0; e < kernels.size(); e++)
+        {
+            map<int, vector<int>> proximos;
+            for (int item : fecho_lr0(kernels[e]))
+            {
+                int x = depois_do_ponto(item);
+                if (x != -1)
+                    proximos[x].push_back(item + 1);
+            }
+            transicoes.emplace_back();
+            for (auto &[x, kernel] : proximos)
+            {
+                sort(kernel.begin(), kernel.end());
+                kernel.erase(unique(kernel.begin(), kernel.end()), kernel.end());
+                auto it = ids.find(kernel);
+                if (it == ids.end())
+                {
+                    it = ids.emplace(kernel, kernels.size()).first;
+                    kernels.push_back(kernel);
+                }
+                transicoes[e][x] = it->second;
+            }
+        }
+    }
+
+    // Lookaheads de cada item de kernel: geração espontânea + propagação
+    vector<vector<Conjunto>> lookaheads()
+    {
+        vector<vector<Conjunto>> la(kernels.size());
+        for (size_t e = 0; e < kernels.size(); e++)
+            la[e].assign(kernels[e].size(), 0);
+        la[0][0] = 1ULL << EOF_TOKEN;
+
+        auto posicao = [&](int estado, int item)
+        { return lower_bound(kernels[estado].begin(), kernels[estado].end(), item) - kernels[estado].begin(); };
+
+        // propaga[e][k] = itens de kernel (estado, posição) que herdam de (e, k)
+        vector<vector<vector<pair<int, int>>>> propaga(kernels.size());
+        for (size_t e = 0; e < kernels.size(); e++)
+        {
+            propaga[e].resize(kernels[e].size());
+            for (size_t k = 0; k < kernels[e].size(); k++)
+            {
+                map<int, Conjunto> fecho = fecho_lr1({{kernels[e][k], 1ULL << LOOKAHEAD_MARCA}});
+                for (const auto &[item, conjunto] : fecho)
+                {
+                    int x = depois_do_ponto(item);
+                    if (x == -1)
+                        continue;
+                    int destino = transicoes[e][x];
+                    int pos = posicao(destino, item + 1);
+                    la[destino][pos] |= conjunto & ~(1ULL << LOOKAHEAD_MARCA);
+                    if (conjunto & (1ULL << LOOKAHEAD_MARCA))
+                        propaga[e][k].push_back({destino, pos});
+                }
+            }
+        }
+
+        bool mudou = true;
+        while (mudou)
+        {
+            mudou = false;
+            for (size_t e = 0; e < kernels.size(); e++)
+                for (size_t k = 0; k < kernels[e].size(); k++)
+                    for (const auto &[destino, pos] : propaga[e][k])
+                        if ((la[destino][pos] | la[e][k]) != la[destino][pos])
+                        {
+                            la[destino][pos] |= la[e][k];
+                            mudou = true;
+                        }
+        }
+        return la;
+    }
+};
+
+// Empacota linhas esparsas em um vetor único por deslocamento (first fit)
+static void empacotar(const vector<vector<pair<int, int>>> &linhas, int largura, vector<int> &base, vector<int> &check,
+                      vector<int> &valor)
+{
+    vector<int> ordem(linhas.size());
+    for (size_t i = 0; i < ordem.size(); i++)
+        ordem[i] = i;
+    stable_sort(ordem.begin(), ordem.end(), [&](int a, int b)
+                { return linhas[a].size() > linhas[b].size(); });
+
+    base.assign(linhas.size(), 0);
+    check.clear();
+    valor.clear();
+    for (int l : ordem)
+    {
+        int b = 0;
+        while (true)
+        {
+            bool cabe = true;
+            for (const auto &[col, v] : linhas[l])
+                if (b + col < (int)check.size() && check[b + col] != -1)
+                {
+                    cabe = false;
+                    break;
+                }
+            if (cabe)
+                break;
+            b++;
+        }
+        base[l] = b;
+        // Com largura > 0 sempre cabe uma linha inteira a partir da base, então
+        // a consulta de ACTION nunca precisa testar o tamanho
+        int fim = b + largura;
+        for (const auto &entrada : linhas[l])
+            fim = max(fim, b + entrada.first + 1);
+        if ((int)check.size() < fim)
+        {
+            check.resize(fim, -1);
+            valor.resize(fim, 0);
+        }
+        for (const auto &[col, v] : linhas[l])
+        {
+            check[b + col] = l;
+            valor[b + col] = v;
+        }
+    }
+}
+
+bool build_lalr(const string &bnf, LalrTables &tabelas, string &erro, LalrStats *stats)
+{
+    auto inicio_tempo = chrono::steady_clock::now();
+
+    Gramatica g;
+    if (!ler_bnf(bnf, g, erro))
+        return false;
+
+    Construtor c(g);
+    c.colecao_lr0();
+    vector<vector<Conjunto>> la = c.lookaheads();
+
+    int n = c.kernels.size();
+    int num_nt = g.nao_terminais.size();
+    vector<vector<int>> acoes(n, vector<int>(LALR_TERMINAIS, 0));
+    vector<vector<int>> desvios(n, vector<int>(num_nt, -1));
+
+    for (int e = 0; e < n; e++)
+    {
+        for (const auto &[x, destino] : c.transicoes[e])
+        {
+            if (Gramatica::terminal(x))
+                acoes[e][x] = destino + 1;
+            else
+                desvios[e][x - LALR_TERMINAIS] = destino;
+        }
+
+        map<int, Conjunto> kernel;
+        for (size_t k = 0; k < c.kernels[e].size(); k++)
+            kernel[c.kernels[e][k]] = la[e][k];
+        for (const auto &[item, conjunto] : c.fecho_lr1(kernel))
+        {
+            if (c.depois_do_ponto(item) != -1)
+                continue;
+            int p = c.prod_do_item[item];
+            for (int t = 0; t < LALR_TERMINAIS; t++)
+            {
+                if (!(conjunto & (1ULL << t)))
+                    continue;
+                int &atual = acoes[e][t];
+                if (atual == 0 || atual == -(p + 1))
+                {
+                    atual = -(p + 1);
+                    continue;
+                }
+                string outra = atual > 0 ? "shift" : "redução por " + g.texto(-atual - 1);
+                erro = "conflito no estado " + to_string(e) + " com '" + g.nome(t) + "': " + outra + " x redução por " +
+                       g.texto(p) + " (linha " + to_string(g.producoes[p].linha) + ")";
+                return false;
+            }
+        }
+    }
+
+    // Redução padrão: a mais frequente do estado, nunca a de aceitação
+    tabelas.acao_padrao.assign(n, 0);
+    vector<vector<pair<int, int>>> linhas(n);
+    for (int e = 0; e < n; e++)
+    {
+        map<int, int> contagem;
+        for (int a : acoes[e])
+            if (a < -1)
+                contagem[a]++;
+        int padrao = 0, melhor = 0;
+        for (const auto &[a, q] : contagem)
+            if (q > melhor)
+            {
+                padrao = a;
+                melhor = q;
+            }
+        tabelas.acao_padrao[e] = padrao;
+        for (int t = 0; t < LALR_TERMINAIS; t++)
+            if (acoes[e][t] != 0 && acoes[e][t] != padrao)
+                linhas[e].push_back({t, acoes[e][t]});
+    }
+    empacotar(linhas, LALR_TERMINAIS, tabelas.acao_base, tabelas.acao_check, tabelas.acao_valor);
+
+    // GOTO padrão por não-terminal (colunas indexadas pelo estado)
+    tabelas.goto_padrao.assign(num_nt, 0);
+    vector<vector<pair<int, int>>> colunas(num_nt);
+    for (int a = 0; a < num_nt; a++)
+    {
+        map<int, int> contagem;
+        for (int e = 0; e < n; e++)
+            if (desvios[e][a] != -1)
+                contagem[desvios[e][a]]++;
+        int padrao = 0, melhor = 0;
+        for (const auto &[d, q] : contagem)
+            if (q > melhor)
+            {
+                padrao = d;
+                melhor = q;
+            }
+        tabelas.goto_padrao[a] = padrao;
+        for (int e = 0; e < n; e++)
+            if (desvios[e][a] != -1 && desvios[e][a] != padrao)
+                colunas[a].push_back({e, desvios[e][a]});
+    }
+    empacotar(colunas, 0, tabelas.goto_base, tabelas.goto_check, tabelas.goto_valor);
+
+    tabelas.num_estados = n;
+    tabelas.nao_terminais = g.nao_terminais;
+    tabelas.lhs.clear();
+    tabelas.tamanho.clear();
+    tabelas.producoes.clear();
+    for (size_t p = 0; p < g.producoes.size(); p++)
+    {
+        tabelas.lhs.push_back(g.producoes[p].lhs - LALR_TERMINAIS);
+        tabelas.tamanho.push_back(g.producoes[p].rhs.size());
+        tabelas.producoes.push_back(g.texto(p));
+    }
+
+    if (stats != nullptr)
+    {
+        stats->producoes = g.producoes.size();
+        stats->nao_terminais = num_nt;
+        stats->estados = n;
+        stats->entradas_densas = (size_t)n * (LALR_TERMINAIS + num_nt);
+        stats->entradas_comprimidas = tabelas.acao_padrao.size() + tabelas.acao_base.size() + tabelas.acao_check.size() +
+                                      tabelas.goto_padrao.size() + tabelas.goto_base.size() + tabelas.goto_check.size();
+        stats->ms = chrono::duration<double, milli>(chrono::steady_clock::now() - inicio_tempo).count();
+    }
+    return true;
+}
+
+// ==========================
+// Driver shift-reduce
+// ==========================
+
+bool parse_lalr(const LalrTables &tabelas, LexerBackend &lexer, string &erro, const PositionResolver *linhas, size_t *passos)
+{
+    Token eof(Tag::EOF_TOKEN, "$");
+    auto proximo = [&](Token *anterior)
+    {
+        Token *tok = lexer.scan();
+        if (tok != nullptr)
+            return tok;
+        if (anterior != nullptr)
+            eof.offset = anterior->offset + anterior->lexeme.size();
+        return &eof;
+    };
+    auto local = [&](const Token *tok)
+    {
+        return linhas != nullptr ? " (" + linhas->describe(tok->offset) + ")" : string();
+    };
+
+    vector<int> pilha = {0};
+    size_t n = 0;
+    Token *token = nullptr;
+    try
+    {
+        token = proximo(nullptr);
+        while (true)
+        {
+            Tag tag = token->tag;
+            if (Relop *relop = dynamic_cast<Relop *>(token))
+                tag = relop->relop;
+            else if (Arithop *arithop = dynamic_cast<Arithop *>(token))
+                tag = arithop->arithop;
+
+            int a = tabelas.acao(pilha.back(), tag);
+            n++;
+            if (a > 0)
+            {
+                pilha.push_back(a - 1);
+                token = proximo(token);
+            }
+            else if (a < 0)
+            {
+                int p = -a - 1;
+                if (p == 0)
+                    break;
+                pilha.resize(pilha.size() - tabelas.tamanho[p]);
+                pilha.push_back(tabelas.desvio(pilha.back(), tabelas.lhs[p]));
+            }
+            else
+            {
+                // Terminais com ação explícita neste estado
+                string esperados;
+                int e = pilha.back();
+                for (int t = 0; t < LALR_TERMINAIS; t++)
+                {
+                    if (tabelas.acao_check[tabelas.acao_base[e] + t] != e)
+                        continue;
+                    if (!esperados.empty())
+                        esperados += ", ";
+                    esperados += "'" + TAG_TO_STRING.at(static_cast<Tag>(t)) + "'";
+                }
+                erro = "Erro de sintaxe" + local(token) + ": token inesperado '" + token->toString() + "'";
+                if (!esperados.empty())
+                    erro += "; esperado " + esperados;
+                erro += ".";
+                if (passos != nullptr)
+                    *passos += n;
+                return false;
+            }
+        }
+    }
+    catch (const LexicalError &e)
+    {
+        erro = e.describe(linhas);
+        if (passos != nullptr)
+            *passos += n;
+        return false;
+    }
+    if (passos != nullptr)
+        *passos += n;
+
+    // Um '$' no meio do código também fecha S ::= MAIN $
+    if (token != &eof)
+    {
+        erro = "Erro de sintaxe" + local(token) + ": token inesperado '" + token->toString() + "' após o fim do programa.";
+        return false;
+    }
+    return true;
+}
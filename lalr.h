@@ -0,0 +1,94 @@
+/*
+ * Trabalho de Compiladores - Parser LALR(1)
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo define o gerador de tabelas LALR(1) e o driver shift-reduce,
+ * alternativa ao parser LL(1) escolhida em tempo de execução (--parser=lalr).
+ *
+ * A gramática vem de um arquivo BNF (grammar.bnf) sem a fatoração que o LL(1)
+ * exige: listas e expressões usam recursão à esquerda. Os terminais são os
+ * nomes das Tags em minúsculas (def, idfun, lparen, ...) e os não-terminais
+ * são escritos em maiúsculas. O primeiro não-terminal é o símbolo inicial.
+ *
+ * Geração: coleção LR(0), lookaheads LALR(1) por geração espontânea e
+ * propagação (livro do Dragão, 4.7.5) e tabela ACTION/GOTO. Conflitos são
+ * reportados como erro da gramática.
+ *
+ * Compressão das tabelas:
+ *   - redução padrão: em cada estado a redução mais frequente vira o padrão e
+ *     sai da linha, junto com todas as entradas de erro (o erro é detectado
+ *     no mesmo token, só que depois das reduções);
+ *   - GOTO padrão: para cada não-terminal, o destino mais frequente;
+ *   - as entradas restantes das linhas (ACTION) e colunas (GOTO) são
+ *     sobrepostas em um único vetor por deslocamento de linhas, com um vetor
+ *     de verificação que diz a qual linha cada posição pertence.
+ *
+ * Data: Outubro de 2026
+ */
+
+#ifndef LALR_H
+#define LALR_H
+
+#include "automata.h"
+#include "lexer.h"
+#include "line_index.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+const int LALR_TERMINAIS = EOF_TOKEN + 1;
+
+struct LalrStats
+{
+    int producoes = 0;
+    int nao_terminais = 0;
+    int estados = 0;
+    size_t entradas_densas = 0;       // estados x (terminais + não-terminais)
+    size_t entradas_comprimidas = 0;  // tamanho dos vetores empacotados
+    double ms = 0;
+};
+
+class LalrTables
+{
+public:
+    // Ação: 0 = erro, > 0 = shift para o estado (v - 1), < 0 = reduz a produção
+    // (-v - 1). Reduzir a produção 0 (S' ::= S) é aceitar.
+    int acao(int estado, int terminal) const
+    {
+        int i = acao_base[estado] + terminal;
+        return acao_check[i] == estado ? acao_valor[i] : acao_padrao[estado];
+    }
+
+    int desvio(int estado, int nao_terminal) const
+    {
+        int i = goto_base[nao_terminal] + estado;
+        return i < (int)goto_check.size() && goto_check[i] == nao_terminal ? goto_valor[i] : goto_padrao[nao_terminal];
+    }
+
+    int num_estados = 0;
+    vector<int> lhs;            // não-terminal de cada produção
+    vector<int> tamanho;        // tamanho do lado direito de cada produção
+    vector<string> producoes;   // texto, para depuração
+    vector<string> nao_terminais;
+
+    vector<int> acao_base, acao_padrao, acao_check, acao_valor;
+    vector<int> goto_base, goto_padrao, goto_check, goto_valor;
+};
+
+// Gera as tabelas a partir do texto BNF. Retorna false com a mensagem em erro
+// se a gramática for inválida ou não for LALR(1).
+bool build_lalr(const string &bnf, LalrTables &tabelas, string &erro, LalrStats *stats = nullptr);
+
+// Driver shift-reduce sobre os tokens do lexer (só reconhecimento, sem árvore).
+// Os tokens não são liberados: quem cria o lexer decide (ver ReleasingLexer).
+// Se passos != nullptr, soma nele o número de shifts e reduções executados.
+bool parse_lalr(const LalrTables &tabelas, LexerBackend &lexer, string &erro, const PositionResolver *linhas, size_t *passos = nullptr);
+
+#endif // LALR_H
@@ -16,9 +16,14 @@
  */
 
 #include "automata.h"
+#include "automata_profile.h"
 #include "lexer.h"
+#include "lexgen.h"
+#include "line_index.h"
 #include <sstream>
 #include <fstream>
+#include <chrono>
+#include <algorithm>
 
 using namespace std;
 
@@ -58,14 +63,14 @@ Relop::Relop(Tag tag, const string &lexeme, Tag type)
 Arithop::Arithop(Tag tag, const string &lexeme, Tag type)
     : Token(tag, lexeme), arithop(type) {}
 
-Unknown::Unknown(Tag tag, const string &lexeme, int line, int column)
-    : Token(tag, lexeme), line(line), column(column) {}
+Unknown::Unknown(Tag tag, const string &lexeme)
+    : Token(tag, lexeme) {}
 string Unknown::toString() const
 {
-    return "UNKNOWN(" + lexeme + ") at line " + to_string(line) + ", column " + to_string(column);
+    return "UNKNOWN(" + lexeme + ")";
 }
 
-Lexer::Lexer(istream &ssin) : ss(ssin), nlin(0), ncol(0)
+Lexer::Lexer(istream &ssin) : ss(ssin)
 {
     reserve(new Word(IF, "if"));
     reserve(new Word(ELSE, "else"));
@@ -100,18 +105,11 @@ Token *Lexer::scan()
     if (p == EOF)
         return nullptr;
 
+    // Nenhuma contagem de linha/coluna aqui: os tokens guardam só o offset, e a
+    // posição é calculada pelo LineIndex quando um diagnóstico é impresso
     while (isspace(p))
     {
         ss.get();
-        if (p == '\n')
-        {
-            nlin++;
-            ncol = 0;
-        }
-        else
-        {
-            ncol++;
-        }
         p = ss.peek();
     }
 
@@ -127,12 +125,13 @@ Token *Lexer::scan()
     {
         lexeme += p;
         ss.get();
-        ncol++;
         p = ss.peek();
 
         for (const auto &automataMap : automatas)
         {
-            if (run_automata(lexeme, automataMap.second))
+            bool aceito = perfil ? run_automata(lexeme, automataMap.second, perfil->automatos[automataMap.first])
+                                 : run_automata(lexeme, automataMap.second);
+            if (aceito)
             {
                 bool is_reserved = words.find(lexeme) != words.end();
                 bool best_is_reserved = words.find(best_lexeme) != words.end();
@@ -153,30 +152,41 @@ Token *Lexer::scan()
     if (!best_lexeme.empty())
     {
         int to_return = lexeme.size() - best_size;
+        if (perfil)
+            perfil->registrar_token(best_size, to_return);
         if (to_return > 0)
         {
             ss.clear();
             ss.seekg(start + streamoff(best_size));
             p = ss.peek();
-            ncol -= to_return;
         }
-        return create_token(best_tag, best_lexeme);
+        return create_token(best_tag, best_lexeme, start);
     }
 
     if (!lexeme.empty())
     {
-        return new Unknown(UNK, lexeme, nlin, ncol);
+        if (perfil)
+            perfil->desconhecidos++;
+        Token *tok = new Unknown(UNK, lexeme);
+        tok->offset = start;
+        return tok;
     }
 
     return nullptr;
 }
 
+Lexer::~Lexer()
+{
+    for (auto &[lexeme, w] : words)
+        delete w;
+}
+
 void Lexer::reserve(Token *w)
 {
     words[w->lexeme] = w;
 }
 
-Token *Lexer::create_token(Tag tag, const string &lexeme)
+static Token *new_token(Tag tag, const string &lexeme)
 {
     switch (tag)
     {
@@ -220,19 +230,213 @@ Token *Lexer::create_token(Tag tag, const string &lexeme)
     }
 }
 
-vector<Token *> analise_automatas(stringstream &ss)
+LexicalError::LexicalError(const string &lexeme, size_t offset)
+    : runtime_error("constante inteira '" + lexeme + "' fora do intervalo de int"), offset(offset)
 {
-    Lexer lexer(ss);
+}
+
+string LexicalError::describe(const PositionResolver *linhas) const
+{
+    string local = linhas != nullptr ? " (" + linhas->describe(offset) + ")" : string();
+    return "Erro léxico" + local + ": " + what() + ".";
+}
+
+Token *create_token(Tag tag, const string &lexeme, size_t offset)
+{
+    Token *tok;
+    try
+    {
+        tok = new_token(tag, lexeme);
+    }
+    catch (const out_of_range &)
+    {
+        // stoi de um NUM grande demais
+        throw LexicalError(lexeme, offset);
+    }
+    tok->offset = offset;
+    return tok;
+}
 
+// Unknown token for source[start, end)
+Token *create_unknown(const string &source, size_t start, size_t end)
+{
+    Token *tok = new Unknown(UNK, source.substr(start, end - start));
+    tok->offset = start;
+    return tok;
+}
+
+LexerBackend *make_lexer(const string &backend, stringstream &ss, const DfaTables *tabelas)
+{
+    if (backend == "automata")
+    {
+        return new Lexer(ss);
+    }
+    if (backend == "dfa" && tabelas != nullptr)
+    {
+        return new DfaLexer(*tabelas, ss.str());
+    }
+#ifdef USE_DIRECT_SCANNER
+    if (backend == "direct")
+    {
+        return new DirectLexer(ss.str());
+    }
+#endif
+#ifdef USE_FLEX
+    if (backend == "flex")
+    {
+        return new FlexBackend(ss.str());
+    }
+#endif
+    return nullptr;
+}
+
+vector<Token *> analise_lexica(LexerBackend &lexer)
+{
     vector<Token *> tokens;
     Token *tok;
-    while ((tok = lexer.scan()) != nullptr)
+    try
+    {
+        while ((tok = lexer.scan()) != nullptr)
+        {
+            tokens.push_back(tok);
+        }
+    }
+    catch (const LexicalError &)
     {
-        tokens.push_back(tok);
+        for (Token *lido : tokens)
+            delete lido;
+        throw;
     }
     return tokens;
 }
 
+vector<Token *> analise_automatas(stringstream &ss)
+{
+    Lexer lexer(ss);
+    return analise_lexica(lexer);
+}
+
+// Roda todos os backends disponíveis sobre os arquivos, confere se os tokens
+// são idênticos aos do lexer de autômatos e mede a vazão de cada um
+int compare_lexers(const vector<string> &arquivos, const DfaTables *tabelas)
+{
+    vector<string> backends = {"automata"};
+    if (tabelas != nullptr)
+        backends.push_back("dfa");
+#ifdef USE_DIRECT_SCANNER
+    backends.push_back("direct");
+#endif
+#ifdef USE_FLEX
+    backends.push_back("flex");
+#endif
+    if (backends.size() < 2)
+    {
+        cerr << "Nenhum outro backend para comparar: compile com -DUSE_FLEX/-DUSE_DIRECT_SCANNER ou informe as tabelas do backend dfa." << endl;
+        return 1;
+    }
+    vector<double> segundos(backends.size(), 0);
+    size_t bytes = 0, total_tokens = 0;
+    bool iguais = true;
+
+    for (const auto &arquivo : arquivos)
+    {
+        stringstream fonte;
+        string erro;
+        if (!readFile(arquivo, fonte, erro))
+        {
+            cerr << erro << endl;
+            return 1;
+        }
+        string texto = fonte.str();
+        bytes += texto.size();
+
+        vector<vector<Token *>> saidas;
+        for (size_t b = 0; b < backends.size(); b++)
+        {
+            stringstream ss(texto);
+            auto inicio = chrono::steady_clock::now();
+            LexerBackend *lexer = make_lexer(backends[b], ss, tabelas);
+            try
+            {
+                saidas.push_back(analise_lexica(*lexer));
+            }
+            catch (const LexicalError &e)
+            {
+                delete lexer;
+                for (auto &saida : saidas)
+                    for (Token *tok : saida)
+                        delete tok;
+                LineIndex linhas(texto);
+                cerr << arquivo << ": " << e.describe(&linhas) << endl;
+                return 1;
+            }
+            delete lexer;
+            segundos[b] += chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+        }
+        total_tokens += saidas[0].size();
+
+        for (size_t b = 1; b < backends.size(); b++)
+        {
+            size_t n = max(saidas[0].size(), saidas[b].size());
+            for (size_t i = 0; i < n; i++)
+            {
+                string esperado = i < saidas[0].size() ? saidas[0][i]->toString() + "@" + to_string(saidas[0][i]->offset) : "<fim>";
+                string obtido = i < saidas[b].size() ? saidas[b][i]->toString() + "@" + to_string(saidas[b][i]->offset) : "<fim>";
+                if (esperado != obtido)
+                {
+                    cout << "[FAIL] " << arquivo << ": token " << i << " difere: " << backends[0] << " = " << esperado
+                         << ", " << backends[b] << " = " << obtido << endl;
+                    iguais = false;
+                    break;
+                }
+            }
+        }
+
+        for (auto &saida : saidas)
+            for (Token *tok : saida)
+                delete tok;
+    }
+
+    cout << "Arquivos: " << arquivos.size() << ", bytes: " << bytes << ", tokens: " << total_tokens << endl;
+    for (size_t b = 0; b < backends.size(); b++)
+    {
+        cout << backends[b] << ": " << segundos[b] * 1000 << " ms, " << (bytes / 1e6) / segundos[b] << " MB/s, "
+             << (total_tokens / 1e6) / segundos[b] << " Mtokens/s" << endl;
+    }
+
+    // Só o reconhecimento (sem alocar tokens) dos scanners gerados: separa o
+    // custo das transições do custo de criar os objetos Token
+    if (tabelas != nullptr)
+    {
+        vector<string> textos;
+        for (const auto &arquivo : arquivos)
+        {
+            stringstream fonte;
+            string erro;
+            readFile(arquivo, fonte, erro); // já foram lidos acima
+            textos.push_back(fonte.str());
+        }
+
+        auto medir = [&](const string &nome, auto casar)
+        {
+            size_t contados = 0;
+            auto inicio = chrono::steady_clock::now();
+            for (const auto &texto : textos)
+                contados += contar_tokens(texto, casar);
+            double s = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+            cout << nome << " (só reconhecimento): " << s * 1000 << " ms, " << (bytes / 1e6) / s << " MB/s, "
+                 << (contados / 1e6) / s << " Mtokens/s" << endl;
+        };
+        medir("dfa", [tabelas](const unsigned char *p, const unsigned char *fim, const unsigned char **fim_token)
+              { return tabelas->casar(p, fim, fim_token); });
+#ifdef USE_DIRECT_SCANNER
+        medir("direct", direct_scan);
+#endif
+    }
+    cout << (iguais ? "Saídas idênticas." : "Saídas diferentes!") << endl;
+    return iguais ? 0 : 1;
+}
+
 stringstream testString()
 {
     string codigo = "def Main() { int x, y; x = 10; y = 20; if (x < y) { print(x + y); } else { print(y); } id = CallFunc(x); return; }";
@@ -240,17 +444,16 @@ stringstream testString()
     return ss;
 }
 
-stringstream readFile(const string &caminho)
+bool readFile(const string &caminho, stringstream &ss, string &erro)
 {
     ifstream arquivo(caminho);
     if (!arquivo.is_open())
     {
-        cerr << "Erro ao abrir arquivo: " << caminho << endl;
-        exit(1);
+        erro = "Erro ao abrir arquivo: " + caminho;
+        return false;
     }
-    stringstream ss;
     ss << arquivo.rdbuf();
-    return ss;
+    return true;
 }
 
 // int main(int argc, char *argv[])
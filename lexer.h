@@ -23,6 +23,7 @@
 #include <vector>
 #include <iostream>
 #include <sstream>
+#include <stdexcept>
 
 using namespace std;
 
@@ -32,6 +33,7 @@ class Token
 public:
     Tag tag;
     string lexeme;
+    size_t offset = 0; // byte offset of the first character in the source
     Token(Tag tag, const string &lexeme);
     virtual ~Token();
     virtual string toString() const;
@@ -74,31 +76,124 @@ public:
 class Unknown : public Token
 {
 public:
-    int line, column;
-    Unknown(Tag tag, const string &lexeme, int line, int column);
+    Unknown(Tag tag, const string &lexeme);
     string toString() const override;
 };
 
-// Lexer class definition
-class Lexer
+// Common interface of the lexer backends: scan() returns the next token, or
+// nullptr at the end of the input. Every backend must produce the same token
+// stream as the automata lexer.
+class LexerBackend
+{
+public:
+    virtual ~LexerBackend() {}
+    virtual Token *scan() = 0;
+};
+
+struct AutomataProfile;
+
+// Lexer class definition (automata backend)
+class Lexer : public LexerBackend
 {
 public:
     Lexer(istream &ssin);
-    Token *scan();
+    ~Lexer();
+    Token *scan() override;
+    // Conta transições, comprimentos e retrocessos em perfil (automata_profile.h)
+    void set_profile(AutomataProfile *p) { perfil = p; }
 
 private:
-    int nlin, ncol;
     istream &ss;
     unordered_map<string, Token *> words;
     char p;
+    AutomataProfile *perfil = nullptr;
 
     void reserve(Token *w);
-    Token *create_token(Tag tag, const string &lexeme);
+};
+
+// Replays an already scanned token stream (e.g. from the cache), or only
+// tokens[inicio, fim) of it
+class VectorLexer : public LexerBackend
+{
+public:
+    VectorLexer(const vector<Token *> &tokens) : tokens(tokens), fim(tokens.size()) {}
+    VectorLexer(const vector<Token *> &tokens, size_t inicio, size_t fim) : tokens(tokens), pos(inicio), fim(fim) {}
+    Token *scan() override { return pos < fim ? tokens[pos++] : nullptr; }
+
+private:
+    const vector<Token *> &tokens;
+    size_t pos = 0;
+    size_t fim;
+};
+
+// Flex backend: reentrant scanner generated from lexer.l, running with
+// yy_scan_buffer over an in-memory copy of the source. Only available when
+// compiled with -DUSE_FLEX together with lex.yy.c and flex_lexer.cpp.
+class FlexBackend : public LexerBackend
+{
+public:
+    FlexBackend(const string &source);
+    ~FlexBackend();
+    Token *scan() override;
+
+private:
+    string source;       // pristine copy (flex writes NULs into its buffer)
+    vector<char> buffer; // source + two YY_END_OF_BUFFER_CHAR
+    void *scanner;
+    void *state;
+    size_t skip_until = 0; // end of the last Unknown run
+};
+
+// Repassa os tokens de outro lexer e libera cada um duas chamadas depois de
+// entregá-lo: os parsers só guardam o token atual e o anterior, então em modo
+// sem árvore a memória não cresce com a entrada
+class ReleasingLexer : public LexerBackend
+{
+public:
+    ReleasingLexer(LexerBackend &lexer) : lexer(lexer) {}
+    ~ReleasingLexer()
+    {
+        delete anterior;
+        delete atual;
+    }
+    Token *scan() override
+    {
+        delete anterior;
+        anterior = atual;
+        atual = nullptr; // if scan throws, the destructor must not free anterior twice
+        atual = lexer.scan();
+        return atual;
+    }
+
+private:
+    LexerBackend &lexer;
+    Token *anterior = nullptr;
+    Token *atual = nullptr;
+};
+
+struct DfaTables;
+class PositionResolver;
+
+// Thrown by create_token when an accepted lexeme cannot become a token (an
+// integer constant out of the int range); every backend goes through it
+class LexicalError : public runtime_error
+{
+public:
+    size_t offset;
+    LexicalError(const string &lexeme, size_t offset);
+    // "Erro léxico (linha L, coluna C): ...", like the syntax errors
+    string describe(const PositionResolver *linhas) const;
 };
 
 // External helper functions
+Token *create_token(Tag tag, const string &lexeme, size_t offset);
+Token *create_unknown(const string &source, size_t start, size_t end);
+LexerBackend *make_lexer(const string &backend, stringstream &ss, const DfaTables *tabelas = nullptr);
+vector<Token *> analise_lexica(LexerBackend &lexer);
 vector<Token *> analise_automatas(stringstream &ss);
+int compare_lexers(const vector<string> &arquivos, const DfaTables *tabelas = nullptr);
 stringstream testString();
-stringstream readFile(const string &caminho);
+// Returns false (with the message in erro) when the file cannot be opened
+bool readFile(const string &caminho, stringstream &ss, string &erro);
 
 #endif // LEXER_H
@@ -0,0 +1,941 @@
+/*
+ * Trabalho de Compiladores - Gerador de Analisador Léxico
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo implementa a leitura da especificação, a construção de Thompson,
+ * a construção de subconjuntos, a minimização de Hopcroft, a gravação/leitura
+ * das tabelas, o DfaLexer e a emissão do scanner codificado diretamente.
+ *
+ * Data: Outubro de 2026
+ */
+
+#include "lexgen.h"
+#include "cache.h"
+#include <algorithm>
+#include <bitset>
+#include <chrono>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+// ==========================
+// Construção de Thompson
+// ==========================
+
+struct EstadoAFN
+{
+    vector<int> eps;
+    bitset<256> simbolos; // rótulo da única transição não vazia
+    int alvo = -1;
+    int regra = -1; // estado final da regra
+};
+
+struct Fragmento
+{
+    int inicio = -1, fim = -1;
+    bool valido() const { return inicio != -1; }
+};
+
+class ConstrutorAFN
+{
+public:
+    vector<EstadoAFN> estados;
+    map<string, string> definicoes;
+
+    // Constrói o fragmento de um padrão; em caso de erro, retorna um fragmento
+    // inválido e a mensagem fica em erro
+    Fragmento padrao(const string &texto, string &mensagem)
+    {
+        string expandido;
+        if (!expandir(texto, expandido, 0, mensagem))
+            return Fragmento();
+        s = expandido;
+        i = 0;
+        erro.clear();
+        Fragmento f = alternativa();
+        if (f.valido() && i < s.size())
+            falha(string("'") + s[i] + "' inesperado");
+        mensagem = erro;
+        return erro.empty() ? f : Fragmento();
+    }
+
+private:
+    string s;
+    size_t i = 0;
+    string erro;
+
+    int novo()
+    {
+        estados.emplace_back();
+        return estados.size() - 1;
+    }
+
+    Fragmento falha(const string &mensagem)
+    {
+        if (erro.empty())
+            erro = mensagem + " (posição " + to_string(i + 1) + " de \"" + s + "\")";
+        return Fragmento();
+    }
+
+    Fragmento simbolos(const bitset<256> &conjunto)
+    {
+        Fragmento f{novo(), novo()};
+        estados[f.inicio].simbolos = conjunto;
+        estados[f.inicio].alvo = f.fim;
+        return f;
+    }
+
+    Fragmento vazio()
+    {
+        Fragmento f{novo(), novo()};
+        estados[f.inicio].eps.push_back(f.fim);
+        return f;
+    }
+
+    // Substitui {NOME} pela definição entre parênteses, fora de aspas e colchetes
+    bool expandir(const string &texto, string &saida, int profundidade, string &mensagem)
+    {
+        if (profundidade > 32)
+        {
+            mensagem = "definições recursivas em \"" + texto + "\"";
+            return false;
+        }
+        bool aspas = false, colchete = false;
+        for (size_t k = 0; k < texto.size(); k++)
+        {
+            char c = texto[k];
+            if (c == '\\' && k + 1 < texto.size())
+            {
+                saida += c;
+                saida += texto[++k];
+                continue;
+            }
+            if (aspas)
+                aspas = c != '"';
+            else if (colchete)
+                colchete = c != ']' || saida.back() == '[' || saida.back() == '^';
+            else if (c == '"')
+                aspas = true;
+            else if (c == '[')
+                colchete = true;
+            else if (c == '{')
+            {
+                size_t fecha = texto.find('}', k);
+                if (fecha == string::npos)
+                {
+                    mensagem = "'{' sem '}' em \"" + texto + "\"";
+                    return false;
+                }
+                string nome = texto.substr(k + 1, fecha - k - 1);
+                auto it = definicoes.find(nome);
+                if (it == definicoes.end())
+                {
+                    mensagem = "definição {" + nome + "} desconhecida (repetições {n,m} não são suportadas)";
+                    return false;
+                }
+                saida += '(';
+                if (!expandir(it->second, saida, profundidade + 1, mensagem))
+                    return false;
+                saida += ')';
+                k = fecha;
+                continue;
+            }
+            saida += c;
+        }
+        return true;
+    }
+
+    unsigned char escape()
+    {
+        // s[i] é o caractere depois da barra
+        char c = s[i++];
+        switch (c)
+        {
+        case 'n':
+            return '\n';
+        case 't':
+            return '\t';
+        case 'r':
+            return '\r';
+        case 'v':
+            return '\v';
+        case 'f':
+            return '\f';
+        case 'a':
+            return '\a';
+        case 'b':
+            return '\b';
+        case '0':
+            return '\0';
+        default:
+            return c;
+        }
+    }
+
+    Fragmento alternativa()
+    {
+        Fragmento f = concatenacao();
+        while (f.valido() && i < s.size() && s[i] == '|')
+        {
+            i++;
+            Fragmento g = concatenacao();
+            if (!g.valido())
+                return g;
+            Fragmento u{novo(), novo()};
+            estados[u.inicio].eps = {f.inicio, g.inicio};
+            estados[f.fim].eps.push_back(u.fim);
+            estados[g.fim].eps.push_back(u.fim);
+            f = u;
+        }
+        return f;
+    }
+
+    Fragmento concatenacao()
+    {
+        Fragmento f;
+        while (i < s.size() && s[i] != '|' && s[i] != ')')
+        {
+            Fragmento g = repeticao();
+            if (!g.valido())
+                return g;
+            if (!f.valido())
+                f = g;
+            else
+            {
+                estados[f.fim].eps.push_back(g.inicio);
+                f.fim = g.fim;
+            }
+        }
+        return f.valido() ? f : vazio();
+    }
+
+    Fragmento repeticao()
+    {
+        Fragmento f = atomo();
+        while (f.valido() && i < s.size() && (s[i] == '*' || s[i] == '+' || s[i] == '?'))
+        {
+            char op = s[i++];
+            Fragmento r{novo(), novo()};
+            estados[r.inicio].eps.push_back(f.inicio);
+            if (op != '+')
+                estados[r.inicio].eps.push_back(r.fim);
+            if (op != '?')
+                estados[f.fim].eps.push_back(f.inicio);
+            estados[f.fim].eps.push_back(r.fim);
+            f = r;
+        }
+        return f;
+    }
+
+    Fragmento atomo()
+    {
+        char c = s[i];
+        bitset<256> conjunto;
+        switch (c)
+        {
+        case '(':
+        {
+            i++;
+            Fragmento f = alternativa();
+            if (!f.valido())
+                return f;
+            if (i >= s.size() || s[i] != ')')
+                return falha("')' esperado");
+            i++;
+            return f;
+        }
+        case '"':
+        {
+            i++;
+            Fragmento f = vazio();
+            while (i < s.size() && s[i] != '"')
+            {
+                unsigned char ch = s[i] == '\\' && i + 1 < s.size() ? (i++, escape()) : s[i++];
+                conjunto.reset();
+                conjunto.set(ch);
+                Fragmento g = simbolos(conjunto);
+                estados[f.fim].eps.push_back(g.inicio);
+                f.fim = g.fim;
+            }
+            if (i >= s.size())
+                return falha("'\"' sem fechamento");
+            i++;
+            return f;
+        }
+        case '[':
+            return classe();
+        case '.':
+            i++;
+            conjunto.set();
+            conjunto.reset('\n');
+            return simbolos(conjunto);
+        case '\\':
+            if (i + 1 >= s.size())
+                return falha("'\\' no fim do padrão");
+            i++;
+            conjunto.set(escape());
+            return simbolos(conjunto);
+        case '*':
+        case '+':
+        case '?':
+        case '|':
+        case ')':
+            return falha(string("'") + c + "' sem operando");
+        default:
+            i++;
+            conjunto.set(static_cast<unsigned char>(c));
+            return simbolos(conjunto);
+        }
+    }
+
+    Fragmento classe()
+    {
+        i++; // '['
+        bool negada = i < s.size() && s[i] == '^';
+        if (negada)
+            i++;
+
+        bitset<256> conjunto;
+        bool primeiro = true;
+        while (i < s.size() && (s[i] != ']' || primeiro))
+        {
+            primeiro = false;
+            unsigned char de = s[i] == '\\' && i + 1 < s.size() ? (i++, escape()) : s[i++];
+            unsigned char ate = de;
+            if (i + 1 < s.size() && s[i] == '-' && s[i + 1] != ']')
+            {
+                i++;
+                ate = s[i] == '\\' && i + 1 < s.size() ? (i++, escape()) : s[i++];
+                if (ate < de)
+                    return falha("intervalo invertido na classe");
+            }
+            for (int ch = de; ch <= ate; ch++)
+                conjunto.set(ch);
+        }
+        if (i >= s.size())
+            return falha("']' esperado");
+        i++;
+        if (negada)
+            conjunto.flip();
+        return simbolos(conjunto);
+    }
+};
+
+// ==========================
+// Leitura da especificação
+// ==========================
+
+struct Regra
+{
+    string padrao;
+    int16_t tag; // Tag ou LEX_IGNORA
+    int linha;
+};
+
+static bool ler_especificacao(const string &texto, map<string, string> &definicoes, vector<Regra> &regras, string &erro)
+{
+    // Nomes das Tags como aparecem nas ações ("return DEF;")
+    unordered_map<string, int16_t> nomes_tags;
+    for (const auto &par : TAG_TO_STRING)
+        nomes_tags[par.second] = par.first;
+    nomes_tags["EOF_TOKEN"] = EOF_TOKEN;
+
+    istringstream in(texto);
+    string linha;
+    int numero = 0;
+    int secao = 0; // 0 = definições, 1 = regras
+    bool codigo = false, comentario = false;
+
+    while (getline(in, linha))
+    {
+        numero++;
+        if (codigo)
+        {
+            codigo = linha.rfind("%}", 0) != 0;
+            continue;
+        }
+        if (comentario)
+        {
+            comentario = linha.find("*/") == string::npos;
+            continue;
+        }
+        if (linha.rfind("%%", 0) == 0)
+        {
+            if (++secao == 2)
+                break;
+            continue;
+        }
+        if (linha.rfind("%{", 0) == 0)
+        {
+            codigo = true;
+            continue;
+        }
+        // Linhas vazias, indentadas (código no flex) e opções são ignoradas
+        if (linha.empty() || isspace(static_cast<unsigned char>(linha[0])) || linha[0] == '%')
+            continue;
+        if (linha.rfind("/*", 0) == 0)
+        {
+            comentario = linha.find("*/") == string::npos;
+            continue;
+        }
+
+        if (secao == 0)
+        {
+            size_t fim_nome = 0;
+            while (fim_nome < linha.size() && !isspace(static_cast<unsigned char>(linha[fim_nome])))
+                fim_nome++;
+            size_t inicio = linha.find_first_not_of(" \t", fim_nome);
+            if (inicio == string::npos)
+            {
+                erro = "linha " + to_string(numero) + ": definição sem expressão";
+                return false;
+            }
+            size_t fim = linha.find_last_not_of(" \t\r");
+            definicoes[linha.substr(0, fim_nome)] = linha.substr(inicio, fim - inicio + 1);
+            continue;
+        }
+
+        // O padrão termina no primeiro espaço fora de aspas, colchetes ou escape
+        size_t k = 0;
+        bool aspas = false, colchete = false;
+        for (; k < linha.size(); k++)
+        {
+            char c = linha[k];
+            if (c == '\\')
+            {
+                k++;
+                continue;
+            }
+            if (aspas)
+                aspas = c != '"';
+            else if (colchete)
+                colchete = c != ']';
+            else if (c == '"')
+                aspas = true;
+            else if (c == '[')
+                colchete = true;
+            else if (isspace(static_cast<unsigned char>(c)))
+                break;
+        }
+
+        Regra regra;
+        regra.padrao = linha.substr(0, k);
+        regra.linha = numero;
+        regra.tag = LEX_IGNORA;
+
+        string acao = k < linha.size() ? linha.substr(k) : "";
+        size_t ret = acao.find("return");
+        if (ret != string::npos)
+        {
+            size_t inicio = acao.find_first_not_of(" \t", ret + 6);
+            size_t fim = inicio;
+            while (fim < acao.size() && (isalnum(static_cast<unsigned char>(acao[fim])) || acao[fim] == '_'))
+                fim++;
+            string nome = inicio == string::npos ? "" : acao.substr(inicio, fim - inicio);
+            auto it = nomes_tags.find(nome);
+            if (it == nomes_tags.end())
+            {
+                erro = "linha " + to_string(numero) + ": ação retorna '" + nome + "', que não é uma Tag";
+                return false;
+            }
+            regra.tag = it->second;
+        }
+        regras.push_back(regra);
+    }
+
+    if (regras.empty())
+    {
+        erro = "a especificação não tem regras";
+        return false;
+    }
+    return true;
+}
+
+// ==========================
+// AFN -> AFD -> AFD mínimo
+// ==========================
+
+static void fecho(const vector<EstadoAFN> &afn, vector<int> &conjunto, vector<int> &visto, int marca)
+{
+    vector<int> pilha(conjunto);
+    for (int q : conjunto)
+        visto[q] = marca;
+    while (!pilha.empty())
+    {
+        int q = pilha.back();
+        pilha.pop_back();
+        for (int r : afn[q].eps)
+        {
+            if (visto[r] != marca)
+            {
+                visto[r] = marca;
+                conjunto.push_back(r);
+                pilha.push_back(r);
+            }
+        }
+    }
+    sort(conjunto.begin(), conjunto.end());
+}
+
+// Refinamento de partição de Hopcroft. Retorna o bloco de cada estado.
+static vector<int> hopcroft(int n, int num_classes, const vector<int32_t> &trans, const vector<int16_t> &aceita)
+{
+    // Predecessores de cada (estado, classe)
+    vector<vector<int>> inversa(n * num_classes);
+    for (int q = 0; q < n; q++)
+        for (int c = 0; c < num_classes; c++)
+            inversa[trans[q * num_classes + c] * num_classes + c].push_back(q);
+
+    // Partição inicial: um bloco por valor de aceitação
+    vector<vector<int>> blocos;
+    vector<int> bloco_de(n);
+    map<int16_t, int> por_aceita;
+    for (int q = 0; q < n; q++)
+    {
+        auto it = por_aceita.find(aceita[q]);
+        if (it == por_aceita.end())
+        {
+            it = por_aceita.emplace(aceita[q], blocos.size()).first;
+            blocos.emplace_back();
+        }
+        bloco_de[q] = it->second;
+        blocos[it->second].push_back(q);
+    }
+
+    vector<int> trabalho;
+    vector<char> em_trabalho(blocos.size(), 1);
+    for (size_t b = 0; b < blocos.size(); b++)
+        trabalho.push_back(b);
+
+    vector<char> em_x(n, 0);
+    vector<int> contagem;
+    while (!trabalho.empty())
+    {
+        int a = trabalho.back();
+        trabalho.pop_back();
+        em_trabalho[a] = 0;
+        vector<int> divisor = blocos[a];
+
+        for (int c = 0; c < num_classes; c++)
+        {
+            // X = estados que vão para o divisor pela classe c
+            vector<int> x;
+            for (int q : divisor)
+                for (int p : inversa[q * num_classes + c])
+                    if (!em_x[p])
+                    {
+                        em_x[p] = 1;
+                        x.push_back(p);
+                    }
+            if (x.empty())
+                continue;
+
+            contagem.assign(blocos.size(), 0);
+            vector<int> tocados;
+            for (int p : x)
+                if (contagem[bloco_de[p]]++ == 0)
+                    tocados.push_back(bloco_de[p]);
+
+            for (int y : tocados)
+            {
+                if (contagem[y] == (int)blocos[y].size())
+                    continue;
+                vector<int> dentro, fora;
+                for (int q : blocos[y])
+                    (em_x[q] ? dentro : fora).push_back(q);
+
+                int novo = blocos.size();
+                blocos[y] = fora;
+                blocos.push_back(dentro);
+                em_trabalho.push_back(0);
+                for (int q : dentro)
+                    bloco_de[q] = novo;
+
+                if (em_trabalho[y])
+                {
+                    trabalho.push_back(novo);
+                    em_trabalho[novo] = 1;
+                }
+                else
+                {
+                    int menor = dentro.size() <= fora.size() ? novo : y;
+                    trabalho.push_back(menor);
+                    em_trabalho[menor] = 1;
+                }
+            }
+
+            for (int p : x)
+                em_x[p] = 0;
+        }
+    }
+    return bloco_de;
+}
+
+bool compile_lexer_spec(const string &especificacao, DfaTables &tabelas, string &erro, LexGenStats *stats)
+{
+    auto inicio_tempo = chrono::steady_clock::now();
+
+    ConstrutorAFN construtor;
+    vector<Regra> regras;
+    if (!ler_especificacao(especificacao, construtor.definicoes, regras, erro))
+        return false;
+
+    // Estado inicial comum ligado ao início de cada regra
+    construtor.estados.emplace_back();
+    for (size_t r = 0; r < regras.size(); r++)
+    {
+        string mensagem;
+        Fragmento f = construtor.padrao(regras[r].padrao, mensagem);
+        if (!f.valido())
+        {
+            erro = "linha " + to_string(regras[r].linha) + ": " + mensagem;
+            return false;
+        }
+        construtor.estados[0].eps.push_back(f.inicio);
+        construtor.estados[f.fim].regra = r;
+    }
+    const vector<EstadoAFN> &afn = construtor.estados;
+
+    // Classes de equivalência: bytes com a mesma assinatura de pertinência a
+    // todos os rótulos do AFN são indistinguíveis
+    vector<bitset<256>> rotulos;
+    for (const auto &q : afn)
+        if (q.alvo != -1 && find(rotulos.begin(), rotulos.end(), q.simbolos) == rotulos.end())
+            rotulos.push_back(q.simbolos);
+
+    map<vector<bool>, int> assinaturas;
+    vector<int> representante;
+    for (int c = 0; c < 256; c++)
+    {
+        vector<bool> assinatura(rotulos.size());
+        for (size_t r = 0; r < rotulos.size(); r++)
+            assinatura[r] = rotulos[r][c];
+        auto it = assinaturas.find(assinatura);
+        if (it == assinaturas.end())
+        {
+            it = assinaturas.emplace(assinatura, representante.size()).first;
+            representante.push_back(c);
+        }
+        tabelas.classe[c] = it->second;
+    }
+    int num_classes = representante.size();
+
+    // Construção de subconjuntos; o conjunto vazio é o estado morto 0
+    map<vector<int>, int> ids;
+    vector<vector<int>> conjuntos = {{}};
+    ids[{}] = 0;
+    vector<int> visto(afn.size(), -1);
+    int marca = 0;
+
+    vector<int> inicial = {0};
+    fecho(afn, inicial, visto, marca++);
+    ids[inicial] = 1;
+    conjuntos.push_back(inicial);
+
+    vector<int32_t> trans;
+    vector<int16_t> aceita;
+    for (size_t d = 0; d < conjuntos.size(); d++)
+    {
+        int regra = -1;
+        for (int q : conjuntos[d])
+            if (afn[q].regra != -1 && (regra == -1 || afn[q].regra < regra))
+                regra = afn[q].regra;
+        aceita.push_back(regra == -1 ? LEX_NENHUMA : regras[regra].tag);
+
+        for (int c = 0; c < num_classes; c++)
+        {
+            vector<int> destino;
+            for (int q : conjuntos[d])
+                if (afn[q].alvo != -1 && afn[q].simbolos[representante[c]])
+                    destino.push_back(afn[q].alvo);
+            fecho(afn, destino, visto, marca++);
+
+            auto it = ids.find(destino);
+            if (it == ids.end())
+            {
+                it = ids.emplace(destino, conjuntos.size()).first;
+                conjuntos.push_back(destino);
+            }
+            trans.push_back(it->second);
+        }
+
+        if (d == 1 && regra != -1)
+        {
+            erro = "linha " + to_string(regras[regra].linha) + ": o padrão \"" + regras[regra].padrao + "\" aceita a cadeia vazia";
+            return false;
+        }
+    }
+    int n = conjuntos.size();
+
+    // Minimização; os blocos são renumerados com o morto em 0
+    vector<int> bloco_de = hopcroft(n, num_classes, trans, aceita);
+    vector<int> novo_id(n, -1);
+    vector<int> representante_bloco;
+    for (int q = 0; q < n; q++)
+    {
+        int b = bloco_de[q];
+        if (novo_id[b] == -1)
+        {
+            novo_id[b] = representante_bloco.size();
+            representante_bloco.push_back(q);
+        }
+    }
+
+    tabelas.num_classes = num_classes;
+    tabelas.num_estados = representante_bloco.size();
+    tabelas.inicial = novo_id[bloco_de[1]];
+    tabelas.transicoes.assign(tabelas.num_estados * num_classes, 0);
+    tabelas.aceita.assign(tabelas.num_estados, LEX_NENHUMA);
+    for (int e = 0; e < tabelas.num_estados; e++)
+    {
+        int q = representante_bloco[e];
+        tabelas.aceita[e] = aceita[q];
+        for (int c = 0; c < num_classes; c++)
+            tabelas.transicoes[e * num_classes + c] = novo_id[bloco_de[trans[q * num_classes + c]]];
+    }
+
+    if (stats != nullptr)
+    {
+        stats->regras = regras.size();
+        stats->estados_afn = afn.size();
+        stats->estados_afd = n;
+        stats->estados_minimos = tabelas.num_estados;
+        stats->classes = num_classes;
+        stats->ms = chrono::duration<double, milli>(chrono::steady_clock::now() - inicio_tempo).count();
+    }
+    return true;
+}
+
+// ==========================
+// Formato binário
+// ==========================
+
+static const char TABLES_MAGIC[4] = {'L', 'X', 'T', '1'};
+
+struct LexTablesHeader
+{
+    char magic[4];
+    uint32_t num_estados;
+    uint32_t num_classes;
+    uint32_t inicial;
+    uint64_t checksum; // XXH64 do restante do arquivo
+    uint64_t reservado;
+};
+
+static_assert(sizeof(LexTablesHeader) == 32, "LexTablesHeader deve ter layout fixo");
+
+static string corpo_tabelas(const DfaTables &t)
+{
+    string corpo(reinterpret_cast<const char *>(t.classe), sizeof(t.classe));
+    corpo.append(reinterpret_cast<const char *>(t.transicoes.data()), t.transicoes.size() * sizeof(int32_t));
+    corpo.append(reinterpret_cast<const char *>(t.aceita.data()), t.aceita.size() * sizeof(int16_t));
+    return corpo;
+}
+
+bool DfaTables::save(const string &caminho, string &erro) const
+{
+    string corpo = corpo_tabelas(*this);
+    LexTablesHeader h = {};
+    memcpy(h.magic, TABLES_MAGIC, 4);
+    h.num_estados = num_estados;
+    h.num_classes = num_classes;
+    h.inicial = inicial;
+    h.checksum = xxhash64(corpo.data(), corpo.size(), 0);
+
+    ofstream out(caminho, ios::binary);
+    out.write(reinterpret_cast<const char *>(&h), sizeof(h));
+    out.write(corpo.data(), corpo.size());
+    if (!out)
+    {
+        erro = "não foi possível gravar " + caminho;
+        return false;
+    }
+    return true;
+}
+
+bool DfaTables::load(const string &caminho, string &erro)
+{
+    ifstream in(caminho, ios::binary);
+    if (!in)
+    {
+        erro = "não foi possível abrir " + caminho;
+        return false;
+    }
+    string dados((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+
+    LexTablesHeader h;
+    if (dados.size() < sizeof(h))
+    {
+        erro = caminho + ": arquivo de tabelas truncado";
+        return false;
+    }
+    memcpy(&h, dados.data(), sizeof(h));
+    uint64_t esperado = sizeof(h) + 256 + (uint64_t)h.num_estados * h.num_classes * sizeof(int32_t) + (uint64_t)h.num_estados * sizeof(int16_t);
+    if (memcmp(h.magic, TABLES_MAGIC, 4) != 0 || h.num_classes == 0 || h.num_classes > 256 || h.inicial >= h.num_estados ||
+        dados.size() != esperado || xxhash64(dados.data() + sizeof(h), dados.size() - sizeof(h), 0) != h.checksum)
+    {
+        erro = caminho + ": arquivo de tabelas inválido";
+        return false;
+    }
+
+    const char *p = dados.data() + sizeof(h);
+    memcpy(classe, p, 256);
+    p += 256;
+    transicoes.resize((size_t)h.num_estados * h.num_classes);
+    memcpy(transicoes.data(), p, transicoes.size() * sizeof(int32_t));
+    p += transicoes.size() * sizeof(int32_t);
+    aceita.resize(h.num_estados);
+    memcpy(aceita.data(), p, aceita.size() * sizeof(int16_t));
+
+    // Confere os índices para o scanner nunca sair da tabela
+    bool ok = true;
+    for (int c = 0; c < 256; c++)
+        ok = ok && classe[c] < h.num_classes;
+    for (int32_t t : transicoes)
+        ok = ok && t >= 0 && t < (int32_t)h.num_estados;
+    for (int16_t a : aceita)
+        ok = ok && a >= LEX_IGNORA && a <= EOF_TOKEN;
+    if (!ok)
+    {
+        erro = caminho + ": arquivo de tabelas inválido";
+        return false;
+    }
+
+    num_estados = h.num_estados;
+    num_classes = h.num_classes;
+    inicial = h.inicial;
+    return true;
+}
+
+// ==========================
+// DfaLexer
+// ==========================
+
+DfaLexer::DfaLexer(const DfaTables &tabelas, const string &source) : tabelas(tabelas), source(source) {}
+
+Token *DfaLexer::scan()
+{
+    return proximo_token(source, pos, [this](const unsigned char *p, const unsigned char *fim, const unsigned char **fim_token)
+                         { return tabelas.casar(p, fim, fim_token); });
+}
+
+// ==========================
+// Scanner codificado diretamente
+// ==========================
+
+static string nome_tag(int tag)
+{
+    if (tag == LEX_IGNORA)
+        return "LEX_IGNORA";
+    if (tag == EOF_TOKEN)
+        return "EOF_TOKEN";
+    return TAG_TO_STRING.at(static_cast<Tag>(tag));
+}
+
+static string literal_byte(int c)
+{
+    char buf[8];
+    if (isgraph(c) && c != '\'' && c != '\\')
+        snprintf(buf, sizeof(buf), "'%c'", c);
+    else
+        snprintf(buf, sizeof(buf), "0x%02x", c);
+    return buf;
+}
+
+struct Intervalo
+{
+    int de, ate, alvo;
+};
+
+// Árvore de busca binária sobre os intervalos [l, r] da linha de um estado
+static void emitir_intervalos(const vector<Intervalo> &iv, int l, int r, const string &recuo, ostream &out)
+{
+    if (l == r)
+    {
+        out << recuo << (iv[l].alvo == 0 ? "goto fim;" : "goto s" + to_string(iv[l].alvo) + ";") << "\n";
+        return;
+    }
+    int meio = (l + r + 1) / 2;
+    out << recuo << "if (c < " << literal_byte(iv[meio].de) << ")\n";
+    out << recuo << "{\n";
+    emitir_intervalos(iv, l, meio - 1, recuo + "    ", out);
+    out << recuo << "}\n";
+    emitir_intervalos(iv, meio, r, recuo, out);
+}
+
+void emit_direct_scanner(const DfaTables &tabelas, const string &origem, ostream &out)
+{
+    out << "/*\n"
+        << " * Scanner codificado diretamente, gerado por --emit-scanner a partir de " << origem << ".\n"
+        << " * Não editar: gere de novo após mudar a especificação.\n"
+        << " */\n\n"
+        << "#include \"lexgen.h\"\n\n"
+        << "int direct_scan(const unsigned char *p, const unsigned char *fim, const unsigned char **fim_token)\n"
+        << "{\n"
+        << "    int tag = LEX_NENHUMA;\n"
+        << "    unsigned char c;\n"
+        << "    goto s" << tabelas.inicial << ";\n";
+
+    for (int e = 1; e < tabelas.num_estados; e++)
+    {
+        out << "s" << e << ":\n";
+        if (tabelas.aceita[e] != LEX_NENHUMA)
+            out << "    tag = " << nome_tag(tabelas.aceita[e]) << ";\n"
+                << "    *fim_token = p;\n";
+
+        // Bytes consecutivos com o mesmo destino viram um intervalo
+        vector<Intervalo> iv;
+        for (int c = 0; c < 256; c++)
+        {
+            int alvo = tabelas.proximo(e, c);
+            if (!iv.empty() && iv.back().alvo == alvo)
+                iv.back().ate = c;
+            else
+                iv.push_back(Intervalo{c, c, alvo});
+        }
+        if (iv.size() == 1 && iv[0].alvo == 0)
+        {
+            out << "    goto fim;\n";
+            continue;
+        }
+        out << "    if (p == fim)\n"
+            << "        goto fim;\n"
+            << "    c = *p++;\n";
+
+        // Poucos intervalos: comparações em árvore. Muitos (o estado inicial,
+        // por exemplo): switch com intervalos de case, que o compilador pode
+        // transformar em tabela de saltos
+        if (iv.size() <= 8)
+        {
+            emitir_intervalos(iv, 0, iv.size() - 1, "    ", out);
+            continue;
+        }
+        out << "    switch (c)\n"
+            << "    {\n";
+        for (const auto &i : iv)
+        {
+            if (i.alvo == 0)
+                continue;
+            out << "    case " << literal_byte(i.de);
+            if (i.ate != i.de)
+                out << " ... " << literal_byte(i.ate);
+            out << ":\n"
+                << "        goto s" << i.alvo << ";\n";
+        }
+        out << "    default:\n"
+            << "        goto fim;\n"
+            << "    }\n";
+    }
+
+    out << "fim:\n"
+        << "    return tag;\n"
+        << "}\n";
+}
@@ -0,0 +1,207 @@
+/*
+ * Trabalho de Compiladores - Gerador de Analisador Léxico
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo define o gerador de analisador léxico em tempo de execução: lê
+ * uma especificação com a mesma sintaxe de regras do lexer.l e produz as
+ * tabelas de um AFD mínimo, usadas pelo backend "dfa".
+ *
+ * Etapas:
+ *   1. cada regra vira um AFN pela construção de Thompson; as regras são
+ *      unidas por um estado inicial comum e cada estado final lembra a regra;
+ *   2. os bytes são agrupados em classes de equivalência (bytes que nenhuma
+ *      regra distingue caem na mesma classe), reduzindo as colunas da tabela;
+ *   3. construção de subconjuntos gera o AFD; um estado do AFD aceita a regra
+ *      de menor índice entre os estados finais do AFN que contém (como no flex);
+ *   4. minimização de Hopcroft, partindo da partição por regra aceita.
+ *
+ * O resultado é uma tabela densa num_estados x num_classes. O estado 0 é o
+ * estado morto (todas as transições voltam para ele), então o laço do scanner
+ * só precisa testar "estado != 0".
+ *
+ * As tabelas podem ser gravadas em um arquivo binário e carregadas na
+ * inicialização, sem recompilar a especificação:
+ *
+ *   cabeçalho (LexTablesHeader, 32 bytes)
+ *   classe[256]                 uint8, classe de cada byte
+ *   transicoes[estados*classes] int32
+ *   aceita[estados]             int16, Tag aceita, -1 = nenhuma, -2 = ignorar
+ *
+ * Data: Outubro de 2026
+ */
+
+#ifndef LEXGEN_H
+#define LEXGEN_H
+
+#include "automata.h"
+#include "lexer.h"
+#include <cctype>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+const int16_t LEX_NENHUMA = -1; // estado não aceita
+const int16_t LEX_IGNORA = -2;  // regra com ação vazia (espaços)
+
+struct DfaTables
+{
+    uint8_t classe[256] = {};
+    int num_classes = 0;
+    int num_estados = 0;
+    int inicial = 0;
+    vector<int32_t> transicoes; // transicoes[estado * num_classes + classe]
+    vector<int16_t> aceita;
+
+    int proximo(int estado, unsigned char c) const { return transicoes[estado * num_classes + classe[c]]; }
+
+    // Casamento mais longo a partir de p: anda até o estado morto lembrando o
+    // último estado final. Retorna a Tag (ou LEX_NENHUMA) e o fim em fim_token.
+    int casar(const unsigned char *p, const unsigned char *fim, const unsigned char **fim_token) const
+    {
+        int estado = inicial;
+        int tag = LEX_NENHUMA;
+        while (p < fim)
+        {
+            estado = proximo(estado, *p++);
+            if (estado == 0)
+                break;
+            if (aceita[estado] != LEX_NENHUMA)
+            {
+                tag = aceita[estado];
+                *fim_token = p;
+            }
+        }
+        return tag;
+    }
+
+    bool save(const string &caminho, string &erro) const;
+    bool load(const string &caminho, string &erro);
+};
+
+struct LexGenStats
+{
+    int regras = 0;
+    int estados_afn = 0;
+    int estados_afd = 0; // antes da minimização
+    int estados_minimos = 0;
+    int classes = 0;
+    double ms = 0;
+};
+
+// Compila o texto de uma especificação no formato do lexer.l. Retorna false
+// com a mensagem em erro se a especificação for inválida.
+bool compile_lexer_spec(const string &especificacao, DfaTables &tabelas, string &erro, LexGenStats *stats = nullptr);
+
+// Laço comum dos scanners gerados. casar(inicio, fim, &fim_token) devolve a
+// Tag do casamento mais longo a partir de inicio (LEX_NENHUMA se nenhum prefixo
+// casa) e onde ele termina. Como no lexer de autômatos, uma sequência sem
+// espaços que não casa vira um único Unknown até o próximo espaço.
+template <typename Casar>
+Token *proximo_token(const string &source, size_t &pos, Casar casar)
+{
+    const unsigned char *base = reinterpret_cast<const unsigned char *>(source.data());
+    size_t n = source.size();
+    while (pos < n)
+    {
+        const unsigned char *fim_token = base + pos;
+        int tag = casar(base + pos, base + n, &fim_token);
+        size_t fim = fim_token - base;
+
+        if (tag == LEX_IGNORA)
+        {
+            pos = fim;
+            continue;
+        }
+        if (tag == LEX_NENHUMA && isspace(base[pos]))
+        {
+            pos++;
+            continue;
+        }
+        if (tag == LEX_NENHUMA || tag == UNK)
+        {
+            size_t inicio = pos;
+            while (pos < n && !isspace(base[pos]))
+                pos++;
+            return create_unknown(source, inicio, pos);
+        }
+
+        Token *tok = create_token(static_cast<Tag>(tag), source.substr(pos, fim - pos), pos);
+        pos = fim;
+        return tok;
+    }
+    return nullptr;
+}
+
+// Mesmo laço sem criar tokens: só conta, para medir o reconhecimento isolado
+template <typename Casar>
+size_t contar_tokens(const string &source, Casar casar)
+{
+    const unsigned char *p = reinterpret_cast<const unsigned char *>(source.data());
+    const unsigned char *fim = p + source.size();
+    size_t tokens = 0;
+    while (p < fim)
+    {
+        const unsigned char *fim_token = p;
+        int tag = casar(p, fim, &fim_token);
+        if (tag == LEX_NENHUMA || tag == UNK)
+        {
+            if (tag == LEX_NENHUMA && isspace(*p))
+            {
+                p++;
+                continue;
+            }
+            while (p < fim && !isspace(*p))
+                p++;
+            tokens++;
+            continue;
+        }
+        tokens += tag != LEX_IGNORA;
+        p = fim_token;
+    }
+    return tokens;
+}
+
+// Backend léxico que percorre as tabelas geradas com casamento mais longo
+class DfaLexer : public LexerBackend
+{
+public:
+    DfaLexer(const DfaTables &tabelas, const string &source);
+    Token *scan() override;
+
+private:
+    const DfaTables &tabelas;
+    string source;
+    size_t pos = 0;
+};
+
+// Gera um scanner codificado diretamente (estilo re2c): cada estado do AFD é
+// um rótulo e as transições são comparações de intervalos de bytes (árvore de
+// busca binária, ou switch com intervalos de case nos estados com muitos
+// intervalos), sem tabela. A função gerada se chama direct_scan.
+void emit_direct_scanner(const DfaTables &tabelas, const string &origem, ostream &out);
+
+// Função gerada por emit_direct_scanner (direct_scanner.cpp)
+int direct_scan(const unsigned char *p, const unsigned char *fim, const unsigned char **fim_token);
+
+// Backend sobre o scanner gerado. Só disponível quando compilado com
+// -DUSE_DIRECT_SCANNER junto com direct_scanner.cpp.
+class DirectLexer : public LexerBackend
+{
+public:
+    DirectLexer(const string &source) : source(source) {}
+    Token *scan() override { return proximo_token(source, pos, direct_scan); }
+
+private:
+    string source;
+    size_t pos = 0;
+};
+
+#endif // LEXGEN_H
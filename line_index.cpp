@@ -0,0 +1,68 @@
+/*
+ * Trabalho de Compiladores - Índice de Linhas
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo implementa o índice de linhas. A busca pelos '\n' compara 16
+ * bytes por vez com SSE2 e só olha bit a bit as máscaras que têm algum '\n'.
+ *
+ * Data: Outubro de 2026
+ */
+
+#include "line_index.h"
+#include <algorithm>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+void LineIndex::build() const
+{
+    inicios.clear();
+    inicios.push_back(0);
+
+    const char *dados = fonte.data();
+    size_t n = fonte.size();
+    size_t i = 0;
+
+#ifdef __SSE2__
+    const __m128i quebra = _mm_set1_epi8('\n');
+    for (; i + 16 <= n; i += 16)
+    {
+        __m128i bloco = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dados + i));
+        unsigned mascara = _mm_movemask_epi8(_mm_cmpeq_epi8(bloco, quebra));
+        while (mascara != 0)
+        {
+            inicios.push_back(i + __builtin_ctz(mascara) + 1);
+            mascara &= mascara - 1;
+        }
+    }
+#endif
+
+    for (; i < n; i++)
+    {
+        if (dados[i] == '\n')
+            inicios.push_back(i + 1);
+    }
+    pronto = true;
+}
+
+Posicao LineIndex::locate(size_t offset) const
+{
+    if (!pronto)
+        build();
+
+    // Última linha que começa em offset ou antes
+    size_t linha = upper_bound(inicios.begin(), inicios.end(), offset) - inicios.begin();
+    return Posicao{linha, offset - inicios[linha - 1] + 1};
+}
+
+string LineIndex::describe(size_t offset) const
+{
+    Posicao p = locate(offset);
+    return "linha " + to_string(p.linha) + ", coluna " + to_string(p.coluna);
+}
@@ -0,0 +1,75 @@
+/*
+ * Trabalho de Compiladores - Índice de Linhas
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Os tokens guardam apenas o offset em bytes no código-fonte. Este arquivo
+ * define o índice que converte um offset em linha/coluna. O índice (início de
+ * cada linha) só é construído na primeira consulta, ou seja, quando algum
+ * diagnóstico é de fato impresso; a busca é binária.
+ *
+ * Data: Outubro de 2026
+ */
+
+#ifndef LINE_INDEX_H
+#define LINE_INDEX_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+struct Posicao
+{
+    size_t linha;  // a partir de 1
+    size_t coluna; // a partir de 1, em bytes
+};
+
+// Converte offsets em posições legíveis para os diagnósticos
+class PositionResolver
+{
+public:
+    virtual ~PositionResolver() {}
+    // "linha L, coluna C"
+    virtual string describe(size_t offset) const = 0;
+};
+
+// Texto lido em blocos por uma janela que só anda para a frente (o
+// StreamInput); os offsets são sempre a partir do início do texto e describe
+// vale para os que ainda estão na janela
+class BlockSource : public PositionResolver
+{
+public:
+    // A janela é [window_begin(), window_end()), começando no offset window_offset()
+    virtual const char *window_begin() const = 0;
+    virtual const char *window_end() const = 0;
+    virtual size_t window_offset() const = 0;
+    // Descarta a janela antes do offset manter e acrescenta o próximo bloco
+    // (os ponteiros da janela mudam); false no fim do texto
+    virtual bool next_block(size_t manter) = 0;
+};
+
+class LineIndex : public PositionResolver
+{
+public:
+    // O código-fonte precisa continuar vivo enquanto o índice for usado
+    LineIndex(string_view fonte) : fonte(fonte) {}
+
+    Posicao locate(size_t offset) const;
+    string describe(size_t offset) const override;
+
+private:
+    string_view fonte;
+    // Montado na primeira consulta: um LineIndex não deve ser compartilhado entre threads
+    mutable vector<size_t> inicios; // offset do início de cada linha
+    mutable bool pronto = false;
+
+    void build() const;
+};
+
+#endif // LINE_INDEX_H
@@ -0,0 +1,130 @@
+/*
+ * Trabalho de Compiladores - Análise Sintática Paralela
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo implementa a divisão dos tokens por função, a análise de cada
+ * trecho no pool e a junção das subárvores.
+ *
+ * Data: Outubro de 2026
+ */
+
+#include "parallel_parse.h"
+#include "alloc_profile.h"
+
+// Índice do "def" que abre cada função de nível 0
+static vector<size_t> dividir(const vector<Token *> &tokens)
+{
+    vector<size_t> inicios;
+    int profundidade = 0;
+    for (size_t i = 0; i < tokens.size(); i++)
+    {
+        switch (tokens[i]->tag)
+        {
+        case LBRACE:
+            profundidade++;
+            break;
+        case RBRACE:
+            profundidade--;
+            break;
+        case DEF:
+            if (profundidade == 0)
+                inicios.push_back(i);
+            break;
+        default:
+            break;
+        }
+    }
+    return inicios;
+}
+
+// S ::= MAIN $, MAIN ::= FLIST, FLIST ::= FDEF FLIST_, FLIST_ ::= FDEF FLIST_ | ε
+// com as subárvores FDEF já prontas
+static ParseNode *juntar(const vector<ParseNode *> &funcoes)
+{
+    ParseNode *raiz = new ParseNode(NT_S);
+    raiz->producao = PROD_S_0;
+    ParseNode *main = new ParseNode(NT_MAIN);
+    main->producao = PROD_MAIN_FLIST;
+    raiz->filhos = {main, new ParseNode(Tag::EOF_TOKEN)};
+
+    ParseNode *lista = new ParseNode(NT_FLIST);
+    lista->producao = PROD_FLIST_FDEF;
+    main->filhos = {lista};
+
+    ParseNode *resto = new ParseNode(NT_FLIST_);
+    lista->filhos = {funcoes[0], resto};
+    for (size_t k = 1; k < funcoes.size(); k++)
+    {
+        ParseNode *proximo = new ParseNode(NT_FLIST_);
+        resto->producao = PROD_FLIST__FDEF;
+        resto->filhos = {funcoes[k], proximo};
+        resto = proximo;
+    }
+    resto->producao = PROD_FLIST__EPSILON;
+    return raiz;
+}
+
+bool parse_parallel(ThreadPool &pool, const vector<Token *> &tokens, ParseNode **arvore, string &erro,
+                    const PositionResolver *linhas, size_t *passos, ParallelParseStats *stats)
+{
+    vector<size_t> inicios = dividir(tokens);
+    if (inicios.empty() || inicios[0] != 0)
+    {
+        VectorLexer lexer(tokens);
+        return parse_tokens(lexer, arvore, false, erro, linhas, passos);
+    }
+
+    size_t n = inicios.size();
+    vector<ParseNode *> funcoes(n, nullptr);
+    vector<char> aceito(n, 0);
+    vector<size_t> passos_trecho(n, 0);
+    pool.parallel_for(n, [&](size_t k)
+                      {
+                          AllocPhase anterior = set_alloc_phase(FASE_SINTATICO);
+                          size_t fim = k + 1 < n ? inicios[k + 1] : tokens.size();
+                          VectorLexer lexer(tokens, inicios[k], fim);
+                          string erro_trecho; // a mensagem certa vem da reanálise
+                          aceito[k] = parse_tokens(lexer, arvore != nullptr ? &funcoes[k] : nullptr, false, erro_trecho,
+                                                   nullptr, &passos_trecho[k], NT_FDEF);
+                          set_alloc_phase(anterior);
+                      });
+    if (stats != nullptr)
+        stats->trechos = n;
+
+    size_t falha = find(aceito.begin(), aceito.end(), 0) - aceito.begin();
+    if (falha < n)
+    {
+        for (ParseNode *f : funcoes)
+            free_parse_tree(f);
+
+        // Antes do trecho com erro o parser sequencial estaria com "FLIST_ $"
+        // na pilha (ou no início, com S)
+        VectorLexer lexer(tokens, inicios[falha], tokens.size());
+        if (stats != nullptr)
+            stats->reanalise = tokens.size() - inicios[falha];
+        if (!parse_tokens(lexer, nullptr, false, erro, linhas, nullptr, falha == 0 ? NT_S : NT_FLIST_))
+            return false;
+
+        // Não deveria acontecer: na dúvida, vale o resultado sequencial completo
+        VectorLexer completo(tokens);
+        erro.clear();
+        return parse_tokens(completo, arvore, false, erro, linhas, passos);
+    }
+
+    if (passos != nullptr)
+    {
+        // S, MAIN e FLIST, um FLIST_ por função (o último vira ε) e o
+        // interior de cada FDEF
+        *passos += 3 + n;
+        for (size_t p : passos_trecho)
+            *passos += p;
+    }
+    if (arvore != nullptr)
+        *arvore = juntar(funcoes);
+    return true;
+}
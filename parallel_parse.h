@@ -0,0 +1,51 @@
+/*
+ * Trabalho de Compiladores - Análise Sintática Paralela
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo define a análise sintática paralela por função. Um programa
+ * FLIST é uma sequência de FDEF, cada uma começando em "def". Os tokens são
+ * divididos nos "def" de profundidade de chaves 0 e cada trecho é analisado
+ * a partir de NT_FDEF em um pool de threads. As subárvores são ligadas na
+ * ordem do código sob os nós S, MAIN, FLIST e FLIST_, formando exatamente a
+ * árvore que o parser sequencial montaria.
+ *
+ * Diagnósticos: se algum trecho falha, o primeiro trecho com erro (na ordem
+ * do código) é reanalisado sequencialmente com o mesmo estado de pilha que o
+ * parser sequencial teria ali (FLIST_ $, ou S no primeiro trecho). Como todos
+ * os trechos anteriores estão corretos, a mensagem é idêntica à do modo
+ * sequencial. Programas que não começam com "def" (MAIN ::= STMT ou vazio)
+ * vão direto para o parser sequencial.
+ *
+ * Data: Outubro de 2026
+ */
+
+#ifndef PARALLEL_PARSE_H
+#define PARALLEL_PARSE_H
+
+#include "automata.h"
+#include "lexer.h"
+#include "line_index.h"
+#include "parser.h"
+#include "thread_pool.h"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+struct ParallelParseStats
+{
+    size_t trechos = 0;    // funções analisadas em paralelo (0 = caiu no sequencial)
+    size_t reanalise = 0;  // tokens reanalisados sequencialmente para o diagnóstico
+};
+
+// Mesmo contrato de parse_tokens (sem o passo a passo de debug) sobre um
+// vetor de tokens já lido
+bool parse_parallel(ThreadPool &pool, const vector<Token *> &tokens, ParseNode **arvore, string &erro,
+                    const PositionResolver *linhas, size_t *passos = nullptr, ParallelParseStats *stats = nullptr);
+
+#endif // PARALLEL_PARSE_H
@@ -17,140 +17,42 @@
 #include <string>
 #include "automata.h"
 #include "lexer.h"
+#include "parser.h"
+#include "ast.h"
+#include "ir.h"
+#include "cache.h"
+#include "line_index.h"
+#include "stream_input.h"
+#include "lexgen.h"
+#include "lalr.h"
+#include "alloc_profile.h"
+#include "fuzz.h"
+#include "pipeline.h"
+#include "parallel_parse.h"
+#include "recognizer.h"
+#include "xref.h"
+#include "automata_bulk.h"
+#include "file_loader.h"
+#include "structural.h"
+#include "evaluator.h"
+#include "c_backend.h"
+#include "compressed_input.h"
+#include "parser_api.h"
+#include "automata_profile.h"
+#include <fcntl.h>
+#include <glob.h>
+#include <unistd.h>
+#include <fstream>
+#include <iomanip>
+#include <chrono>
+#include <memory>
 #include <variant>
 #include <unordered_map>
 #include <stack>
 #include <algorithm>
 
-const int NUM_NONTERMINALS = 30;
-const int NUM_TERMINALS = 30;
-
-enum NonTerminals
-{
-    NT_S = 0,
-    NT_MAIN = 1,
-    NT_FLIST = 2,
-    NT_FLIST_ = 3,
-    NT_FDEF = 4,
-    NT_PARLIST = 5,
-    NT_PARLIST_ = 6,
-    NT_VARLIST = 7,
-    NT_VARLIST_ = 8,
-    NT_STMT = 9,
-    NT_ATRIBST = 10,
-    NT_ATRIBST_ = 11,
-    NT_FCALL = 12,
-    NT_PARLISTCALL = 13,
-    NT_PARLISTCALL_ = 14,
-    NT_PRINTST = 15,
-    NT_RETURNST = 16,
-    NT_RETURNST_ = 17,
-    NT_IFSTMT = 18,
-    NT_IFSTMT_ = 19,
-    NT_STMTLIST = 20,
-    NT_EXPR = 21,
-    NT_EXPR_ = 22,
-    NT_NUMEXPR = 23,
-    NT_NUMEXPR_ = 24,
-    NT_TERM = 25,
-    NT_TERM_ = 26,
-    NT_FACTOR = 27
-};
-
-enum Productions
-{
-    EMPTY = 0,
-    PROD_S_0, // S ::= MAIN $
-
-    PROD_MAIN_EPSILON, // MAIN ::= ε
-    PROD_MAIN_FLIST,   // MAIN ::= FLIST
-    PROD_MAIN_STMT,    // MAIN ::= STMT
-
-    PROD_FLIST_FDEF, // FLIST ::= FDEF FLIST_
-
-    PROD_FLIST__EPSILON, // FLIST_ ::= ε
-    PROD_FLIST__FDEF,    // FLIST_ ::= FDEF
-
-    PROD_FDEF_DEF, // FDEF ::= def IDFUN lparen PARLIST rparen lbrace STMTLIST rbrace
-
-    PROD_PARLIST_INT,     // PARLIST ::= int id PARLIST_
-    PROD_PARLIST_EPSILON, // PARLIST ::= ε
-
-    PROD_PARLIST__COMMA,   // PARLIST_ ::= comma int id PARLIST_
-    PROD_PARLIST__EPSILON, // PARLIST_ ::= ε
-
-    PROD_VARLIST_ID, // VARLIST ::= id VARLIST_
-
-    PROD_VARLIST__COMMA,   // VARLIST_ ::= comma id VARLIST_
-    PROD_VARLIST__EPSILON, // VARLIST_ ::= ε
-
-    PROD_STMT_INT,       // STMT ::= int VARLIST semicolon
-    PROD_STMT_ATRIBST,   // STMT ::= ATRIBST semicolon
-    PROD_STMT_BLOCK,     // STMT ::= lbrace STMTLIST rbrace
-    PROD_STMT_SEMICOLON, // STMT ::= semicolon
-    PROD_STMT_PRINT,     // STMT ::= PRINTST semicolon
-    PROD_STMT_RETURN,    // STMT ::= RETURNST semicolon
-    PROD_STMT_IF,        // STMT ::= IFSTMT
-
-    PROD_ATRIBST_ID, // ATRIBST ::= id assign ATRIBST_
-
-    PROD_ATRIBST__FCALL, // ATRIBST_ ::= FCALL
-    PROD_ATRIBST__EXPR,  // ATRIBST_ ::= EXPR
-
-    PROD_FCALL_IDFUN, // FCALL ::= idfun lparen PARLISTCALL rparen
-
-    PROD_PARLISTCALL_ID, // PARLISTCALL ::= id PARLISTCALL_
-
-    PROD_PARLISTCALL__EPSILON, // PARLISTCALL_ ::= ε
-    PROD_PARLISTCALL__COMMA,   // PARLISTCALL_ ::= comma id PARLISTCALL_
-
-    PROD_PRINTST_PRINT, // PRINTST ::= print EXPR
-
-    PROD_RETURNST_RETURN, // RETURNST ::= return RETURNST_
-
-    PROD_RETURNST__ID,      // RETURNST_ ::= id
-    PROD_RETURNST__EPSILON, // RETURNST_ ::= ε
-
-    PROD_IFSTMT_IF, // IFSTMT ::= if lparen EXPR rparen lbrace STMT rbrace IFSTMT_
-
-    PROD_IFSTMT__EPSILON, // IFSTMT_ ::= ε
-    PROD_IFSTMT__ELSE,    // IFSTMT_ ::= else lbrace STMT rbrace
-
-    PROD_STMTLIST_STMT,    // STMTLIST ::= STMT STMTLIST
-    PROD_STMTLIST_EPSILON, // STMTLIST ::= ε
-
-    PROD_EXPR_NUMEXPR, // EXPR ::= NUMEXPR EXPR_
-
-    PROD_EXPR__EPSILON, // EXPR_ ::= ε
-    PROD_EXPR__LT,      // EXPR_ ::= lt NUMEXPR
-    PROD_EXPR__LE,      // EXPR_ ::= le NUMEXPR
-    PROD_EXPR__GT,      // EXPR_ ::= gt NUMEXPR
-    PROD_EXPR__GE,      // EXPR_ ::= ge NUMEXPR
-    PROD_EXPR__EQ,      // EXPR_ ::= eq NUMEXPR
-    PROD_EXPR__NE,      // EXPR_ ::= ne NUMEXPR
-
-    PROD_NUMEXPR_TERM, // NUMEXPR ::= TERM NUMEXPR_
-
-    PROD_NUMEXPR__EPSILON, // NUMEXPR_ ::= ε
-    PROD_NUMEXPR__PLUS,    // NUMEXPR_ ::= plus TERM NUMEXPR_
-    PROD_NUMEXPR__MINUS,   // NUMEXPR_ ::= minus TERM NUMEXPR_
-
-    PROD_TERM_FACTOR, // TERM ::= FACTOR TERM_
-
-    PROD_TERM__EPSILON, // TERM_ ::= ε
-    PROD_TERM__TIMES,   // TERM_ ::= times FACTOR TERM_
-    PROD_TERM__DIVIDE,  // TERM_ ::= divide FACTOR TERM_
-
-    PROD_FACTOR_NUMEXPR, // FACTOR ::= lparen NUMEXPR rparen
-    PROD_FACTOR_ID,      // FACTOR ::= id
-    PROD_FACTOR_NUM,     // FACTOR ::= num
-};
-
-Productions ll1_table[NUM_NONTERMINALS][NUM_TERMINALS];
-using Symbol = variant<Tag, NonTerminals>;
-
 // Define quais tokens uma producao tem
-std::unordered_map<Productions, std::vector<Symbol>> productionsMap = {
+const std::unordered_map<Productions, std::vector<Symbol>> productionsMap = {
     {PROD_S_0, {NonTerminals::NT_MAIN, Tag::EOF_TOKEN}}, // S ::= MAIN $
 
     {PROD_MAIN_EPSILON, {}},                     // MAIN ::= ε
@@ -160,7 +62,7 @@ std::unordered_map<Productions, std::vector<Symbol>> productionsMap = {
     {PROD_FLIST_FDEF, {NonTerminals::NT_FDEF, NonTerminals::NT_FLIST_}}, // FLIST ::= FDEF FLIST_
 
     {PROD_FLIST__EPSILON, {}},                   // FLIST_ ::= ε
-    {PROD_FLIST__FDEF, {NonTerminals::NT_FDEF}}, // FLIST_ ::= FDEF
+    {PROD_FLIST__FDEF, {NonTerminals::NT_FDEF, NonTerminals::NT_FLIST_}}, // FLIST_ ::= FDEF FLIST_
 
     {PROD_FDEF_DEF, {Tag::DEF, Tag::IDFUN, Tag::LPAREN, NonTerminals::NT_PARLIST, Tag::RPAREN, Tag::LBRACE, NonTerminals::NT_STMTLIST, Tag::RBRACE}}, // FDEF ::= def IDFUN lparen PARLIST rparen lbrace STMTLIST rbrace
 
@@ -182,6 +84,7 @@ std::unordered_map<Productions, std::vector<Symbol>> productionsMap = {
     {PROD_STMT_PRINT, {NonTerminals::NT_PRINTST, Tag::SEMICOLON}},            // STMT ::= PRINTST semicolon
     {PROD_STMT_RETURN, {NonTerminals::NT_RETURNST, Tag::SEMICOLON}},          // STMT ::= RETURNST semicolon
     {PROD_STMT_IF, {NonTerminals::NT_IFSTMT}},                                // STMT ::= IFSTMT
+    {PROD_STMT_FCALL, {NonTerminals::NT_FCALL, Tag::SEMICOLON}},              // STMT ::= FCALL semicolon
 
     {PROD_ATRIBST_ID, {Tag::ID, Tag::ASSIGN, NonTerminals::NT_ATRIBST_}}, // ATRIBST ::= id assign ATRIBST_
     {PROD_ATRIBST__FCALL, {NonTerminals::NT_FCALL}},                      // ATRIBST_ ::= FCALL
@@ -232,7 +135,7 @@ std::unordered_map<Productions, std::vector<Symbol>> productionsMap = {
 };
 
 // Mapeia os não-terminais para strings de debug
-std::unordered_map<NonTerminals, std::string> NON_TERMINAL_TO_STRING = {
+const std::unordered_map<NonTerminals, std::string> NON_TERMINAL_TO_STRING = {
     {NT_S, "S"},
     {NT_MAIN, "MAIN"},
     {NT_FLIST, "FLIST"},
@@ -263,14 +166,14 @@ std::unordered_map<NonTerminals, std::string> NON_TERMINAL_TO_STRING = {
     {NT_FACTOR, "FACTOR"}};
 
 // Mapeia as produções para strings de debug
-std::unordered_map<Productions, std::string> PRODUCTIONS_TO_STRING = {
+const std::unordered_map<Productions, std::string> PRODUCTIONS_TO_STRING = {
     {PROD_S_0, "S ::= MAIN $"},
     {PROD_MAIN_EPSILON, "MAIN ::= ε"},
     {PROD_MAIN_FLIST, "MAIN ::= FLIST"},
     {PROD_MAIN_STMT, "MAIN ::= STMT"},
     {PROD_FLIST_FDEF, "FLIST ::= FDEF FLIST_"},
     {PROD_FLIST__EPSILON, "FLIST_ ::= ε"},
-    {PROD_FLIST__FDEF, "FLIST_ ::= FDEF"},
+    {PROD_FLIST__FDEF, "FLIST_ ::= FDEF FLIST_"},
     {PROD_FDEF_DEF, "FDEF ::= def IDFUN lparen PARLIST rparen lbrace STMTLIST rbrace"},
     {PROD_PARLIST_INT, "PARLIST ::= int id comma PARLIST_"},
     {PROD_PARLIST_EPSILON, "PARLIST ::= ε"},
@@ -286,6 +189,7 @@ std::unordered_map<Productions, std::string> PRODUCTIONS_TO_STRING = {
     {PROD_STMT_PRINT, "STMT ::= PRINTST semicolon"},
     {PROD_STMT_RETURN, "STMT ::= RETURNST semicolon"},
     {PROD_STMT_IF, "STMT ::= IFSTMT"},
+    {PROD_STMT_FCALL, "STMT ::= FCALL semicolon"},
     {PROD_ATRIBST_ID, "ATRIBST ::= id assign ATRIBST_"},
     {PROD_ATRIBST__FCALL, "ATRIBST_ ::= FCALL"},
     {PROD_ATRIBST__EXPR, "ATRIBST_ ::= EXPR"},
@@ -322,16 +226,34 @@ std::unordered_map<Productions, std::string> PRODUCTIONS_TO_STRING = {
     {PROD_FACTOR_ID, "FACTOR ::= id"},
     {PROD_FACTOR_NUM, "FACTOR ::= num"}};
 
+// Tabela LL(1) e lados direitos indexados pela produção. É montada uma única
+// vez (static local, inicialização segura entre threads) e depois só lida, então
+// várias threads podem analisar ao mesmo tempo sem travas
+struct LL1Table
+{
+    Productions celulas[NUM_NONTERMINALS][NUM_TERMINALS] = {};
+    vector<Symbol> producoes[PROD_FACTOR_NUM + 1];
+};
+
 // Cria a tabela LL(1) para a gramática
-void initialize_ll1_table()
+static LL1Table construir_ll1_table()
 {
+    LL1Table tabela;
+    for (const auto &[prod, lado_direito] : productionsMap)
+        tabela.producoes[prod] = lado_direito;
+    auto &ll1_table = tabela.celulas;
+
     // S
     ll1_table[NT_S][EOF_TOKEN] = PROD_S_0;
     ll1_table[NT_S][DEF] = PROD_S_0;
     ll1_table[NT_S][LBRACE] = PROD_S_0;
     ll1_table[NT_S][SEMICOLON] = PROD_S_0;
     ll1_table[NT_S][PRINT] = PROD_S_0;
+    ll1_table[NT_S][RETURN] = PROD_S_0;
     ll1_table[NT_S][IF] = PROD_S_0;
+    ll1_table[NT_S][INT] = PROD_S_0;
+    ll1_table[NT_S][ID] = PROD_S_0;
+    ll1_table[NT_S][IDFUN] = PROD_S_0;
 
     // MAIN
     ll1_table[NT_MAIN][EOF_TOKEN] = PROD_MAIN_EPSILON;
@@ -341,6 +263,9 @@ void initialize_ll1_table()
     ll1_table[NT_MAIN][PRINT] = PROD_MAIN_STMT;
     ll1_table[NT_MAIN][RETURN] = PROD_MAIN_STMT;
     ll1_table[NT_MAIN][IF] = PROD_MAIN_STMT;
+    ll1_table[NT_MAIN][INT] = PROD_MAIN_STMT;
+    ll1_table[NT_MAIN][ID] = PROD_MAIN_STMT;
+    ll1_table[NT_MAIN][IDFUN] = PROD_MAIN_STMT;
 
     // FLIST
     ll1_table[NT_FLIST][DEF] = PROD_FLIST_FDEF;
@@ -375,6 +300,7 @@ void initialize_ll1_table()
     ll1_table[NT_STMT][PRINT] = PROD_STMT_PRINT;
     ll1_table[NT_STMT][RETURN] = PROD_STMT_RETURN;
     ll1_table[NT_STMT][IF] = PROD_STMT_IF;
+    ll1_table[NT_STMT][IDFUN] = PROD_STMT_FCALL;
 
     // ATRIBST
     ll1_table[NT_ATRIBST][ID] = PROD_ATRIBST_ID;
@@ -416,6 +342,9 @@ void initialize_ll1_table()
     ll1_table[NT_IFSTMT_][PRINT] = PROD_IFSTMT__EPSILON;
     ll1_table[NT_IFSTMT_][RETURN] = PROD_IFSTMT__EPSILON;
     ll1_table[NT_IFSTMT_][IF] = PROD_IFSTMT__EPSILON;
+    ll1_table[NT_IFSTMT_][INT] = PROD_IFSTMT__EPSILON;
+    ll1_table[NT_IFSTMT_][ID] = PROD_IFSTMT__EPSILON;
+    ll1_table[NT_IFSTMT_][IDFUN] = PROD_IFSTMT__EPSILON;
     ll1_table[NT_IFSTMT_][ELSE] = PROD_IFSTMT__ELSE;
 
     // STMTLIST
@@ -427,6 +356,7 @@ void initialize_ll1_table()
     ll1_table[NT_STMTLIST][PRINT] = PROD_STMTLIST_STMT;
     ll1_table[NT_STMTLIST][RETURN] = PROD_STMTLIST_STMT;
     ll1_table[NT_STMTLIST][IF] = PROD_STMTLIST_STMT;
+    ll1_table[NT_STMTLIST][IDFUN] = PROD_STMTLIST_STMT;
 
     // EXPR
     ll1_table[NT_EXPR][LPAREN] = PROD_EXPR_NUMEXPR;
@@ -483,6 +413,28 @@ void initialize_ll1_table()
     ll1_table[NT_FACTOR][LPAREN] = PROD_FACTOR_NUMEXPR;
     ll1_table[NT_FACTOR][ID] = PROD_FACTOR_ID;
     ll1_table[NT_FACTOR][NUM] = PROD_FACTOR_NUM;
+    return tabela;
+}
+
+static const LL1Table &ll1_table()
+{
+    static const LL1Table tabela = construir_ll1_table();
+    return tabela;
+}
+
+void initialize_ll1_table()
+{
+    ll1_table();
+}
+
+Productions ll1_entry(NonTerminals nt, Tag t)
+{
+    return ll1_table().celulas[nt][t];
+}
+
+const vector<Symbol> &production_symbols(Productions p)
+{
+    return ll1_table().producoes[p];
 }
 
 inline bool is_tag(const Symbol &sym, Tag tag)
@@ -509,7 +461,7 @@ inline Productions get_matrix(const NonTerminals &nt, const Tag &t)
         throw std::out_of_range("Índice fora do intervalo da tabela LL(1)");
     }
 
-    return ll1_table[nt][t];
+    return ll1_table().celulas[nt][t];
 }
 
 inline void print_stack(const std::stack<Symbol> &parseStack)
@@ -533,105 +485,1188 @@ inline void print_stack(const std::stack<Symbol> &parseStack)
          << endl;
 }
 
-int main(int argc, char *argv[])
+
+// Versão da ferramenta; incrementar quando a saída mudar sem a gramática mudar
+const uint64_t TOOL_VERSION = 3;
+
+uint64_t grammar_fingerprint()
 {
-    initialize_ll1_table();
+    // Lados direitos de todas as produções seguidos da tabela LL(1)
+    vector<int> dados = {(int)TOOL_VERSION};
+    for (int p = PROD_S_0; p <= PROD_FACTOR_NUM; p++)
+    {
+        auto it = productionsMap.find((Productions)p);
+        dados.push_back(-1);
+        if (it == productionsMap.end())
+            continue;
+        for (const auto &sym : it->second)
+            dados.push_back(std::holds_alternative<Tag>(sym) ? std::get<Tag>(sym) : 1000 + std::get<NonTerminals>(sym));
+    }
+    for (int nt = 0; nt < NUM_NONTERMINALS; nt++)
+        for (int t = 0; t < NUM_TERMINALS; t++)
+            dados.push_back(ll1_table().celulas[nt][t]);
+    return xxhash64(dados.data(), dados.size() * sizeof(int), 0);
+}
 
-    std::stringstream ss;
-    if (argc < 2)
+string ll1_error_terminal(const string &local, const Token &token, Tag esperado)
+{
+    return "Erro de sintaxe" + local + ": símbolo terminal inesperado '" + token.toString() + "' ao invés de '" + TAG_TO_STRING.at(esperado) + "'.";
+}
+
+string ll1_error_nonterminal(const string &local, const Token &token, NonTerminals nt)
+{
+    return "Erro de sintaxe" + local + ": símbolo não terminal '" + NON_TERMINAL_TO_STRING.at(nt) + "' não é seguido de '" + token.toString() + "'.";
+}
+
+string ll1_error_trailing(const string &local, const Token &token)
+{
+    return "Erro de sintaxe" + local + ": token inesperado '" + token.toString() + "' após o fim do programa.";
+}
+
+void free_parse_tree(ParseNode *raiz)
+{
+    if (raiz == nullptr)
+        return;
+    vector<ParseNode *> pendentes = {raiz};
+    while (!pendentes.empty())
     {
-        cout << "Nenhum arquivo informado, usando código de teste padrão.\n";
-        ss = testString();
+        ParseNode *node = pendentes.back();
+        pendentes.pop_back();
+        pendentes.insert(pendentes.end(), node->filhos.begin(), node->filhos.end());
+        delete node;
+    }
+}
+
+// Constrói a árvore de derivação em paralelo com a pilha de símbolos: cada
+// símbolo empilhado tem um nó correspondente, preenchido quando é expandido
+// (não-terminal) ou casado com um token (terminal).
+// Os tokens são puxados do lexer um a um, então léxico e sintático andam juntos.
+bool parse_tokens(LexerBackend &lexer, ParseNode **arvore, bool debug, string &erro, const PositionResolver *linhas, size_t *passos,
+                  NonTerminals inicio)
+{
+    std::stack<Symbol> parseStack;
+    std::stack<ParseNode *> nodeStack;
+    bool montar_arvore = arvore != nullptr;
+
+    // S ::= MAIN $ já empilha o $; partindo de outro não-terminal, ele vem antes
+    if (inicio != NT_S)
+    {
+        parseStack.push(Tag::EOF_TOKEN);
+        nodeStack.push(nullptr);
     }
+    ParseNode *raiz = montar_arvore ? new ParseNode(inicio) : nullptr;
+    parseStack.push(inicio); // símbolo inicial da gramática
+    nodeStack.push(raiz);
+
+    Token eof(Tag::EOF_TOKEN, "$"); // token EOF ao final para facilitar o processamento
+    auto proximo = [&](Token *anterior)
+    {
+        Token *tok = lexer.scan();
+        if (tok != nullptr)
+            return tok;
+        if (anterior != nullptr)
+            eof.offset = anterior->offset + anterior->lexeme.size();
+        return &eof;
+    };
+
+    // Posição só é calculada quando há erro a reportar
+    auto local = [&](const Token *tok)
+    {
+        return linhas != nullptr ? " (" + linhas->describe(tok->offset) + ")" : string();
+    };
+    Token *token = nullptr;
+    try
+    {
+        token = proximo(nullptr);
+        Symbol currentSymbol = parseStack.top();
+
+        while (!is_tag(currentSymbol, EOF_TOKEN))
+        {
+            if (passos != nullptr)
+                (*passos)++;
+            Tag tag = token->tag;
+            if (Relop *relopToken = dynamic_cast<Relop *>(token))
+            {
+                tag = relopToken->relop;
+            }
+            else if (Arithop *arithopToken = dynamic_cast<Arithop *>(token))
+            {
+                tag = arithopToken->arithop;
+            }
+
+            if (is_tag(currentSymbol, tag))
+            {
+                parseStack.pop();
+                if (montar_arvore)
+                    nodeStack.top()->token = token;
+                nodeStack.pop();
+                if (debug)
+                    cout << token->toString() << "( " << token->lexeme << " )" << endl;
+
+                token = proximo(token);
+            }
+            else if (is_terminal(currentSymbol))
+            {
+                erro = ll1_error_terminal(local(token), *token, std::get<Tag>(currentSymbol));
+                free_parse_tree(raiz);
+                return false;
+            }
+            else if (get_matrix(std::get<NonTerminals>(currentSymbol), tag) == EMPTY)
+            {
+                erro = ll1_error_nonterminal(local(token), *token, std::get<NonTerminals>(currentSymbol));
+                free_parse_tree(raiz);
+                return false;
+            }
+            else
+            {
+                Productions prod = get_matrix(std::get<NonTerminals>(currentSymbol), tag);
+                const vector<Symbol> &production = ll1_table().producoes[prod];
+
+                parseStack.pop();
+                ParseNode *node = nodeStack.top();
+                nodeStack.pop();
+                if (montar_arvore)
+                {
+                    node->producao = prod;
+                    for (const auto &sym : production)
+                    {
+                        node->filhos.push_back(new ParseNode(sym));
+                    }
+                }
+
+                for (auto it = production.rbegin(); it != production.rend(); ++it)
+                {
+                    parseStack.push(*it);
+                }
+                for (size_t i = production.size(); i-- > 0;)
+                {
+                    nodeStack.push(montar_arvore ? node->filhos[i] : nullptr);
+                }
+
+                if (debug)
+                {
+                    cout << "\n=== Debug Info ===" << endl;
+                    cout << "Top of stack (Non-terminal): " << NON_TERMINAL_TO_STRING.at(std::get<NonTerminals>(currentSymbol)) << endl;
+                    cout << "Current input token: " << token->toString() << " ( " << token->lexeme << " )" << endl;
+                    cout << "Applying production: " << PRODUCTIONS_TO_STRING.at(prod) << endl;
+
+                    if (!production.empty())
+                    {
+                        cout << "Pushing to stack (rightmost first): ";
+                        for (auto it = production.rbegin(); it != production.rend(); ++it)
+                        {
+                            if (std::holds_alternative<Tag>(*it))
+                                cout << TAG_TO_STRING.at(std::get<Tag>(*it)) << " ";
+                            else
+                                cout << NON_TERMINAL_TO_STRING.at(std::get<NonTerminals>(*it)) << " ";
+                        }
+                        cout << endl;
+                    }
+                    else
+                    {
+                        cout << "Production is epsilon (no symbols pushed)." << endl;
+                    }
+
+                    print_stack(parseStack);
+                }
+            }
+            currentSymbol = parseStack.top();
+        }
+    }
+    catch (const LexicalError &e)
+    {
+        // Lexer consumido durante a análise (entrada padrão, pipeline): o erro
+        // léxico encerra a análise no ponto da entrada em que aparece
+        erro = e.describe(linhas);
+        free_parse_tree(raiz);
+        return false;
+    }
+
+    // S ::= MAIN $: ao chegar no $ da pilha a entrada também precisa ter acabado
+    if (token != &eof)
+    {
+        erro = ll1_error_trailing(local(token), *token);
+        free_parse_tree(raiz);
+        return false;
+    }
+
+    if (arvore != nullptr)
+    {
+        *arvore = raiz;
+    }
+    return true;
+}
+
+// ==========================
+// Linha de comando (fora da biblioteca: compilada com -DPARSER_LIBRARY, este
+// arquivo traz só as tabelas e o parser)
+// ==========================
+
+#ifndef PARSER_LIBRARY
+
+// Tabelas do backend dfa: lidas do arquivo binário, se informado, ou geradas
+// a partir da especificação no formato do lexer.l
+static bool carregar_tabelas_lexer(const string &especificacao, const string &arquivo_tabelas, DfaTables &tabelas, string &erro)
+{
+    if (!arquivo_tabelas.empty())
+        return tabelas.load(arquivo_tabelas, erro);
+
+    ifstream in(especificacao);
+    if (!in)
+    {
+        erro = "não foi possível abrir a especificação " + especificacao;
+        return false;
+    }
+    stringstream texto;
+    texto << in.rdbuf();
+    return compile_lexer_spec(texto.str(), tabelas, erro);
+}
+
+static bool ler_texto(const string &caminho, string &texto)
+{
+    ifstream in(caminho);
+    if (!in)
+        return false;
+    stringstream ss;
+    ss << in.rdbuf();
+    texto = ss.str();
+    return true;
+}
+
+// Roda os dois parsers sobre os mesmos tokens de cada arquivo, confere se
+// aceitam/rejeitam igual e compara ações por token e vazão
+static int comparar_parsers(const vector<string> &arquivos, const LalrTables &lalr)
+{
+    size_t total_tokens = 0, passos_ll1 = 0, passos_lalr = 0;
+    double s_ll1 = 0, s_lalr = 0;
+    bool iguais = true;
+    for (const auto &arquivo : arquivos)
+    {
+        stringstream ss;
+        string erro;
+        if (!readFile(arquivo, ss, erro))
+        {
+            cerr << erro << endl;
+            return 1;
+        }
+        vector<Token *> tokens;
+        try
+        {
+            tokens = analise_automatas(ss);
+        }
+        catch (const LexicalError &e)
+        {
+            string texto = ss.str();
+            LineIndex linhas(texto);
+            cerr << arquivo << ": " << e.describe(&linhas) << endl;
+            return 1;
+        }
+        total_tokens += tokens.size() + 1; // + fim da entrada
+
+        string erro_ll1, erro_lalr;
+        VectorLexer lexer_ll1(tokens);
+        auto inicio = chrono::steady_clock::now();
+        bool aceito_ll1 = parse_tokens(lexer_ll1, nullptr, false, erro_ll1, nullptr, &passos_ll1);
+        s_ll1 += chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+
+        VectorLexer lexer_lalr(tokens);
+        inicio = chrono::steady_clock::now();
+        bool aceito_lalr = parse_lalr(lalr, lexer_lalr, erro_lalr, nullptr, &passos_lalr);
+        s_lalr += chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+
+        if (aceito_ll1 != aceito_lalr)
+        {
+            cout << "[FAIL] " << arquivo << ": LL(1) " << (aceito_ll1 ? "aceita" : "rejeita") << ", LALR(1) "
+                 << (aceito_lalr ? "aceita" : "rejeita") << endl;
+            iguais = false;
+        }
+        for (Token *tok : tokens)
+            delete tok;
+    }
+
+    cout << "Arquivos: " << arquivos.size() << ", tokens: " << total_tokens << endl;
+    cout << fixed << setprecision(2);
+    cout << "LL(1):   " << passos_ll1 << " ações (" << (double)passos_ll1 / total_tokens << " por token), " << s_ll1 * 1000
+         << " ms, " << (total_tokens / 1e6) / s_ll1 << " Mtokens/s" << endl;
+    cout << "LALR(1): " << passos_lalr << " ações (" << (double)passos_lalr / total_tokens << " por token), " << s_lalr * 1000
+         << " ms, " << (total_tokens / 1e6) / s_lalr << " Mtokens/s" << endl;
+    cout << (iguais ? "Mesmo resultado nos dois parsers." : "Resultados diferentes!") << endl;
+    return iguais ? 0 : 1;
+}
+
+// Conteúdo vindo do FileLoader que esteja comprimido é descomprimido em
+// texto (reaproveitado entre arquivos) e fonte passa a apontar para ele
+static bool descomprimir_fonte(string_view &fonte, string &texto, string &erro)
+{
+    Compressao formato = detect_compression(fonte.data(), fonte.size());
+    if (formato == SEM_COMPRESSAO)
+        return true;
+    if (!decompress_buffer(fonte, formato, texto, erro))
+        return false;
+    fonte = texto;
+    return true;
+}
+
+// Arquivo comprimido no --check: como a entrada padrão, o StreamInput o
+// descomprime em blocos em uma thread auxiliar e o reconhecedor anda pela
+// janela dele, então o texto descomprimido nunca fica inteiro em memória
+static bool verificar_comprimido(Recognizer &reconhecedor, const string &caminho, string &erro, size_t &tokens,
+                                 size_t &bytes)
+{
+    int fd = open(caminho.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        erro = "Erro ao abrir arquivo: " + caminho;
+        return false;
+    }
+    bool aceito;
+    {
+        StreamInput entrada(fd);
+        AllocPhase anterior = set_alloc_phase(FASE_SINTATICO);
+        aceito = reconhecedor.check(entrada, erro, &tokens);
+        set_alloc_phase(anterior);
+        bytes += entrada.bytes_lidos();
+        // Truncado ou corrompido: o fim antecipado não é erro de sintaxe
+        if (!aceito)
+            entrada.skip_rest();
+        string erro_entrada = entrada.decompression_error();
+        if (!erro_entrada.empty())
+        {
+            erro = erro_entrada;
+            aceito = false;
+        }
+    }
+    close(fd);
+    return aceito;
+}
+
+// --check: só aceita/rejeita, com o reconhecedor fundido AFD + LL(1). Pastas
+// são percorridas recursivamente; os arquivos são lidos em lote pelo
+// FileLoader e cada um é reconhecido direto no buffer da leitura, enquanto os
+// outros ainda estão sendo lidos. Os comprimidos ficam para o fim, em fluxo
+// (verificar_comprimido)
+static int verificar_arquivos(const vector<string> &entradas, const vector<string> &padroes, const DfaTables &tabelas,
+                              bool perfil_alocacao, FileLoader::Modo modo_io, size_t threads)
+{
+    vector<string> arquivos;
+    expand_paths(entradas, arquivos, padroes);
+
+    FileLoader carregador(modo_io, threads);
+    Recognizer reconhecedor(tabelas);
+    vector<char> aceitos(arquivos.size(), 0);
+    vector<string> erros(arquivos.size());
+    vector<size_t> comprimidos;
+    size_t bytes = 0, tokens = 0;
+    double s_reconhecer = 0;
+    auto inicio = chrono::steady_clock::now();
+    carregador.load(arquivos, [&](size_t i, string_view fonte, const string &erro)
+                    {
+                        if (!erro.empty())
+                        {
+                            erros[i] = erro;
+                            return;
+                        }
+                        if (detect_compression(fonte.data(), fonte.size()) != SEM_COMPRESSAO)
+                        {
+                            comprimidos.push_back(i);
+                            return;
+                        }
+                        auto t = chrono::steady_clock::now();
+                        AllocPhase anterior = set_alloc_phase(FASE_SINTATICO);
+                        aceitos[i] = reconhecedor.check(fonte, erros[i], &tokens);
+                        set_alloc_phase(anterior);
+                        s_reconhecer += chrono::duration<double>(chrono::steady_clock::now() - t).count();
+                        bytes += fonte.size();
+                    });
+    for (size_t i : comprimidos)
+    {
+        auto t = chrono::steady_clock::now();
+        aceitos[i] = verificar_comprimido(reconhecedor, arquivos[i], erros[i], tokens, bytes);
+        s_reconhecer += chrono::duration<double>(chrono::steady_clock::now() - t).count();
+    }
+    double s = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+    s_reconhecer = max(s_reconhecer, 1e-9);
+
+    size_t total_aceitos = 0;
+    for (size_t i = 0; i < arquivos.size(); i++)
+    {
+        total_aceitos += aceitos[i];
+        cout << arquivos[i] << ": " << (aceitos[i] ? "aceito" : erros[i]) << endl;
+    }
+    cout << arquivos.size() << " arquivo(s), " << total_aceitos << " aceito(s), " << bytes << " bytes, " << tokens
+         << " tokens" << endl;
+    cout << fixed << "leitura (" << carregador.backend() << ") + reconhecimento: " << setprecision(3) << s * 1000
+         << " ms, " << setprecision(2) << (bytes / 1e9) / s << " GB/s; só reconhecimento: " << setprecision(3)
+         << s_reconhecer * 1000 << " ms, " << setprecision(2) << (bytes / 1e9) / s_reconhecer << " GB/s" << endl;
+    if (perfil_alocacao)
+        alloc_report(cout, tokens, 0);
+    return total_aceitos == arquivos.size() ? 0 : 1;
+}
+
+// --structure: índice estrutural de cada arquivo (funções, profundidade e
+// chaves/parênteses sem par); o tempo é só o da montagem do índice
+static int estrutura_arquivos(const vector<string> &entradas, const vector<string> &padroes, FileLoader::Modo modo_io,
+                              size_t threads)
+{
+    vector<string> arquivos;
+    expand_paths(entradas, arquivos, padroes);
+
+    FileLoader carregador(modo_io, threads);
+    vector<string> saidas(arquivos.size());
+    string descomprimido, erro_descompressao;
+    size_t bytes = 0, estruturais = 0, desbalanceados = 0;
+    double s = 0;
+    carregador.load(arquivos, [&](size_t i, string_view fonte, const string &erro)
+                    {
+                        if (!erro.empty())
+                        {
+                            saidas[i] = arquivos[i] + ": " + erro + "\n";
+                            desbalanceados++;
+                            return;
+                        }
+                        if (!descomprimir_fonte(fonte, descomprimido, erro_descompressao))
+                        {
+                            saidas[i] = arquivos[i] + ": " + erro_descompressao + "\n";
+                            desbalanceados++;
+                            return;
+                        }
+                        StructuralIndex indice;
+                        string erro_indice;
+                        auto inicio = chrono::steady_clock::now();
+                        bool ok = build_structural_index(fonte, indice, erro_indice);
+                        s += chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+                        if (!ok)
+                        {
+                            saidas[i] = arquivos[i] + ": " + erro_indice + "\n";
+                            desbalanceados++;
+                            return;
+                        }
+                        bytes += fonte.size();
+                        estruturais += indice.posicoes.size();
+                        desbalanceados += !indice.balanced();
+
+                        LineIndex linhas(fonte);
+                        ostringstream out;
+                        out << arquivos[i] << ": " << indice.funcoes.size() << " função(ões), " << indice.posicoes.size()
+                            << " caracteres estruturais, profundidade máxima " << indice.profundidade_maxima << "\n";
+                        for (const auto &f : indice.funcoes)
+                        {
+                            // Nome: o identificador antes do primeiro '(' do trecho
+                            string_view trecho = fonte.substr(f.first, f.second - f.first);
+                            size_t fim_nome = trecho.find('(');
+                            if (fim_nome == string_view::npos)
+                                fim_nome = 0;
+                            while (fim_nome > 0 && isspace((unsigned char)trecho[fim_nome - 1]))
+                                fim_nome--;
+                            size_t inicio_nome = fim_nome;
+                            while (inicio_nome > 0 && isalnum((unsigned char)trecho[inicio_nome - 1]))
+                                inicio_nome--;
+                            size_t primeiro = f.first + trecho.find_first_not_of(" \t\r\v\f\n");
+                            string nome(trecho.substr(inicio_nome, fim_nome - inicio_nome));
+                            out << "  " << (nome.empty() ? "(bloco)" : nome) << ": linhas " << linhas.locate(primeiro).linha
+                                << "-" << linhas.locate(f.second - 1).linha << "\n";
+                        }
+                        for (const auto &e : indice.erros)
+                            out << describe_structural_error(e, fonte, linhas) << "\n";
+                        saidas[i] = out.str();
+                    });
+
+    for (const string &saida : saidas)
+        cout << saida;
+    s = max(s, 1e-9);
+    cout << arquivos.size() << " arquivo(s), " << desbalanceados << " com erro, " << bytes << " bytes, " << estruturais
+         << " caracteres estruturais em " << fixed << setprecision(3) << s * 1000 << " ms: " << setprecision(2)
+         << (bytes / 1e9) / s << " GB/s" << endl;
+    return desbalanceados == 0 ? 0 : 1;
+}
+
+// --index: monta ou atualiza o índice de referências cruzadas dos arquivos
+static int indexar_arquivos(const string &indice, const vector<string> &arquivos, const vector<string> &padroes,
+                            size_t threads, const string &backend, const DfaTables *tabelas)
+{
+    ThreadPool pool(threads);
+    XrefStats st;
+    vector<string> erros;
+    string erro;
+    if (!build_xref_index(indice, arquivos, pool, backend, tabelas, st, erros, erro, padroes))
+    {
+        cerr << "--index: " << erro << endl;
+        return 1;
+    }
+    for (const string &e : erros)
+        cout << e << endl;
+    cout << indice << ": " << st.arquivos << " arquivo(s) (" << st.reindexados << " analisado(s), " << st.reaproveitados
+         << " sem mudança, " << st.com_erro << " com erro), " << st.simbolos << " símbolos, " << st.sites
+         << " ocorrências em " << fixed << setprecision(1) << st.ms << " ms (" << pool.size() << " threads)" << endl;
+    return 0;
+}
+
+// --query: cada consulta é "nome" ou "papel:nome" (ex.: call:Multiplica)
+static int consultar_indice(const string &indice, const vector<string> &consultas)
+{
+    XrefIndex xref;
+    string erro;
+    if (!xref.open(indice, erro))
+    {
+        cerr << "--query: " << erro << endl;
+        return 1;
+    }
+
+    bool achou = false;
+    for (const string &consulta : consultas)
+    {
+        string nome = consulta;
+        int papel = -1;
+        size_t dois_pontos = consulta.find(':');
+        if (dois_pontos != string::npos)
+        {
+            papel = xref_role_from_name(consulta.substr(0, dois_pontos));
+            if (papel == -1)
+            {
+                cerr << "--query: papel desconhecido em '" << consulta
+                     << "' (use def, call, param, decl, assign ou use)" << endl;
+                return 1;
+            }
+            nome = consulta.substr(dois_pontos + 1);
+        }
+
+        auto inicio = chrono::steady_clock::now();
+        auto sites = xref.find(nome);
+        vector<const XrefSite *> resultado;
+        for (const XrefSite *s = sites.first; s != sites.second; s++)
+            if (papel == -1 || (int)s->papel == papel)
+                resultado.push_back(s);
+        double us = chrono::duration<double, micro>(chrono::steady_clock::now() - inicio).count();
+
+        for (const XrefSite *s : resultado)
+            cout << xref.file_name(s->arquivo) << ":" << s->linha << ":" << s->coluna << ": "
+                 << xref_role_name(s->papel) << " " << nome << "\n";
+        cout << resultado.size() << " ocorrência(s) de '" << consulta << "' em " << xref.num_files()
+             << " arquivo(s) (" << fixed << setprecision(1) << us << " µs)" << endl;
+        achou |= !resultado.empty();
+    }
+    return achou ? 0 : 1;
+}
+
+// --automata-profile: resumo em cout e mapa de calor em arquivo (Graphviz se
+// termina em .dot, senão JSON)
+static bool gravar_perfil_automatos(const AutomataProfile &perfil, const string &arquivo)
+{
+    automata_profile_report(cout, perfil);
+    ofstream out(arquivo);
+    bool dot = arquivo.size() >= 4 && arquivo.compare(arquivo.size() - 4, 4, ".dot") == 0;
+    if (dot)
+        write_automata_profile_dot(out, perfil);
     else
+        write_automata_profile_json(out, perfil);
+    if (!out)
     {
-        ss = readFile(argv[1]);
+        cerr << "Não foi possível gravar " << arquivo << endl;
+        return false;
     }
+    cout << "Perfil dos autômatos gravado em " << arquivo << " (" << (dot ? "Graphviz" : "JSON") << ")" << endl;
+    return true;
+}
 
-    vector<Token *> tokens = analise_automatas(ss);
+// --run: executa o programa; os prints vão para cout e o relatório para cerr
+static int executar_programa(const IRProgram &ir, const ExecOptions &opcoes, const LineIndex &linhas)
+{
+    ExecStats st;
+    ErroExecucao erro;
+    auto inicio = chrono::steady_clock::now();
+    bool ok = execute_program(ir, opcoes, cout, st, erro);
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - inicio).count();
+    cout << flush;
+    if (!ok)
+        cout << describe_exec_error(erro, linhas) << endl;
+
+    cerr << "Execução: " << st.instrucoes << " instruções, " << st.chamadas << " chamada(s) (" << st.chamadas_puras
+         << " a funções puras), profundidade máxima " << st.profundidade_maxima << ", " << fixed << setprecision(3)
+         << ms << " ms" << endl;
+    cerr << "Funções puras:";
+    for (size_t i = 0; i < st.puras.size(); i++)
+        cerr << (i ? ", " : " ") << st.puras[i];
+    cerr << (st.puras.empty() ? " nenhuma" : "") << endl;
+    if (opcoes.memoizar)
+    {
+        uint64_t consultas = st.acertos + st.falhas;
+        cerr << "Memoização: " << st.acertos << " acerto(s), " << st.falhas << " falha(s) (" << setprecision(1)
+             << (consultas ? 100.0 * st.acertos / consultas : 0.0) << "% de acertos), " << st.substituicoes
+             << " substituição(ões), " << st.entradas << "/" << st.capacidade << " entradas" << endl;
+    }
+    return ok ? 0 : 1;
+}
 
-    cout << "Tokens encontrados:\n";
-    for (const auto &token : tokens)
+// --verify-c: compara o binário compilado do C gerado com o avaliador
+static int verificar_c(const IRProgram &ir, const LineIndex &linhas, const string &origem)
+{
+    CVerifyResult r;
+    string erro;
+    if (!verify_c_program(ir, linhas, origem, r, erro))
+    {
+        cerr << "--verify-c: " << erro << endl;
+        return 1;
+    }
+    cout << fixed << setprecision(1) << "avaliador: " << r.ms_avaliador << " ms (código " << r.codigo_avaliador
+         << "); compilação: " << r.ms_compilacao << " ms; binário: " << r.ms_binario << " ms (código "
+         << r.codigo_binario << ")" << endl;
+    if (!r.igual)
     {
-        cout << token->toString() << ' ';
+        // Primeira linha diferente, para começar a investigar
+        istringstream esperado(r.saida_avaliador), obtido(r.saida_binario);
+        string a, b;
+        size_t linha = 1;
+        while (true)
+        {
+            bool tem_a = (bool)getline(esperado, a), tem_b = (bool)getline(obtido, b);
+            if (!tem_a && !tem_b)
+                break;
+            if (!tem_a || !tem_b || a != b)
+            {
+                cout << "Saídas diferentes na linha " << linha << ": avaliador '" << (tem_a ? a : "<fim>")
+                     << "', binário '" << (tem_b ? b : "<fim>") << "'" << endl;
+                break;
+            }
+            linha++;
+        }
+        if (r.codigo_avaliador != r.codigo_binario)
+            cout << "Códigos de saída diferentes." << endl;
+        return 1;
     }
-    cout << endl;
+    cout << "Saída idêntica à do avaliador (" << r.saida_avaliador.size() << " bytes)." << endl;
+    return 0;
+}
 
-    std::stack<Symbol> parseStack;
+int main(int argc, char *argv[])
+{
+    initialize_ll1_table();
 
-    parseStack.push(NonTerminals::NT_S); // símbolo inicial da gramática
+    vector<string> arquivos;
+    string backend = "automata";
+    bool quiet = false;
+    bool mostrar_ir = false;
+    bool comparar_lexers = false;
+    string diretorio_cache;
+    uint64_t limite_cache = 64 << 20;
+    string especificacao = "lexer.l";
+    string arquivo_tabelas;
+    string compilar_lexer;
+    string emitir_scanner;
+    string parser = "ll1";
+    string arquivo_gramatica = "grammar.bnf";
+    bool comparar_parsers_flag = false;
+    bool perfil_alocacao = false;
+    string arquivo_perfil_automatos;
+    bool fuzz = false;
+    bool pipeline = false;
+    bool paralelo = false;
+    size_t threads_paralelo = 0;
+    bool verificar = false;
+    bool estrutura = false;
+    bool executar = false;
+    string emitir_c;
+    bool verificar_c_flag = false;
+    ExecOptions opcoes_execucao;
+    string arquivo_indice;
+    string arquivo_consulta;
+    size_t cadeias_bench = 0;
+    FileLoader::Modo modo_io = FileLoader::AUTOMATICO;
+    vector<string> padroes_fonte;
+    FuzzOptions opcoes_fuzz;
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (arg == "--quiet" || arg == "-q")
+            quiet = true;
+        else if (arg == "--ir")
+            mostrar_ir = true;
+        else if (arg.rfind("--lexer=", 0) == 0)
+            backend = arg.substr(8);
+        else if (arg == "--compare-lexers")
+            comparar_lexers = true;
+        else if (arg.rfind("--cache=", 0) == 0)
+            diretorio_cache = arg.substr(8);
+        else if (arg.rfind("--cache-max-kb=", 0) == 0)
+            limite_cache = stoull(arg.substr(15)) << 10;
+        else if (arg.rfind("--lexer-spec=", 0) == 0)
+            especificacao = arg.substr(13);
+        else if (arg.rfind("--lexer-tables=", 0) == 0)
+            arquivo_tabelas = arg.substr(15);
+        else if (arg.rfind("--compile-lexer=", 0) == 0)
+            compilar_lexer = arg.substr(16);
+        else if (arg.rfind("--emit-scanner=", 0) == 0)
+            emitir_scanner = arg.substr(15);
+        else if (arg.rfind("--parser=", 0) == 0)
+            parser = arg.substr(9);
+        else if (arg.rfind("--grammar=", 0) == 0)
+            arquivo_gramatica = arg.substr(10);
+        else if (arg == "--bench-parsers")
+            comparar_parsers_flag = true;
+        else if (arg == "--alloc-profile")
+            perfil_alocacao = true;
+        else if (arg.rfind("--automata-profile=", 0) == 0)
+            arquivo_perfil_automatos = arg.substr(19);
+        else if (arg == "--pipeline")
+            pipeline = true;
+        else if (arg == "--parallel")
+            paralelo = true;
+        else if (arg.rfind("--parallel=", 0) == 0)
+        {
+            paralelo = true;
+            threads_paralelo = stoull(arg.substr(11));
+        }
+        else if (arg == "--check")
+            verificar = true;
+        else if (arg == "--structure")
+            estrutura = true;
+        else if (arg.rfind("--include=", 0) == 0)
+            padroes_fonte.push_back(arg.substr(10));
+        else if (arg == "--run")
+            executar = true;
+        else if (arg == "--run=memo")
+        {
+            executar = true;
+            opcoes_execucao.memoizar = true;
+        }
+        else if (arg.rfind("--emit-c=", 0) == 0)
+            emitir_c = arg.substr(9);
+        else if (arg == "--verify-c")
+            verificar_c_flag = true;
+        else if (arg.rfind("--memo-size=", 0) == 0)
+            opcoes_execucao.capacidade_memo = stoull(arg.substr(12));
+        else if (arg == "--io=uring")
+            modo_io = FileLoader::AUTOMATICO;
+        else if (arg == "--io=pread")
+            modo_io = FileLoader::PREAD;
+        else if (arg.rfind("--index=", 0) == 0)
+            arquivo_indice = arg.substr(8);
+        else if (arg.rfind("--query=", 0) == 0)
+            arquivo_consulta = arg.substr(8);
+        else if (arg == "--bench-automata")
+            cadeias_bench = 1000000;
+        else if (arg.rfind("--bench-automata=", 0) == 0)
+            cadeias_bench = stoull(arg.substr(17));
+        else if (arg == "--fuzz")
+            fuzz = true;
+        else if (arg.rfind("--fuzz=", 0) == 0)
+        {
+            fuzz = true;
+            opcoes_fuzz.iteracoes = stoull(arg.substr(7));
+        }
+        else if (arg.rfind("--fuzz-out=", 0) == 0)
+            opcoes_fuzz.diretorio = arg.substr(11);
+        else if (arg.rfind("--fuzz-seed=", 0) == 0)
+            opcoes_fuzz.semente = stoull(arg.substr(12));
+        else if (arg.rfind("--fuzz-max-len=", 0) == 0)
+            opcoes_fuzz.tamanho_max = stoull(arg.substr(15));
+        else if (arg.rfind("--fuzz-factor=", 0) == 0)
+            opcoes_fuzz.fator = stod(arg.substr(14));
+        else
+            arquivos.push_back(arg);
+    }
+
+    // --include substitui os padrões de arquivos de código das pastas
+    if (padroes_fonte.empty())
+        padroes_fonte = PADROES_FONTE;
 
-    Token *token = tokens[0];
-    tokens.push_back(new Token(Tag::EOF_TOKEN, "$")); // adiciona um token EOF para facilitar o processamento
-    Symbol currentSymbol = parseStack.top();
+    // O perfil conta o que o Lexer de autômatos faz; os outros backends não os usam
+    AutomataProfile perfil_automatos;
+    AutomataProfile *perfil = arquivo_perfil_automatos.empty() ? nullptr : &perfil_automatos;
+    if (perfil != nullptr && backend != "automata")
+    {
+        cerr << "--automata-profile só vale para --lexer=automata" << endl;
+        return 1;
+    }
 
-    while (!is_tag(currentSymbol, EOF_TOKEN))
+    DfaTables tabelas;
+    string erro_tabelas;
+    bool tem_tabelas = false;
+    if (!compilar_lexer.empty())
     {
-        Tag tag = token->tag;
-        if (Relop *relopToken = dynamic_cast<Relop *>(token))
+        ifstream in(especificacao);
+        if (!in)
         {
-            tag = relopToken->relop;
+            cerr << "Não foi possível abrir a especificação " << especificacao << endl;
+            return 1;
+        }
+        stringstream texto;
+        texto << in.rdbuf();
+        LexGenStats st;
+        if (!compile_lexer_spec(texto.str(), tabelas, erro_tabelas, &st) || !tabelas.save(compilar_lexer, erro_tabelas))
+        {
+            cerr << especificacao << ": " << erro_tabelas << endl;
+            return 1;
+        }
+        cout << especificacao << ": " << st.regras << " regras, AFN com " << st.estados_afn << " estados, AFD com "
+             << st.estados_afd << " -> " << st.estados_minimos << " estados após minimização, " << st.classes
+             << " classes de bytes (" << st.ms << " ms)" << endl;
+        cout << "Tabelas gravadas em " << compilar_lexer << endl;
+        return 0;
+    }
+    if (!emitir_scanner.empty())
+    {
+        if (!carregar_tabelas_lexer(especificacao, arquivo_tabelas, tabelas, erro_tabelas))
+        {
+            cerr << erro_tabelas << endl;
+            return 1;
         }
-        else if (Arithop *arithopToken = dynamic_cast<Arithop *>(token))
+        ofstream out(emitir_scanner);
+        emit_direct_scanner(tabelas, arquivo_tabelas.empty() ? especificacao : arquivo_tabelas, out);
+        if (!out)
         {
-            tag = arithopToken->arithop;
+            cerr << "Não foi possível gravar " << emitir_scanner << endl;
+            return 1;
         }
+        cout << "Scanner com " << tabelas.num_estados - 1 << " estados gravado em " << emitir_scanner << endl;
+        return 0;
+    }
+    if (backend == "dfa" || comparar_lexers || verificar)
+    {
+        tem_tabelas = carregar_tabelas_lexer(especificacao, arquivo_tabelas, tabelas, erro_tabelas);
+        if (!tem_tabelas && (backend == "dfa" || verificar))
+        {
+            cerr << (verificar ? "--check: " : "Backend dfa: ") << erro_tabelas << endl;
+            return 1;
+        }
+    }
 
-        if (is_tag(currentSymbol, tag))
+    if (cadeias_bench > 0)
+    {
+        return bench_automata(cadeias_bench, threads_paralelo);
+    }
+
+    if (comparar_lexers)
+    {
+        return compare_lexers(arquivos, tem_tabelas ? &tabelas : nullptr);
+    }
+
+    if (parser != "ll1" && parser != "lalr")
+    {
+        cerr << "Parser desconhecido: " << parser << " (use ll1 ou lalr)" << endl;
+        return 1;
+    }
+    LalrTables lalr;
+    bool usar_lalr = parser == "lalr";
+    if (pipeline && paralelo)
+    {
+        cerr << "--pipeline e --parallel não podem ser usados juntos." << endl;
+        return 1;
+    }
+    if (usar_lalr || comparar_parsers_flag)
+    {
+        string gramatica, erro;
+        if (!ler_texto(arquivo_gramatica, gramatica))
         {
-            parseStack.pop();
-            cout << token->toString() << "( " << token->lexeme << " )" << endl;
-            tokens.erase(tokens.begin());
-            token = tokens[0];
+            cerr << "Não foi possível abrir a gramática " << arquivo_gramatica << endl;
+            return 1;
         }
-        else if (is_terminal(currentSymbol))
+        if (!build_lalr(gramatica, lalr, erro))
         {
-            cout << "Erro de sintaxe: símbolo terminal inesperado '" << token->toString() << "' ao invés de '" << TAG_TO_STRING.at(std::get<Tag>(currentSymbol)) << "'." << endl;
+            cerr << arquivo_gramatica << ": " << erro << endl;
             return 1;
         }
-        else if (get_matrix(std::get<NonTerminals>(currentSymbol), tag) == EMPTY)
+    }
+    if (comparar_parsers_flag)
+    {
+        return comparar_parsers(arquivos, lalr);
+    }
+
+    if (verificar)
+    {
+        return verificar_arquivos(arquivos, padroes_fonte, tabelas, perfil_alocacao, modo_io, threads_paralelo);
+    }
+
+    if (estrutura)
+    {
+        return estrutura_arquivos(arquivos, padroes_fonte, modo_io, threads_paralelo);
+    }
+
+    if (!arquivo_indice.empty())
+    {
+        return indexar_arquivos(arquivo_indice, arquivos, padroes_fonte, threads_paralelo, backend,
+                                tem_tabelas ? &tabelas : nullptr);
+    }
+    if (!arquivo_consulta.empty())
+    {
+        return consultar_indice(arquivo_consulta, arquivos);
+    }
+
+    if (fuzz)
+    {
+        // Sem arquivos, as sementes são as entradas de exemplo
+        vector<string> sementes = arquivos;
+        glob_t g;
+        if (sementes.empty() && glob("entrada_*.txt", 0, nullptr, &g) == 0)
+        {
+            sementes.assign(g.gl_pathv, g.gl_pathv + g.gl_pathc);
+            globfree(&g);
+        }
+        opcoes_fuzz.backend = backend;
+        opcoes_fuzz.tabelas = tem_tabelas ? &tabelas : nullptr;
+        return run_fuzzer(sementes, opcoes_fuzz);
+    }
+
+    // "-" lê da entrada padrão em fluxo: o Lexer alimenta o parser token a token
+    // sobre uma janela de tamanho fixo, sem árvore, então a memória não depende
+    // do tamanho da entrada. Só a análise sintática é feita nesse modo. Uma
+    // entrada gzip ou zstd é descomprimida em blocos por uma thread auxiliar.
+    if (!arquivos.empty() && arquivos[0] == "-")
+    {
+        StreamInput entrada_padrao(0);
+        istream in(&entrada_padrao);
+        set_alloc_phase(FASE_LEXICO);
+        Lexer lexer(in);
+        lexer.set_profile(perfil);
+        set_alloc_phase(FASE_OUTROS);
+        PhaseLexer lexer_fase(lexer);
+        ReleasingLexer tokens(lexer_fase);
+        string erro;
+        size_t passos = 0;
+        bool aceito;
+        {
+            AllocScope escopo(FASE_SINTATICO, perfil_alocacao);
+            aceito = usar_lalr ? parse_lalr(lalr, tokens, erro, &entrada_padrao, &passos)
+                               : parse_tokens(tokens, nullptr, !quiet, erro, &entrada_padrao, &passos);
+        }
+        // Uma entrada comprimida corrompida ou truncada acaba antes da hora: o
+        // erro de sintaxe que isso causa não é o diagnóstico. Ao rejeitar, o
+        // resto é lido para saber se a descompressão foi até o fim.
+        if (!aceito && entrada_padrao.compressao() != SEM_COMPRESSAO)
+            entrada_padrao.skip_rest();
+        string erro_entrada = entrada_padrao.decompression_error();
+        if (!erro_entrada.empty())
         {
-            cout << "Erro de sintaxe: símbolo não terminal '" << NON_TERMINAL_TO_STRING[std::get<NonTerminals>(currentSymbol)] << "' não é seguido de '" << token->toString() << "'." << endl;
+            cerr << "Entrada padrão: " << erro_entrada << endl;
             return 1;
         }
-        else
         {
-            Productions prod = get_matrix(std::get<NonTerminals>(currentSymbol), tag);
-            vector<Symbol> production = productionsMap[prod];
+            AllocScope escopo(FASE_RELATORIO, perfil_alocacao);
+            if (!erro.empty())
+                cout << erro << endl;
+        }
+        if (perfil_alocacao)
+            alloc_report(cout, lexer_fase.tokens, passos);
+        if (perfil != nullptr && !gravar_perfil_automatos(*perfil, arquivo_perfil_automatos))
+            return 1;
+        return aceito ? 0 : 1;
+    }
 
-            parseStack.pop();
+    std::stringstream ss;
+    if (arquivos.empty())
+    {
+        cout << "Nenhum arquivo informado, usando código de teste padrão.\n";
+        ss = testString();
+    }
+    else
+    {
+        // Arquivo gzip ou zstd é descomprimido em memória: a análise completa
+        // precisa do texto inteiro (cache, LineIndex, IR)
+        string texto, erro;
+        Compressao formato;
+        if (!read_input_file(arquivos[0], texto, formato, erro))
+        {
+            cerr << erro << endl;
+            return 1;
+        }
+        ss.str(move(texto));
+    }
 
-            for (auto it = production.rbegin(); it != production.rend(); ++it)
-            {
-                parseStack.push(*it);
-            }
+    string fonte = ss.str();
 
-            cout << "\n=== Debug Info ===" << endl;
-            cout << "Top of stack (Non-terminal): " << NON_TERMINAL_TO_STRING[std::get<NonTerminals>(currentSymbol)] << endl;
-            cout << "Current input token: " << token->toString() << " ( " << token->lexeme << " )" << endl;
-            cout << "Applying production: " << PRODUCTIONS_TO_STRING[prod] << endl;
+    // O LALR(1) só reconhece: sem árvore não há análise semântica, IR nem cache
+    if (usar_lalr)
+    {
+        LexerBackend *lexer = make_lexer(backend, ss, tem_tabelas ? &tabelas : nullptr);
+        if (lexer == nullptr)
+        {
+            cerr << "Backend léxico desconhecido ou indisponível: " << backend << endl;
+            return 1;
+        }
+        if (Lexer *automatos = dynamic_cast<Lexer *>(lexer))
+            automatos->set_profile(perfil);
+        ReleasingLexer tokens(*lexer);
+        LineIndex linhas(fonte);
+        string erro;
+        bool aceito = parse_lalr(lalr, tokens, erro, &linhas);
+        delete lexer;
+        if (!erro.empty())
+            cout << erro << endl;
+        if (perfil != nullptr && !gravar_perfil_automatos(*perfil, arquivo_perfil_automatos))
+            return 1;
+        return aceito ? 0 : 1;
+    }
 
-            if (!production.empty())
+    unique_ptr<ParseCache> cache;
+    CacheEntry entrada;
+    bool acerto = false;
+    if (!diretorio_cache.empty())
+    {
+        cache = make_unique<ParseCache>(diretorio_cache, grammar_fingerprint(), limite_cache);
+        // Com o perfil dos autômatos a análise léxica precisa rodar
+        acerto = perfil == nullptr && cache->lookup(fonte, entrada);
+    }
+
+    LineIndex linhas(fonte);
+    ParseNode *arvore = nullptr;
+    Programa *programa = nullptr;
+    IRProgram ir;
+    size_t passos = 0;
+    bool analisado = false;
+
+    // Sem acerto no cache: análise léxica, sintática e semântica completas
+    if (!acerto)
+    {
+        LexerBackend *lexer = make_lexer(backend, ss, tem_tabelas ? &tabelas : nullptr);
+        if (lexer == nullptr)
+        {
+            cerr << "Backend léxico desconhecido ou indisponível: " << backend << endl;
+            return 1;
+        }
+        if (Lexer *automatos = dynamic_cast<Lexer *>(lexer))
+            automatos->set_profile(perfil);
+        if (pipeline)
+        {
+            // O lexer roda em outra thread e o parser consome os tokens enquanto
+            // são produzidos; a lista completa fica disponível no fim
+            AllocScope escopo(FASE_SINTATICO, perfil_alocacao);
+            PipelinedLexer tokens_pipeline(*lexer);
+            entrada.aceito = parse_tokens(tokens_pipeline, &arvore, !quiet, entrada.diagnostico, &linhas, &passos);
+            try
             {
-                cout << "Pushing to stack (rightmost first): ";
-                for (auto it = production.rbegin(); it != production.rend(); ++it)
-                {
-                    if (std::holds_alternative<Tag>(*it))
-                        cout << TAG_TO_STRING.at(std::get<Tag>(*it)) << " ";
-                    else
-                        cout << NON_TERMINAL_TO_STRING.at(std::get<NonTerminals>(*it)) << " ";
-                }
-                cout << endl;
+                tokens_pipeline.finish();
             }
-            else
+            catch (const LexicalError &e)
             {
-                cout << "Production is epsilon (no symbols pushed)." << endl;
+                // Depois de um erro de sintaxe: sem o pipeline o léxico viria antes
+                entrada.diagnostico = e.describe(&linhas);
             }
+            entrada.tokens = std::move(tokens_pipeline.tokens);
+            analisado = true;
+        }
+        else
+        {
+            AllocScope escopo(FASE_LEXICO, perfil_alocacao);
+            // Com erro léxico não há o que analisar; entrada.aceito fica false
+            analisado = !lex_source(*lexer, entrada.tokens, entrada.diagnostico, linhas);
+        }
+        delete lexer;
+    }
+    vector<Token *> &tokens = entrada.tokens;
+
+    auto finalizar = [&](int codigo)
+    {
+        if (perfil_alocacao)
+            alloc_report(cout, tokens.size(), passos);
+        if (perfil != nullptr && !gravar_perfil_automatos(*perfil, arquivo_perfil_automatos))
+            return 1;
+        return codigo;
+    };
 
-            print_stack(parseStack);
+    if (!quiet)
+    {
+        AllocScope escopo(FASE_RELATORIO, perfil_alocacao);
+        cout << "Tokens encontrados:\n";
+        for (const auto &token : tokens)
+        {
+            cout << token->toString();
+            if (token->tag == UNK)
+                cout << " (" << linhas.describe(token->offset) << ")";
+            cout << ' ';
         }
-        currentSymbol = parseStack.top();
+        cout << endl;
     }
 
-    return 0;
-}
\ No newline at end of file
+    // Com acerto, o resultado guardado basta, a menos que a IR seja pedida (e
+    // só um programa aceito tem IR)
+    if (acerto && (!entrada.aceito || (!mostrar_ir && !executar && emitir_c.empty() && !verificar_c_flag)))
+    {
+        if (!entrada.diagnostico.empty())
+            cout << entrada.diagnostico << endl;
+        return finalizar(entrada.aceito ? 0 : 1);
+    }
+    // A reanálise refaz as mensagens guardadas; sem isso sairiam duas vezes
+    if (acerto)
+        entrada.diagnostico.clear();
+
+    if (!analisado && paralelo)
+    {
+        // Uma função por tarefa; sem o passo a passo, que se misturaria entre threads
+        AllocScope escopo(FASE_SINTATICO, perfil_alocacao);
+        ThreadPool pool(threads_paralelo);
+        entrada.aceito = parse_parallel(pool, tokens, &arvore, entrada.diagnostico, &linhas, &passos);
+    }
+    else if (!analisado)
+    {
+        AllocScope escopo(FASE_SINTATICO, perfil_alocacao);
+        VectorLexer lexer_tokens(tokens);
+        entrada.aceito = parse_tokens(lexer_tokens, &arvore, !quiet && !acerto, entrada.diagnostico, &linhas, &passos);
+    }
+
+    AllocScope relatorio(FASE_RELATORIO, perfil_alocacao);
+    if (entrada.aceito)
+    {
+        programa = build_ast(arvore);
+        entrada.aceito = check_program(*programa, entrada.diagnostico, linhas, ir);
+    }
+
+    if (cache != nullptr && !acerto)
+    {
+        cache->store(fonte, entrada);
+    }
+
+    if (!entrada.diagnostico.empty())
+    {
+        cout << entrada.diagnostico << endl;
+    }
+    if (!entrada.aceito)
+    {
+        relatorio.encerrar();
+        return finalizar(1);
+    }
+
+    // O C sai da IR sem os passes (ver c_backend.h)
+    string origem = arquivos.empty() ? "o código de teste padrão" : arquivos[0];
+    if (!emitir_c.empty())
+    {
+        ofstream out(emitir_c);
+        emit_c_program(ir, linhas, origem, opcoes_execucao.limite_profundidade, out);
+        relatorio.encerrar();
+        if (!out)
+        {
+            cerr << "Não foi possível gravar " << emitir_c << endl;
+            return finalizar(1);
+        }
+        cout << "Programa C gravado em " << emitir_c << " (compile com: cc -O2 " << emitir_c << " -lpthread)" << endl;
+        return finalizar(0);
+    }
+    if (verificar_c_flag)
+    {
+        relatorio.encerrar();
+        return finalizar(verificar_c(ir, linhas, origem));
+    }
+
+    if (mostrar_ir)
+    {
+
+        cout << "\n=== IR (antes das otimizações) ===\n";
+        print_ir(cout, ir);
+
+        PassManager pm = default_pipeline();
+        pm.run(ir);
+
+        cout << "\n=== IR (depois das otimizações) ===\n";
+        print_ir(cout, ir);
+        pm.report(cout);
+    }
+
+    if (executar)
+    {
+        relatorio.encerrar();
+        return finalizar(executar_programa(ir, opcoes_execucao, linhas));
+    }
+
+    relatorio.encerrar();
+    return finalizar(0);
+}
+
+#endif // PARSER_LIBRARY
@@ -0,0 +1,203 @@
+/*
+ * Trabalho de Compiladores - Analisador Sintático
+ * Parte C: Parser LL(1) com Tabela de Análise
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo declara a gramática (não-terminais e produções) e a árvore de
+ * derivação produzida pelo parser LL(1), para que as fases seguintes
+ * (AST, IR e otimizações) possam consumir o resultado da análise.
+ *
+ * Data: Outubro de 2026
+ */
+
+#ifndef PARSER_H
+#define PARSER_H
+
+#include "automata.h"
+#include "lexer.h"
+#include "line_index.h"
+#include <cstdint>
+#include <variant>
+#include <vector>
+
+const int NUM_NONTERMINALS = 30;
+const int NUM_TERMINALS = 30;
+
+enum NonTerminals
+{
+    NT_S = 0,
+    NT_MAIN = 1,
+    NT_FLIST = 2,
+    NT_FLIST_ = 3,
+    NT_FDEF = 4,
+    NT_PARLIST = 5,
+    NT_PARLIST_ = 6,
+    NT_VARLIST = 7,
+    NT_VARLIST_ = 8,
+    NT_STMT = 9,
+    NT_ATRIBST = 10,
+    NT_ATRIBST_ = 11,
+    NT_FCALL = 12,
+    NT_PARLISTCALL = 13,
+    NT_PARLISTCALL_ = 14,
+    NT_PRINTST = 15,
+    NT_RETURNST = 16,
+    NT_RETURNST_ = 17,
+    NT_IFSTMT = 18,
+    NT_IFSTMT_ = 19,
+    NT_STMTLIST = 20,
+    NT_EXPR = 21,
+    NT_EXPR_ = 22,
+    NT_NUMEXPR = 23,
+    NT_NUMEXPR_ = 24,
+    NT_TERM = 25,
+    NT_TERM_ = 26,
+    NT_FACTOR = 27
+};
+
+enum Productions
+{
+    EMPTY = 0,
+    PROD_S_0, // S ::= MAIN $
+
+    PROD_MAIN_EPSILON, // MAIN ::= ε
+    PROD_MAIN_FLIST,   // MAIN ::= FLIST
+    PROD_MAIN_STMT,    // MAIN ::= STMT
+
+    PROD_FLIST_FDEF, // FLIST ::= FDEF FLIST_
+
+    PROD_FLIST__EPSILON, // FLIST_ ::= ε
+    PROD_FLIST__FDEF,    // FLIST_ ::= FDEF FLIST_
+
+    PROD_FDEF_DEF, // FDEF ::= def IDFUN lparen PARLIST rparen lbrace STMTLIST rbrace
+
+    PROD_PARLIST_INT,     // PARLIST ::= int id PARLIST_
+    PROD_PARLIST_EPSILON, // PARLIST ::= ε
+
+    PROD_PARLIST__COMMA,   // PARLIST_ ::= comma int id PARLIST_
+    PROD_PARLIST__EPSILON, // PARLIST_ ::= ε
+
+    PROD_VARLIST_ID, // VARLIST ::= id VARLIST_
+
+    PROD_VARLIST__COMMA,   // VARLIST_ ::= comma id VARLIST_
+    PROD_VARLIST__EPSILON, // VARLIST_ ::= ε
+
+    PROD_STMT_INT,       // STMT ::= int VARLIST semicolon
+    PROD_STMT_ATRIBST,   // STMT ::= ATRIBST semicolon
+    PROD_STMT_BLOCK,     // STMT ::= lbrace STMTLIST rbrace
+    PROD_STMT_SEMICOLON, // STMT ::= semicolon
+    PROD_STMT_PRINT,     // STMT ::= PRINTST semicolon
+    PROD_STMT_RETURN,    // STMT ::= RETURNST semicolon
+    PROD_STMT_IF,        // STMT ::= IFSTMT
+    PROD_STMT_FCALL,     // STMT ::= FCALL semicolon
+
+    PROD_ATRIBST_ID, // ATRIBST ::= id assign ATRIBST_
+
+    PROD_ATRIBST__FCALL, // ATRIBST_ ::= FCALL
+    PROD_ATRIBST__EXPR,  // ATRIBST_ ::= EXPR
+
+    PROD_FCALL_IDFUN, // FCALL ::= idfun lparen PARLISTCALL rparen
+
+    PROD_PARLISTCALL_ID, // PARLISTCALL ::= id PARLISTCALL_
+
+    PROD_PARLISTCALL__EPSILON, // PARLISTCALL_ ::= ε
+    PROD_PARLISTCALL__COMMA,   // PARLISTCALL_ ::= comma id PARLISTCALL_
+
+    PROD_PRINTST_PRINT, // PRINTST ::= print EXPR
+
+    PROD_RETURNST_RETURN, // RETURNST ::= return RETURNST_
+
+    PROD_RETURNST__ID,      // RETURNST_ ::= id
+    PROD_RETURNST__EPSILON, // RETURNST_ ::= ε
+
+    PROD_IFSTMT_IF, // IFSTMT ::= if lparen EXPR rparen lbrace STMT rbrace IFSTMT_
+
+    PROD_IFSTMT__EPSILON, // IFSTMT_ ::= ε
+    PROD_IFSTMT__ELSE,    // IFSTMT_ ::= else lbrace STMT rbrace
+
+    PROD_STMTLIST_STMT,    // STMTLIST ::= STMT STMTLIST
+    PROD_STMTLIST_EPSILON, // STMTLIST ::= ε
+
+    PROD_EXPR_NUMEXPR, // EXPR ::= NUMEXPR EXPR_
+
+    PROD_EXPR__EPSILON, // EXPR_ ::= ε
+    PROD_EXPR__LT,      // EXPR_ ::= lt NUMEXPR
+    PROD_EXPR__LE,      // EXPR_ ::= le NUMEXPR
+    PROD_EXPR__GT,      // EXPR_ ::= gt NUMEXPR
+    PROD_EXPR__GE,      // EXPR_ ::= ge NUMEXPR
+    PROD_EXPR__EQ,      // EXPR_ ::= eq NUMEXPR
+    PROD_EXPR__NE,      // EXPR_ ::= ne NUMEXPR
+
+    PROD_NUMEXPR_TERM, // NUMEXPR ::= TERM NUMEXPR_
+
+    PROD_NUMEXPR__EPSILON, // NUMEXPR_ ::= ε
+    PROD_NUMEXPR__PLUS,    // NUMEXPR_ ::= plus TERM NUMEXPR_
+    PROD_NUMEXPR__MINUS,   // NUMEXPR_ ::= minus TERM NUMEXPR_
+
+    PROD_TERM_FACTOR, // TERM ::= FACTOR TERM_
+
+    PROD_TERM__EPSILON, // TERM_ ::= ε
+    PROD_TERM__TIMES,   // TERM_ ::= times FACTOR TERM_
+    PROD_TERM__DIVIDE,  // TERM_ ::= divide FACTOR TERM_
+
+    PROD_FACTOR_NUMEXPR, // FACTOR ::= lparen NUMEXPR rparen
+    PROD_FACTOR_ID,      // FACTOR ::= id
+    PROD_FACTOR_NUM,     // FACTOR ::= num
+};
+
+using Symbol = variant<Tag, NonTerminals>;
+
+// Nó da árvore de derivação: não-terminais guardam a produção aplicada e os
+// filhos (na ordem do lado direito), terminais guardam o token casado.
+struct ParseNode
+{
+    Symbol simbolo;
+    Productions producao = EMPTY;
+    Token *token = nullptr;
+    vector<ParseNode *> filhos;
+
+    ParseNode(Symbol simbolo) : simbolo(simbolo) {}
+};
+
+// As tabelas são montadas no primeiro uso e nunca mais mudam; chamar antes só
+// antecipa esse custo
+void initialize_ll1_table();
+
+// Acesso somente leitura à tabela LL(1) e aos lados direitos das produções
+// (para reconhecedores que montam as próprias tabelas compactas)
+Productions ll1_entry(NonTerminals nt, Tag t);
+const vector<Symbol> &production_symbols(Productions p);
+
+// Mensagens de erro do LL(1), iguais em todos os caminhos de análise; local é
+// " (linha L, coluna C)" ou vazio
+string ll1_error_terminal(const string &local, const Token &token, Tag esperado);
+string ll1_error_nonterminal(const string &local, const Token &token, NonTerminals nt);
+string ll1_error_trailing(const string &local, const Token &token);
+
+// Libera os nós da árvore de derivação (os tokens não, eles são do lexer)
+void free_parse_tree(ParseNode *raiz);
+
+// Executa o parser LL(1) sobre os tokens do lexer. Retorna true se a entrada foi
+// aceita; se arvore != nullptr, devolve nela a raiz (NT_S) da árvore de derivação.
+// Se arvore == nullptr, nenhuma árvore é montada e a pilha é a única memória
+// que depende da entrada. Os tokens não são liberados: quem cria o lexer decide
+// (com um ReleasingLexer, cada token é liberado logo depois de casado).
+// Em caso de erro, a mensagem de diagnóstico vai para erro, com a linha/coluna
+// do token se linhas != nullptr.
+// Com debug = true imprime o passo a passo da pilha, como o main sempre fez.
+// Se passos != nullptr, soma nele o número de expansões e casamentos.
+// Com inicio != NT_S a análise parte desse não-terminal (a pilha começa com
+// "inicio $"), e a raiz devolvida é o nó dele; usado pela análise paralela.
+bool parse_tokens(LexerBackend &lexer, ParseNode **arvore, bool debug, string &erro, const PositionResolver *linhas,
+                  size_t *passos = nullptr, NonTerminals inicio = NT_S);
+
+// Identifica a gramática (produções e tabela LL(1)): muda sempre que a
+// gramática muda, e é usada para invalidar resultados guardados em cache.
+uint64_t grammar_fingerprint();
+
+#endif // PARSER_H
@@ -0,0 +1,202 @@
+/*
+ * Trabalho de Compiladores - Biblioteca do Analisador
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo implementa o Parser reentrante: análise léxica, sintática
+ * (LL(1)) e semântica de um código em memória, com todo o estado na pilha
+ * da chamada. Os avisos de atribuição definida também saem no diagnóstico.
+ * As etapas léxica e semântica (lex_source, check_program) são as mesmas
+ * que a linha de comando usa.
+ *
+ * Data: Outubro de 2026
+ */
+
+#include "parser_api.h"
+#include "ast.h"
+#include "dataflow.h"
+#include "line_index.h"
+#include "parser.h"
+#include "semantic.h"
+#include <exception>
+#include <streambuf>
+
+// istream sobre o código do chamador, sem copiá-lo: o lexer de autômatos só
+// usa peek/get/tellg/seekg
+class ViewStreamBuf : public streambuf
+{
+public:
+    ViewStreamBuf(string_view texto)
+    {
+        char *inicio = const_cast<char *>(texto.data()); // só lido
+        setg(inicio, inicio, inicio + texto.size());
+    }
+
+protected:
+    pos_type seekoff(off_type deslocamento, ios_base::seekdir direcao, ios_base::openmode modo) override
+    {
+        if (!(modo & ios_base::in))
+            return pos_type(off_type(-1));
+        off_type base = direcao == ios_base::beg ? 0 : direcao == ios_base::cur ? gptr() - eback() : egptr() - eback();
+        off_type pos = base + deslocamento;
+        if (pos < 0 || pos > egptr() - eback())
+            return pos_type(off_type(-1));
+        setg(eback(), eback() + pos, egptr());
+        return pos_type(pos);
+    }
+
+    pos_type seekpos(pos_type pos, ios_base::openmode modo) override
+    {
+        return seekoff(off_type(pos), ios_base::beg, modo);
+    }
+};
+
+// Repassa os tokens contando-os
+class ContadorLexer : public LexerBackend
+{
+public:
+    ContadorLexer(LexerBackend &origem) : origem(origem) {}
+    Token *scan() override
+    {
+        Token *tok = origem.scan();
+        if (tok != nullptr)
+            contados++;
+        return tok;
+    }
+
+    size_t contados = 0;
+
+private:
+    LexerBackend &origem;
+};
+
+// Dono dos tokens lidos (a árvore e a AST apontam para eles), mesmo se uma
+// exceção interromper a análise
+struct TokensLidos
+{
+    vector<Token *> tokens;
+    ~TokensLidos()
+    {
+        for (Token *tok : tokens)
+            delete tok;
+    }
+};
+
+Parser::Parser(ParserOptions opcoes) : opcoes(std::move(opcoes))
+{
+    initialize_ll1_table();
+}
+
+ParseResult Parser::parse(string_view fonte) const
+{
+    ParseResult resultado;
+    try
+    {
+        ViewStreamBuf buffer(fonte);
+        istream entrada(&buffer);
+        stringstream copia; // os outros backends trabalham sobre uma cópia
+        unique_ptr<LexerBackend> lexer;
+        if (opcoes.backend == "automata")
+        {
+            lexer.reset(new Lexer(entrada));
+        }
+        else
+        {
+            copia.str(string(fonte));
+            lexer.reset(make_lexer(opcoes.backend, copia, opcoes.tabelas.get()));
+        }
+        if (lexer == nullptr)
+        {
+            resultado.diagnostico = "Backend léxico desconhecido ou indisponível: " + opcoes.backend;
+            return resultado;
+        }
+
+        LineIndex linhas(fonte);
+        if (!opcoes.semantica)
+        {
+            // Sem árvore, o parser não guarda tokens e pilhas são liberadas
+            // mesmo se o lexer lançar uma exceção
+            ContadorLexer contador(*lexer);
+            ReleasingLexer tokens(contador);
+            resultado.aceito = parse_tokens(tokens, nullptr, false, resultado.diagnostico, &linhas);
+            resultado.tokens = contador.contados;
+            return resultado;
+        }
+
+        // A análise léxica vem antes, como na linha de comando
+        TokensLidos lidos;
+        bool lido = lex_source(*lexer, lidos.tokens, resultado.diagnostico, linhas);
+        resultado.tokens = lidos.tokens.size();
+        ParseNode *arvore = nullptr;
+        if (lido)
+        {
+            VectorLexer lexer_tokens(lidos.tokens);
+            resultado.aceito = parse_tokens(lexer_tokens, &arvore, false, resultado.diagnostico, &linhas);
+        }
+        if (resultado.aceito)
+        {
+            Programa *programa = build_ast(arvore);
+            IRProgram ir;
+            resultado.aceito = check_program(*programa, resultado.diagnostico, linhas, ir);
+            free_ast(programa);
+        }
+        free_parse_tree(arvore);
+    }
+    catch (const exception &e)
+    {
+        // Ex.: falta de memória (um erro léxico já volta como diagnóstico)
+        resultado.aceito = false;
+        resultado.diagnostico = string("Erro interno: ") + e.what();
+    }
+    return resultado;
+}
+
+bool lex_source(LexerBackend &lexer, vector<Token *> &tokens, string &diagnostico, const PositionResolver &linhas)
+{
+    try
+    {
+        while (Token *tok = lexer.scan())
+            tokens.push_back(tok);
+    }
+    catch (const LexicalError &e)
+    {
+        diagnostico = e.describe(&linhas);
+        return false;
+    }
+    return true;
+}
+
+// Uma mensagem por linha
+static void acrescentar(string &diagnostico, const string &tipo, const Token *token, const PositionResolver &linhas,
+                        const string &mensagem)
+{
+    if (!diagnostico.empty())
+        diagnostico += "\n";
+    diagnostico += tipo;
+    if (token != nullptr)
+        diagnostico += " (" + linhas.describe(token->offset) + ")";
+    diagnostico += ": " + mensagem + ".";
+}
+
+bool check_program(const Programa &programa, string &diagnostico, const PositionResolver &linhas, IRProgram &ir)
+{
+    bool aceito = true;
+    for (const auto &erro : analise_semantica(programa))
+    {
+        acrescentar(diagnostico, "Erro semântico", erro.token, linhas, erro.mensagem);
+        aceito = false;
+    }
+    if (!aceito)
+        return false;
+
+    // Avisos não rejeitam o programa
+    ir = lower_program(programa);
+    for (const auto &leitura : check_definite_assignment(ir))
+        acrescentar(diagnostico, "Aviso", leitura.token, linhas,
+                    "variável '" + leitura.var + "' pode ser lida antes de ser atribuída");
+    return true;
+}
@@ -0,0 +1,77 @@
+/*
+ * Trabalho de Compiladores - Biblioteca do Analisador
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo define a interface para usar o analisador dentro de outro
+ * programa. Um Parser guarda só a configuração (backend léxico e tabelas
+ * compartilhadas, somente leitura) e parse() é const e reentrante: lexer,
+ * pilha, árvore, AST e tabela de símbolos são locais à chamada, e as tabelas
+ * LL(1) são montadas uma única vez e depois só lidas. Várias threads podem
+ * validar códigos ao mesmo tempo, até com o mesmo Parser, sem travas. Erros
+ * (inclusive backend inexistente e exceções internas) voltam no ParseResult;
+ * nada chama exit nem escreve na saída.
+ *
+ * Data: Outubro de 2026
+ */
+
+#ifndef PARSER_API_H
+#define PARSER_API_H
+
+#include "lexgen.h"
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+struct Programa;
+struct IRProgram;
+
+struct ParserOptions
+{
+    string backend = "automata";         // automata, dfa, direct ou flex (os dois últimos se compilados)
+    shared_ptr<const DfaTables> tabelas; // obrigatório para o backend dfa
+    bool semantica = true;               // false: só léxico e sintático, com memória constante
+};
+
+struct ParseResult
+{
+    bool aceito = false;
+    string diagnostico; // mesmas mensagens da linha de comando, uma por linha
+    size_t tokens = 0;  // lidos pelo lexer (sem semântica, a leitura para no erro sintático)
+};
+
+class Parser
+{
+public:
+    explicit Parser(ParserOptions opcoes = ParserOptions());
+
+    // O código só precisa existir durante a chamada
+    ParseResult parse(string_view fonte) const;
+
+    const ParserOptions &options() const { return opcoes; }
+
+private:
+    ParserOptions opcoes;
+};
+
+// Etapas do Parser::parse, também usadas pela linha de comando, que precisa
+// dos tokens, da árvore e da IR. Erros voltam no diagnóstico, com as mesmas
+// mensagens nos dois; nenhuma exceção do lexer escapa.
+
+// Lê todos os tokens. Com um erro léxico devolve false e o diagnóstico;
+// tokens fica com os lidos antes dele (a posse é de quem chamou)
+bool lex_source(LexerBackend &lexer, vector<Token *> &tokens, string &diagnostico, const PositionResolver &linhas);
+
+// Análise semântica de um programa aceito pelo parser: acrescenta os erros
+// semânticos e os avisos de atribuição definida ao diagnóstico. Devolve
+// false se houver erro semântico; senão ir recebe a IR do programa
+bool check_program(const Programa &programa, string &diagnostico, const PositionResolver &linhas, IRProgram &ir);
+
+#endif // PARSER_API_H
@@ -0,0 +1,431 @@
+/*
+ * Trabalho de Compiladores - Otimizações sobre a IR
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo implementa os passes de otimização da IR e o gerenciador que os
+ * executa, medindo o tempo de cada um e quanto trabalho foi removido.
+ *
+ * Data: Outubro de 2026
+ */
+
+#include "callgraph.h"
+#include "dataflow.h"
+#include "ir.h"
+#include <chrono>
+#include <iomanip>
+
+// ==========================
+// Propagação e dobra de constantes
+// ==========================
+
+// Reticulado de cada variável: INDEFINIDO (ainda não visto) < constante < NAC (não constante)
+struct Valor
+{
+    enum Estado
+    {
+        INDEFINIDO,
+        CONSTANTE,
+        NAC
+    } estado = INDEFINIDO;
+    int constante = 0;
+
+    bool operator==(const Valor &o) const { return estado == o.estado && (estado != CONSTANTE || constante == o.constante); }
+    bool operator!=(const Valor &o) const { return !(*this == o); }
+};
+
+static Valor meet(const Valor &a, const Valor &b)
+{
+    if (a.estado == Valor::INDEFINIDO)
+        return b;
+    if (b.estado == Valor::INDEFINIDO)
+        return a;
+    if (a == b)
+        return a;
+    return Valor{Valor::NAC, 0};
+}
+
+// Ordem reversa de pós-ordem a partir da entrada (só blocos alcançáveis)
+static vector<int> reverse_postorder(const IRFunction &f)
+{
+    vector<int> ordem;
+    vector<char> visitado(f.blocos.size(), 0);
+    vector<pair<int, size_t>> pilha = {{0, 0}};
+    visitado[0] = 1;
+    while (!pilha.empty())
+    {
+        auto &[bloco, proximo] = pilha.back();
+        vector<int> succs = f.sucessores(bloco);
+        if (proximo < succs.size())
+        {
+            int s = succs[proximo++];
+            if (!visitado[s])
+            {
+                visitado[s] = 1;
+                pilha.push_back({s, 0});
+            }
+        }
+        else
+        {
+            ordem.push_back(bloco);
+            pilha.pop_back();
+        }
+    }
+    return vector<int>(ordem.rbegin(), ordem.rend());
+}
+
+// Aplica a função de transferência de uma instrução sobre o estado
+static void transfer(const Instr &instr, vector<Valor> &estado)
+{
+    auto valor_de = [&](const Operando &op)
+    {
+        if (op.tipo == Operando::CONST)
+            return Valor{Valor::CONSTANTE, op.valor};
+        return estado[op.valor];
+    };
+
+    switch (instr.op)
+    {
+    case IR_COPY:
+        estado[instr.dest] = valor_de(instr.a);
+        break;
+    case IR_BIN:
+    {
+        Valor a = valor_de(instr.a), b = valor_de(instr.b);
+        int r;
+        if (a.estado == Valor::CONSTANTE && b.estado == Valor::CONSTANTE && eval_binop(instr.binop, a.constante, b.constante, r))
+            estado[instr.dest] = Valor{Valor::CONSTANTE, r};
+        else
+            estado[instr.dest] = Valor{Valor::NAC, 0};
+        break;
+    }
+    case IR_CALL:
+        if (instr.dest != -1)
+            estado[instr.dest] = Valor{Valor::NAC, 0};
+        break;
+    default:
+        break;
+    }
+}
+
+int ConstPropPass::run(IRFunction &f)
+{
+    size_t n = f.vars.size();
+    vector<int> ordem = reverse_postorder(f);
+
+    vector<vector<int>> preds(f.blocos.size());
+    for (int b : ordem)
+        for (int s : f.sucessores(b))
+            preds[s].push_back(b);
+
+    // Na entrada nada é conhecido: parâmetros e variáveis não inicializadas são NAC
+    vector<Valor> entrada(n, Valor{Valor::NAC, 0});
+    vector<vector<Valor>> saida(f.blocos.size(), vector<Valor>(n));
+
+    auto estado_entrada = [&](int b)
+    {
+        if (b == 0)
+            return entrada;
+        vector<Valor> estado(n);
+        for (int p : preds[b])
+            for (size_t v = 0; v < n; v++)
+                estado[v] = meet(estado[v], saida[p][v]);
+        return estado;
+    };
+
+    bool mudou = true;
+    while (mudou)
+    {
+        mudou = false;
+        for (int b : ordem)
+        {
+            vector<Valor> estado = estado_entrada(b);
+            for (const Instr &instr : f.blocos[b].instrs)
+                transfer(instr, estado);
+            if (estado != saida[b])
+            {
+                saida[b] = estado;
+                mudou = true;
+            }
+        }
+    }
+
+    // Reescreve: usos de variáveis constantes viram literais e operações com
+    // dois literais viram cópias do resultado
+    int alteracoes = 0;
+    for (int b : ordem)
+    {
+        vector<Valor> estado = estado_entrada(b);
+        for (Instr &instr : f.blocos[b].instrs)
+        {
+            auto propaga = [&](Operando &op)
+            {
+                if (op.tipo == Operando::VAR && estado[op.valor].estado == Valor::CONSTANTE)
+                {
+                    op = Operando::cte(estado[op.valor].constante);
+                    alteracoes++;
+                }
+            };
+            propaga(instr.a);
+            propaga(instr.b);
+            for (Operando &arg : instr.args)
+                propaga(arg);
+
+            int r;
+            if (instr.op == IR_BIN && instr.a.tipo == Operando::CONST && instr.b.tipo == Operando::CONST &&
+                eval_binop(instr.binop, instr.a.valor, instr.b.valor, r))
+            {
+                instr.op = IR_COPY;
+                instr.a = Operando::cte(r);
+                instr.b = Operando();
+                alteracoes++;
+            }
+            transfer(instr, estado);
+        }
+    }
+    return alteracoes;
+}
+
+// ==========================
+// Desvios com condição constante
+// ==========================
+
+int BranchFoldPass::run(IRFunction &f)
+{
+    int alteracoes = 0;
+    for (auto &bloco : f.blocos)
+    {
+        Instr &term = bloco.instrs.back();
+        if (term.op == IR_BR && term.a.tipo == Operando::CONST)
+        {
+            term.op = IR_JMP;
+            if (term.a.valor == 0)
+                term.alvo = term.alvo_senao;
+            term.alvo_senao = -1;
+            term.a = Operando();
+            alteracoes++;
+        }
+        else if (term.op == IR_BR && term.alvo == term.alvo_senao)
+        {
+            term.op = IR_JMP;
+            term.alvo_senao = -1;
+            term.a = Operando();
+            alteracoes++;
+        }
+    }
+    return alteracoes;
+}
+
+// ==========================
+// Código inalcançável (após return ou em ramos eliminados)
+// ==========================
+
+int UnreachablePass::run(IRFunction &f)
+{
+    vector<int> ordem = reverse_postorder(f);
+    if (ordem.size() == f.blocos.size())
+        return 0;
+
+    // Renumera os blocos alcançáveis mantendo a ordem original
+    vector<int> novo_id(f.blocos.size(), -1);
+    vector<char> alcancavel(f.blocos.size(), 0);
+    for (int b : ordem)
+        alcancavel[b] = 1;
+
+    int removidas = 0;
+    vector<BasicBlock> blocos;
+    for (size_t b = 0; b < f.blocos.size(); b++)
+    {
+        if (alcancavel[b])
+        {
+            novo_id[b] = blocos.size();
+            blocos.push_back(std::move(f.blocos[b]));
+        }
+        else
+        {
+            removidas += f.blocos[b].instrs.size();
+        }
+    }
+    for (auto &bloco : blocos)
+    {
+        Instr &term = bloco.instrs.back();
+        if (term.alvo != -1)
+            term.alvo = novo_id[term.alvo];
+        if (term.alvo_senao != -1)
+            term.alvo_senao = novo_id[term.alvo_senao];
+    }
+    f.blocos = std::move(blocos);
+    return removidas;
+}
+
+// ==========================
+// Junção de blocos (cadeias de jmp deixadas pelo inlining e pelos desvios dobrados)
+// ==========================
+
+int MergeBlocksPass::run(IRFunction &f)
+{
+    vector<int> preds(f.blocos.size(), 0);
+    for (size_t b = 0; b < f.blocos.size(); b++)
+        for (int s : f.sucessores(b))
+            preds[s]++;
+
+    // Um bloco que termina em "jmp s", sendo o único predecessor de s, absorve s
+    int alteracoes = 0;
+    for (size_t b = 0; b < f.blocos.size(); b++)
+    {
+        auto &instrs = f.blocos[b].instrs;
+        while (!instrs.empty() && instrs.back().op == IR_JMP)
+        {
+            int s = instrs.back().alvo;
+            if (s == 0 || s == (int)b || preds[s] != 1)
+                break;
+            instrs.pop_back();
+            auto &absorvido = f.blocos[s].instrs;
+            instrs.insert(instrs.end(), absorvido.begin(), absorvido.end());
+            absorvido.clear(); // fica sem predecessores; sai no unreachable abaixo
+            alteracoes++;
+        }
+    }
+    if (alteracoes > 0)
+        UnreachablePass().run(f);
+    return alteracoes;
+}
+
+// ==========================
+// Atribuições mortas
+// ==========================
+
+// Divisão que pode falhar na execução (por zero ou INT_MIN / -1): mesmo sem
+// uso do resultado ela fica, senão o erro de execução sumiria
+static bool pode_falhar(const Instr &instr)
+{
+    if (instr.op != IR_BIN || instr.binop != DIVIDE)
+        return false;
+    return instr.b.tipo != Operando::CONST || instr.b.valor == 0 || instr.b.valor == -1;
+}
+
+int DeadStorePass::run(IRFunction &f)
+{
+    int alteracoes = 0;
+
+    bool mudou = true;
+    while (mudou)
+    {
+        DataflowResult vivacidade = liveness(f);
+
+        // Remove definições cujo valor nunca é lido; chamadas (podem imprimir)
+        // e divisões que podem falhar ficam
+        mudou = false;
+        for (size_t b = 0; b < f.blocos.size(); b++)
+        {
+            BitVector &vivas = vivacidade.saida[b]; // não é mais usado depois
+            auto &instrs = f.blocos[b].instrs;
+            vector<Instr> mantidas;
+            for (auto it = instrs.rbegin(); it != instrs.rend(); ++it)
+            {
+                if (it->dest != -1 && !vivas.test(it->dest) && !pode_falhar(*it))
+                {
+                    if (it->op == IR_CALL)
+                    {
+                        it->dest = -1;
+                        alteracoes++;
+                    }
+                    else
+                    {
+                        alteracoes++;
+                        mudou = true;
+                        continue;
+                    }
+                }
+                if (it->dest != -1)
+                    vivas.reset(it->dest);
+                if (it->a.tipo == Operando::VAR)
+                    vivas.set(it->a.valor);
+                if (it->b.tipo == Operando::VAR)
+                    vivas.set(it->b.valor);
+                for (const Operando &arg : it->args)
+                    if (arg.tipo == Operando::VAR)
+                        vivas.set(arg.valor);
+                mantidas.push_back(*it);
+            }
+            instrs.assign(mantidas.rbegin(), mantidas.rend());
+        }
+    }
+    return alteracoes;
+}
+
+// ==========================
+// Gerenciador de passes
+// ==========================
+
+int Pass::run_program(IRProgram &ir)
+{
+    int alteracoes = 0;
+    for (auto &f : ir.funcoes)
+        alteracoes += run(f);
+    return alteracoes;
+}
+
+void PassManager::add(unique_ptr<Pass> pass)
+{
+    passes.push_back(std::move(pass));
+}
+
+void PassManager::run(IRProgram &ir)
+{
+    for (auto &pass : passes)
+    {
+        PassStats st;
+        st.nome = pass->nome();
+        st.instrs_antes = ir.num_instrs();
+
+        auto inicio = chrono::steady_clock::now();
+        st.alteracoes = pass->run_program(ir);
+        auto fim = chrono::steady_clock::now();
+
+        st.ms = chrono::duration<double, milli>(fim - inicio).count();
+        st.instrs_depois = ir.num_instrs();
+        stats.push_back(st);
+    }
+}
+
+void PassManager::report(ostream &out) const
+{
+    out << "=== Relatório dos passes ===\n";
+    out << left << setw(14) << "pass" << right << setw(12) << "tempo (ms)" << setw(10) << "antes" << setw(10) << "depois"
+        << setw(12) << "removidas" << setw(12) << "alteracoes" << "\n";
+    int antes = stats.empty() ? 0 : stats.front().instrs_antes;
+    int depois = stats.empty() ? 0 : stats.back().instrs_depois;
+    double total_ms = 0;
+    for (const auto &st : stats)
+    {
+        out << left << setw(14) << st.nome << right << setw(12) << fixed << setprecision(3) << st.ms << setw(10) << st.instrs_antes
+            << setw(10) << st.instrs_depois << setw(12) << (st.instrs_antes - st.instrs_depois) << setw(12) << st.alteracoes << "\n";
+        total_ms += st.ms;
+    }
+    out << "Total: " << antes << " -> " << depois << " instruções (" << (antes - depois) << " removidas) em "
+        << fixed << setprecision(3) << total_ms << " ms\n";
+    for (const auto &pass : passes)
+    {
+        string resumo = pass->resumo();
+        if (!resumo.empty())
+            out << resumo;
+    }
+}
+
+PassManager default_pipeline()
+{
+    PassManager pm;
+    pm.add(make_unique<InlinePass>());
+    pm.add(make_unique<ConstPropPass>());
+    pm.add(make_unique<BranchFoldPass>());
+    pm.add(make_unique<UnreachablePass>());
+    pm.add(make_unique<MergeBlocksPass>());
+    pm.add(make_unique<ConstPropPass>());
+    pm.add(make_unique<DeadStorePass>());
+    return pm;
+}
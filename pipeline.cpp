@@ -0,0 +1,143 @@
+/*
+ * Trabalho de Compiladores - Lexer e Parser em Pipeline
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo implementa o PipelinedLexer: a thread produtora e o
+ * consumo em lotes no lado do parser.
+ *
+ * Data: Outubro de 2026
+ */
+
+#include "pipeline.h"
+#include "alloc_profile.h"
+
+PipelinedLexer::PipelinedLexer(LexerBackend &origem, size_t capacidade, size_t lote)
+    : origem(origem), fila(capacidade), lote(max<size_t>(1, min(lote, capacidade)))
+{
+    produtor = thread(&PipelinedLexer::produzir, this);
+}
+
+PipelinedLexer::~PipelinedLexer()
+{
+    cancelado.store(true, memory_order_relaxed);
+    if (produtor.joinable())
+        produtor.join();
+
+    // Tokens publicados que o parser não chegou a pegar
+    for (size_t i = proximo; i < recebidos.size(); i++)
+        delete recebidos[i];
+    Token *resto[64];
+    size_t n;
+    while ((n = fila.pop(resto, 64)) > 0)
+        for (size_t i = 0; i < n; i++)
+            delete resto[i];
+}
+
+void PipelinedLexer::produzir()
+{
+    set_alloc_phase(FASE_LEXICO);
+    vector<Token *> pendentes;
+    pendentes.reserve(lote);
+
+    // Publica o lote inteiro, esperando espaço na fila (contrapressão)
+    auto publicar = [&]()
+    {
+        size_t enviados = 0;
+        unsigned tentativas = 0;
+        while (enviados < pendentes.size())
+        {
+            if (cancelado.load(memory_order_relaxed))
+                return false;
+            size_t n = fila.push(pendentes.data() + enviados, pendentes.size() - enviados);
+            enviados += n;
+            if (n == 0)
+                esperar_fila(tentativas);
+            else
+                tentativas = 0;
+        }
+        pendentes.clear();
+        return true;
+    };
+
+    try
+    {
+        Token *tok;
+        while (!cancelado.load(memory_order_relaxed) && (tok = origem.scan()) != nullptr)
+        {
+            pendentes.push_back(tok);
+            if (pendentes.size() == lote && !publicar())
+                break;
+        }
+        if (!cancelado.load(memory_order_relaxed))
+            publicar();
+    }
+    catch (...)
+    {
+        // Entrega o que já foi lido e depois o erro
+        publicar();
+        erro = current_exception();
+    }
+
+    for (Token *tok : pendentes) // sobra quando cancelado
+        delete tok;
+    terminou.store(true, memory_order_release);
+}
+
+bool PipelinedLexer::receber()
+{
+    unsigned tentativas = 0;
+    while (true)
+    {
+        size_t n = fila.pop(recebidos.data(), lote);
+        if (n > 0)
+        {
+            recebidos.resize(n);
+            proximo = 0;
+            return true;
+        }
+        if (terminou.load(memory_order_acquire))
+        {
+            // Tokens publicados antes do fim chegam na mesma leitura acquire
+            n = fila.pop(recebidos.data(), lote);
+            if (n > 0)
+            {
+                recebidos.resize(n);
+                proximo = 0;
+                return true;
+            }
+            fim = true;
+            recebidos.clear();
+            proximo = 0;
+            if (erro)
+                rethrow_exception(erro);
+            return false;
+        }
+        esperar_fila(tentativas);
+    }
+}
+
+Token *PipelinedLexer::scan()
+{
+    if (proximo == recebidos.size())
+    {
+        if (fim)
+            return nullptr;
+        recebidos.resize(lote);
+        if (!receber())
+            return nullptr;
+    }
+    Token *tok = recebidos[proximo++];
+    tokens.push_back(tok);
+    return tok;
+}
+
+void PipelinedLexer::finish()
+{
+    while (scan() != nullptr)
+        ;
+}
@@ -0,0 +1,79 @@
+/*
+ * Trabalho de Compiladores - Lexer e Parser em Pipeline
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo define o PipelinedLexer, backend léxico que roda outro lexer
+ * em uma thread própria. A thread do lexer junta os tokens em lotes e os
+ * publica em uma SpscRing; o parser, na thread que chama scan(), consome os
+ * lotes enquanto o lexer continua produzindo.
+ *
+ *   - Contrapressão: com a fila cheia o lexer espera o parser consumir.
+ *   - Erro no lexer: a exceção é capturada na thread do lexer e relançada
+ *     no scan() do parser depois dos tokens que já tinham sido publicados.
+ *   - Parser que para antes do fim (erro de sintaxe, exceção): o destrutor
+ *     cancela o lexer, espera a thread terminar e libera os tokens que
+ *     ficaram na fila.
+ *
+ * A espera (fila cheia ou vazia) gira algumas vezes e depois cede o
+ * processador, para não desperdiçar o núcleo quando há menos núcleos que
+ * threads.
+ *
+ * Data: Outubro de 2026
+ */
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include "automata.h"
+#include "lexer.h"
+#include "spsc_ring.h"
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+class PipelinedLexer : public LexerBackend
+{
+public:
+    // O lexer de origem passa a ser usado só pela thread do pipeline até o
+    // destrutor (ou finish()). lote = tokens publicados de uma vez.
+    PipelinedLexer(LexerBackend &origem, size_t capacidade = 1 << 14, size_t lote = 256);
+    ~PipelinedLexer();
+
+    Token *scan() override;
+
+    // Consome o que o lexer ainda não entregou (sem repassar ao parser), para
+    // quem precisa da lista completa depois de um erro de sintaxe
+    void finish();
+
+    // Todos os tokens entregues (por scan() e finish()), na ordem; a posse é
+    // de quem chamou
+    vector<Token *> tokens;
+
+private:
+    LexerBackend &origem;
+    SpscRing<Token *> fila;
+    size_t lote;
+    thread produtor;
+
+    atomic<bool> terminou{false};  // o lexer chegou ao fim (ou falhou)
+    atomic<bool> cancelado{false}; // o parser desistiu
+    exception_ptr erro;            // escrito antes de terminou (release)
+
+    // Lote local do consumidor
+    vector<Token *> recebidos;
+    size_t proximo = 0;
+    bool fim = false;
+
+    void produzir();
+    bool receber(); // false no fim da entrada
+};
+
+#endif // PIPELINE_H
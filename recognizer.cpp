@@ -0,0 +1,400 @@
+/*
+ * Trabalho de Compiladores - Reconhecedor sem Alocação
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo implementa o laço fundido AFD + LL(1) do modo --check.
+ *
+ * Data: Outubro de 2026
+ */
+
+#include "recognizer.h"
+#include "line_index.h"
+#include <cctype>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <memory>
+
+Recognizer::Recognizer(const DfaTables &tabelas) : tabelas(tabelas), pilha(1 << 12)
+{
+    initialize_ll1_table();
+    memset(acao, 0, sizeof(acao));
+    for (int nt = 0; nt < NUM_NONTERMINALS; nt++)
+        for (int t = 0; t < NUM_TERMINALS && t < LARGURA; t++)
+            acao[nt][t] = ll1_entry(static_cast<NonTerminals>(nt), static_cast<Tag>(t));
+
+    memset(inicio_producao, 0, sizeof(inicio_producao));
+    memset(tamanho_producao, 0, sizeof(tamanho_producao));
+    for (int p = PROD_S_0; p <= PROD_FACTOR_NUM; p++)
+    {
+        const vector<Symbol> &simbolos = production_symbols(static_cast<Productions>(p));
+        inicio_producao[p] = lados_direitos.size();
+        tamanho_producao[p] = simbolos.size();
+        for (auto it = simbolos.rbegin(); it != simbolos.rend(); ++it)
+            lados_direitos.push_back(holds_alternative<Tag>(*it) ? get<Tag>(*it) : SIMBOLO_NT + get<NonTerminals>(*it));
+    }
+
+    montar_cadeias();
+    montar_espacos();
+}
+
+// Simula, em uma pilha só com o não-terminal, os passos do laço para a tag:
+// expande até casar a tag com um terminal no topo ou a pilha esvaziar (só
+// produções vazias). O que sobra é o que a cadeia deixa no lugar dele. Se
+// algum passo daria erro ou chegaria ao $, a combinação fica sem cadeia.
+void Recognizer::montar_cadeias()
+{
+    const int MAX_PASSOS = 64; // a gramática LL(1) não tem recursão à esquerda
+    vector<uint8_t> simulada;
+    for (int nt = 0; nt < NUM_NONTERMINALS; nt++)
+        for (int t = 0; t < NUM_TERMINALS && t < LARGURA; t++)
+        {
+            simulada.assign(1, SIMBOLO_NT + nt);
+            uint8_t estado = SEM_CADEIA;
+            for (int passo = 0; passo < MAX_PASSOS; passo++)
+            {
+                if (simulada.empty())
+                {
+                    estado = ESVAZIOU;
+                    break;
+                }
+                uint8_t x = simulada.back();
+                if (x < SIMBOLO_NT)
+                {
+                    if (x == t && x != EOF_TOKEN)
+                    {
+                        simulada.pop_back();
+                        estado = CASOU;
+                    }
+                    break;
+                }
+                int prod = acao[x - SIMBOLO_NT][t];
+                if (prod == EMPTY)
+                    break;
+                simulada.pop_back();
+                simulada.insert(simulada.end(), lados_direitos.begin() + inicio_producao[prod],
+                                lados_direitos.begin() + inicio_producao[prod] + tamanho_producao[prod]);
+            }
+            if (estado == SEM_CADEIA || simulada.size() > UINT8_MAX || simbolos_cadeias.size() > UINT16_MAX)
+                continue;
+
+            Cadeia &c = cadeias[nt][t];
+            c.inicio = simbolos_cadeias.size();
+            c.tamanho = simulada.size();
+            c.estado = estado;
+            simbolos_cadeias.insert(simbolos_cadeias.end(), simulada.begin(), simulada.end());
+        }
+}
+
+// Vale só se todos os bytes que levam do estado inicial ao estado do espaço
+// ficam nele e qualquer outro byte o mata: aí uma sequência desses bytes é
+// sempre um único token ignorado, e pulá-la dá o mesmo resultado do AFD.
+void Recognizer::montar_espacos()
+{
+    int s = tabelas.proximo(tabelas.inicial, ' ');
+    if (s == 0 || tabelas.aceita[s] != LEX_IGNORA)
+        return;
+    bool candidato[256];
+    for (int c = 0; c < 256; c++)
+    {
+        candidato[c] = tabelas.proximo(tabelas.inicial, c) == s;
+        if (tabelas.proximo(s, c) != (candidato[c] ? s : 0))
+            return;
+    }
+    memcpy(espaco, candidato, sizeof(espaco));
+}
+
+// Quantos caracteres tem to_string(stoi(digitos)), que é o lexema de um Num;
+// estouro = true se o valor não cabe em um int
+static size_t digitos_normalizados(const unsigned char *p, const unsigned char *fim, bool &estouro)
+{
+    long long valor = 0;
+    for (; p < fim; p++)
+    {
+        valor = valor * 10 + (*p - '0');
+        if (valor > INT_MAX)
+        {
+            estouro = true;
+            return 0;
+        }
+    }
+    size_t n = 1;
+    for (; valor >= 10; valor /= 10)
+        n++;
+    return n;
+}
+
+// Texto inteiro em memória: a janela é a fonte toda e nunca anda
+struct JanelaMemoria
+{
+    string_view fonte;
+    LineIndex linhas;
+
+    explicit JanelaMemoria(string_view fonte) : fonte(fonte), linhas(fonte) {}
+    const char *inicio() const { return fonte.data(); }
+    const char *fim() const { return fonte.data() + fonte.size(); }
+    size_t deslocamento() const { return 0; }
+    bool mais(size_t) { return false; }
+    const PositionResolver &posicoes() const { return linhas; }
+};
+
+// Texto em blocos (StreamInput): a janela anda, e as linhas das posições que
+// saíram dela já foram contadas pela própria fonte
+struct JanelaBlocos
+{
+    BlockSource &fonte;
+
+    const char *inicio() const { return fonte.window_begin(); }
+    const char *fim() const { return fonte.window_end(); }
+    size_t deslocamento() const { return fonte.window_offset(); }
+    bool mais(size_t manter) { return fonte.next_block(manter); }
+    const PositionResolver &posicoes() const { return fonte; }
+};
+
+bool Recognizer::check(string_view fonte, string &erro, size_t *tokens)
+{
+    JanelaMemoria janela(fonte);
+    return reconhecer(janela, erro, tokens);
+}
+
+bool Recognizer::check(BlockSource &fonte, string &erro, size_t *tokens)
+{
+    JanelaBlocos janela{fonte};
+    return reconhecer(janela, erro, tokens);
+}
+
+// Os offsets são do início do texto: desloc é o offset de base, o começo da
+// janela atual. Com o texto em memória desloc é sempre 0 e mais() nunca lê.
+template <class Janela>
+bool Recognizer::reconhecer(Janela &janela, string &erro, size_t *tokens)
+{
+    const unsigned char *base = reinterpret_cast<const unsigned char *>(janela.inicio());
+    const unsigned char *p = base;
+    const unsigned char *fim = reinterpret_cast<const unsigned char *>(janela.fim());
+    size_t desloc = janela.deslocamento();
+
+    // Token atual: tag e [inicio, fim_token). No fim da entrada, tag = $ e
+    // fim_real = true, na posição em que o parser põe o token $ (fim do
+    // lexema do token anterior)
+    int tag = EOF_TOKEN;
+    const unsigned char *inicio = base, *fim_token = base;
+    size_t fim_anterior = desloc;
+    bool fim_real = false;
+    bool estouro = false;
+    size_t lidos = 0;
+
+    // Pede o próximo bloco com p no fim da janela. Fica tudo desde o fim do
+    // token anterior, onde o $ é posto, então o token em leitura continua
+    // inteiro. A janela muda de lugar mesmo quando não há mais texto, então
+    // true (ler de novo a partir de p) até a última chamada depois do fim.
+    bool acabou = false;
+    auto mais_texto = [&]()
+    {
+        if (acabou)
+            return false;
+        size_t off_p = desloc + (p - base);
+        acabou = !janela.mais(fim_anterior);
+        base = reinterpret_cast<const unsigned char *>(janela.inicio());
+        fim = reinterpret_cast<const unsigned char *>(janela.fim());
+        desloc = janela.deslocamento();
+        p = base + (off_p - desloc);
+        return true;
+    };
+
+    // DfaTables::casar com as tabelas em variáveis locais: as escritas na
+    // pilha de bytes forçariam o compilador a relê-las a cada byte
+    const int32_t *transicoes = tabelas.transicoes.data();
+    const int16_t *aceita = tabelas.aceita.data();
+    const uint8_t *classe = tabelas.classe;
+    const int num_classes = tabelas.num_classes;
+    const int inicial = tabelas.inicial;
+    const bool *espaco = this->espaco;
+
+    // Mesmo laço de proximo_token, sem criar o Token. Um token cortado pelo
+    // fim da janela é lido de novo depois do próximo bloco.
+    auto avancar = [&]()
+    {
+        while (true)
+        {
+            if (p >= fim)
+            {
+                if (mais_texto())
+                    continue;
+                break;
+            }
+            if (espaco[*p])
+            {
+                do
+                    p++;
+                while (p < fim && espaco[*p]);
+                continue;
+            }
+
+            const unsigned char *fim_casamento = p;
+            const unsigned char *q = p;
+            int t = LEX_NENHUMA;
+            int estado = inicial;
+            while (q < fim)
+            {
+                estado = transicoes[estado * num_classes + classe[*q++]];
+                if (estado == 0)
+                    break;
+                if (aceita[estado] != LEX_NENHUMA)
+                {
+                    t = aceita[estado];
+                    fim_casamento = q;
+                }
+            }
+            if (q == fim && estado != 0 && mais_texto())
+                continue;
+            if (t == LEX_IGNORA)
+            {
+                p = fim_casamento;
+                continue;
+            }
+            if (t == LEX_NENHUMA && isspace(*p))
+            {
+                p++;
+                continue;
+            }
+
+            if (t == LEX_NENHUMA || t == UNK)
+            {
+                const unsigned char *r = p;
+                while (r < fim && !isspace(*r))
+                    r++;
+                if (r == fim && mais_texto())
+                    continue;
+                lidos++;
+                inicio = p;
+                tag = UNK;
+                fim_token = p = r;
+                fim_anterior = desloc + (p - base);
+                return;
+            }
+            lidos++;
+            inicio = p;
+            tag = t;
+            fim_token = p = fim_casamento;
+            fim_anterior = desloc + (t == NUM ? (inicio - base) + digitos_normalizados(inicio, fim_token, estouro)
+                                              : fim_token - base);
+            return;
+        }
+        tag = EOF_TOKEN;
+        fim_real = true;
+        inicio = fim_token = base + (fim_anterior - desloc);
+    };
+
+    // Daqui para baixo só roda ao rejeitar: cria o token do erro para usar
+    // as mesmas mensagens do parse_tokens
+    const PositionResolver &linhas = janela.posicoes();
+    auto local = [&]() { return " (" + linhas.describe(desloc + (inicio - base)) + ")"; };
+    auto token_erro = [&]()
+    {
+        unique_ptr<Token> tok;
+        string lexema(reinterpret_cast<const char *>(inicio), fim_token - inicio);
+        if (fim_real)
+            tok.reset(new Token(EOF_TOKEN, "$"));
+        else if (tag == UNK)
+            tok.reset(new Unknown(UNK, lexema));
+        else
+            tok.reset(create_token(static_cast<Tag>(tag), lexema, 0));
+        tok->offset = desloc + (inicio - base);
+        return tok;
+    };
+    auto terminar = [&](bool aceito)
+    {
+        if (tokens != nullptr)
+            *tokens += lidos;
+        return aceito;
+    };
+    auto erro_lexico = [&]()
+    {
+        string lexema(reinterpret_cast<const char *>(inicio), fim_token - inicio);
+        erro = LexicalError(lexema, desloc + (inicio - base)).describe(&linhas);
+        return terminar(false);
+    };
+
+    uint8_t *topo = pilha.data();
+    uint8_t *limite = pilha.data() + pilha.size();
+    *topo++ = SIMBOLO_NT + NT_S;
+
+    avancar();
+    if (estouro)
+        return erro_lexico();
+
+    while (true)
+    {
+        uint8_t x = topo[-1];
+        if (x == EOF_TOKEN)
+            break;
+        if (x == tag)
+        {
+            topo--;
+            avancar();
+            if (estouro)
+                return erro_lexico();
+            continue;
+        }
+        if (x < SIMBOLO_NT)
+        {
+            erro = ll1_error_terminal(local(), *token_erro(), static_cast<Tag>(x));
+            return terminar(false);
+        }
+
+        const Cadeia &cadeia = cadeias[x - SIMBOLO_NT][tag];
+        if (cadeia.estado != SEM_CADEIA)
+        {
+            topo--;
+            if (topo + cadeia.tamanho > limite)
+            {
+                size_t usado = topo - pilha.data();
+                pilha.resize(max(pilha.size() * 2, usado + cadeia.tamanho));
+                topo = pilha.data() + usado;
+                limite = pilha.data() + pilha.size();
+            }
+            memcpy(topo, simbolos_cadeias.data() + cadeia.inicio, cadeia.tamanho);
+            topo += cadeia.tamanho;
+            if (cadeia.estado == CASOU)
+            {
+                avancar();
+                if (estouro)
+                    return erro_lexico();
+            }
+            continue;
+        }
+
+        // Sem cadeia: passo a passo, para o erro sair no mesmo ponto do parser
+        int prod = acao[x - SIMBOLO_NT][tag];
+        if (prod == EMPTY)
+        {
+            erro = ll1_error_nonterminal(local(), *token_erro(), static_cast<NonTerminals>(x - SIMBOLO_NT));
+            return terminar(false);
+        }
+
+        topo--;
+        size_t n = tamanho_producao[prod];
+        if (topo + n > limite)
+        {
+            // Só em aninhamentos mais fundos que os já vistos; a pilha maior fica
+            size_t usado = topo - pilha.data();
+            pilha.resize(pilha.size() * 2);
+            topo = pilha.data() + usado;
+            limite = pilha.data() + pilha.size();
+        }
+        memcpy(topo, lados_direitos.data() + inicio_producao[prod], n);
+        topo += n;
+    }
+
+    if (!fim_real)
+    {
+        erro = ll1_error_trailing(local(), *token_erro());
+        return terminar(false);
+    }
+    return terminar(true);
+}
@@ -0,0 +1,89 @@
+/*
+ * Trabalho de Compiladores - Reconhecedor sem Alocação
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo define o reconhecedor do modo --check: o AFD gerado a partir
+ * do lexer.l e o LL(1) fundidos em um único laço sobre os bytes. Cada tag
+ * reconhecida vai direto para a pilha, sem objetos Token, lexemas ou árvore.
+ * A pilha é um vetor de bytes (terminal = Tag, não-terminal = 32 + índice)
+ * reaproveitado entre chamadas, e as tabelas LL(1) são copiadas em forma
+ * compacta no construtor, então aceitar um código não aloca memória.
+ *
+ * Ao rejeitar, só então o token do erro é criado para montar o mesmo
+ * diagnóstico do parser LL(1) (mesma mensagem, linha e coluna). Uma
+ * constante maior que um int dá o mesmo erro léxico do create_token.
+ *
+ * O texto pode vir inteiro em memória ou em blocos de um BlockSource (a
+ * entrada comprimida do --check): aí um token cortado pelo fim de um bloco é
+ * lido de novo depois do próximo, e o que vem antes do token anterior sai da
+ * janela.
+ *
+ * Data: Outubro de 2026
+ */
+
+#ifndef RECOGNIZER_H
+#define RECOGNIZER_H
+
+#include "lexgen.h"
+#include "line_index.h"
+#include "parser.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+class Recognizer
+{
+public:
+    // As tabelas precisam continuar vivas enquanto o reconhecedor for usado
+    explicit Recognizer(const DfaTables &tabelas);
+
+    // Retorna true se o código é aceito; senão o diagnóstico vai para erro.
+    // Se tokens != nullptr, soma nele os tokens lidos (até o erro, se houver).
+    bool check(string_view fonte, string &erro, size_t *tokens = nullptr);
+    // O mesmo sobre um texto lido em blocos, sem tê-lo inteiro em memória
+    bool check(BlockSource &fonte, string &erro, size_t *tokens = nullptr);
+
+private:
+    static const int SIMBOLO_NT = 32;
+    static const int LARGURA = 32; // colunas da tabela (Tags cabem em 5 bits)
+
+    const DfaTables &tabelas;
+    uint8_t acao[NUM_NONTERMINALS][LARGURA]; // produção ou 0
+    vector<uint8_t> lados_direitos;          // de trás para frente, já na ordem de empilhar
+    uint16_t inicio_producao[PROD_FACTOR_NUM + 1];
+    uint8_t tamanho_producao[PROD_FACTOR_NUM + 1];
+
+    // Cadeia de expansões de (não-terminal, tag) feita de uma vez: o que fica
+    // na pilha no lugar do não-terminal e se o token já foi casado. Sem
+    // cadeia (combinação de erro), o laço faz um passo comum.
+    struct Cadeia
+    {
+        uint16_t inicio = 0;
+        uint8_t tamanho = 0;
+        uint8_t estado = SEM_CADEIA;
+    };
+    static const uint8_t SEM_CADEIA = 0, CASOU = 1, ESVAZIOU = 2;
+    Cadeia cadeias[NUM_NONTERMINALS][LARGURA];
+    vector<uint8_t> simbolos_cadeias;
+
+    // Bytes que o AFD sempre junta em um único token ignorado (espaços): são
+    // pulados sem passar pelas tabelas. Vazio se o AFD não garante isso.
+    bool espaco[256] = {};
+
+    vector<uint8_t> pilha;
+
+    void montar_cadeias();
+    void montar_espacos();
+    template <class Janela>
+    bool reconhecer(Janela &janela, string &erro, size_t *tokens);
+};
+
+#endif // RECOGNIZER_H
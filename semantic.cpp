@@ -0,0 +1,268 @@
+/*
+ * Trabalho de Compiladores - Análise Semântica
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo implementa a tabela de símbolos com log de desfazer e a
+ * verificação semântica da AST.
+ *
+ * Data: Outubro de 2026
+ */
+
+#include "semantic.h"
+
+// FNV-1a de 64 bits, misturado com o espaço de nomes
+static uint64_t hash_nome(string_view nome, Simbolo::Tipo espaco)
+{
+    uint64_t h = 1469598103934665603ULL ^ static_cast<uint64_t>(espaco);
+    for (char c : nome)
+    {
+        h ^= static_cast<unsigned char>(c);
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+TabelaSimbolos::TabelaSimbolos(size_t capacidade)
+{
+    // Capacidade sempre potência de 2 para indexar com máscara
+    size_t cap = 16;
+    while (cap < capacidade)
+        cap <<= 1;
+    slots.resize(cap);
+}
+
+void TabelaSimbolos::entrar_escopo()
+{
+    marcas.push_back(log.size());
+}
+
+void TabelaSimbolos::sair_escopo()
+{
+    size_t marca = marcas.back();
+    marcas.pop_back();
+    while (log.size() > marca)
+    {
+        slots[log.back().slot].simbolo = log.back().anterior;
+        log.pop_back();
+    }
+}
+
+size_t TabelaSimbolos::procurar(string_view nome, Simbolo::Tipo espaco, uint64_t hash) const
+{
+    size_t mascara = slots.size() - 1;
+    size_t i = hash & mascara;
+    while (slots[i].espaco != Simbolo::NENHUM)
+    {
+        if (slots[i].hash == hash && slots[i].espaco == espaco && slots[i].nome == nome)
+            return i;
+        i = (i + 1) & mascara;
+    }
+    return i;
+}
+
+void TabelaSimbolos::crescer()
+{
+    vector<Slot> antigos(slots.size() * 2);
+    antigos.swap(slots);
+
+    // Os slots mudam de posição, então o log de desfazer é remapeado junto
+    vector<size_t> nova_posicao(antigos.size());
+    for (size_t i = 0; i < antigos.size(); i++)
+    {
+        if (antigos[i].espaco == Simbolo::NENHUM)
+            continue;
+        size_t j = procurar(antigos[i].nome, antigos[i].espaco, antigos[i].hash);
+        slots[j] = antigos[i];
+        nova_posicao[i] = j;
+    }
+    for (auto &d : log)
+        d.slot = nova_posicao[d.slot];
+}
+
+bool TabelaSimbolos::declarar(string_view nome, const Simbolo &simbolo)
+{
+    // Fator de carga máximo de 1/2
+    if ((ocupados + 1) * 2 > slots.size())
+        crescer();
+
+    uint64_t hash = hash_nome(nome, simbolo.tipo);
+    size_t i = procurar(nome, simbolo.tipo, hash);
+    Slot &slot = slots[i];
+
+    if (slot.espaco == Simbolo::NENHUM)
+    {
+        slot.hash = hash;
+        slot.nome = nome;
+        slot.espaco = simbolo.tipo;
+        ocupados++;
+    }
+    else if (slot.simbolo.tipo != Simbolo::NENHUM && slot.simbolo.nivel == nivel())
+    {
+        return false;
+    }
+
+    log.push_back(Desfazer{i, slot.simbolo});
+    slot.simbolo = simbolo;
+    slot.simbolo.nivel = nivel();
+    return true;
+}
+
+const Simbolo *TabelaSimbolos::buscar(string_view nome, Simbolo::Tipo tipo) const
+{
+    const Slot &slot = slots[procurar(nome, tipo, hash_nome(nome, tipo))];
+    if (slot.espaco == Simbolo::NENHUM || slot.simbolo.tipo == Simbolo::NENHUM)
+        return nullptr;
+    return &slot.simbolo;
+}
+
+// ==========================
+// Verificação da AST
+// ==========================
+
+class Checker
+{
+public:
+    vector<ErroSemantico> erros;
+
+    void check_programa(const Programa &programa)
+    {
+        // As funções são globais e podem ser chamadas antes da definição, então
+        // as assinaturas são registradas antes de percorrer os corpos
+        for (const Funcao *f : programa.funcoes)
+        {
+            if (f->nome.nome.empty())
+                continue;
+            Simbolo s;
+            s.tipo = Simbolo::FUNCAO;
+            s.aridade = f->params.size();
+            s.decl = f->nome.token;
+            if (!tabela.declarar(f->nome.nome, s))
+                erro("função '" + f->nome.nome + "' já foi definida", f->nome.token);
+        }
+
+        for (const Funcao *f : programa.funcoes)
+        {
+            tabela.entrar_escopo();
+            for (const auto &param : f->params)
+                declarar_variavel(param);
+            for (const Stmt *s : f->corpo)
+                check_stmt(s);
+            tabela.sair_escopo();
+        }
+    }
+
+private:
+    TabelaSimbolos tabela;
+
+    void erro(const string &mensagem, Token *token)
+    {
+        erros.push_back(ErroSemantico{mensagem, token});
+    }
+
+    void declarar_variavel(const Ident &id)
+    {
+        Simbolo s;
+        s.tipo = Simbolo::VARIAVEL;
+        s.decl = id.token;
+        if (!tabela.declarar(id.nome, s))
+            erro("variável '" + id.nome + "' já foi declarada neste escopo", id.token);
+    }
+
+    void usar_variavel(const Ident &id)
+    {
+        if (tabela.buscar(id.nome, Simbolo::VARIAVEL) == nullptr)
+            erro("variável '" + id.nome + "' não foi declarada", id.token);
+    }
+
+    void check_chamada(const Chamada *c)
+    {
+        const Simbolo *f = tabela.buscar(c->funcao.nome, Simbolo::FUNCAO);
+        if (f == nullptr)
+            erro("função '" + c->funcao.nome + "' não foi definida", c->funcao.token);
+        else if (f->aridade != (int)c->args.size())
+            erro("função '" + c->funcao.nome + "' espera " + to_string(f->aridade) + " argumento(s), mas recebeu " +
+                     to_string(c->args.size()),
+                 c->funcao.token);
+
+        for (const auto &arg : c->args)
+            usar_variavel(arg);
+    }
+
+    void check_expr(const Expr *e)
+    {
+        switch (e->tipo)
+        {
+        case EXPR_VAR:
+            usar_variavel(e->var);
+            break;
+        case EXPR_BIN:
+            check_expr(e->esq);
+            check_expr(e->dir);
+            break;
+        default:
+            break;
+        }
+    }
+
+    // Corpo de if/else é um escopo próprio mesmo quando não é um bloco
+    void check_escopo(const Stmt *s)
+    {
+        tabela.entrar_escopo();
+        check_stmt(s);
+        tabela.sair_escopo();
+    }
+
+    void check_stmt(const Stmt *s)
+    {
+        switch (s->tipo)
+        {
+        case STMT_DECL:
+            for (const auto &nome : s->nomes)
+                declarar_variavel(nome);
+            break;
+        case STMT_ATRIB:
+            if (s->chamada != nullptr)
+                check_chamada(s->chamada);
+            else
+                check_expr(s->expr);
+            usar_variavel(s->alvo);
+            break;
+        case STMT_CHAMADA:
+            check_chamada(s->chamada);
+            break;
+        case STMT_PRINT:
+            check_expr(s->expr);
+            break;
+        case STMT_RETURN:
+            if (!s->alvo.nome.empty())
+                usar_variavel(s->alvo);
+            break;
+        case STMT_IF:
+            check_expr(s->expr);
+            check_escopo(s->entao);
+            if (s->senao != nullptr)
+                check_escopo(s->senao);
+            break;
+        case STMT_BLOCO:
+            tabela.entrar_escopo();
+            for (const Stmt *filho : s->corpo)
+                check_stmt(filho);
+            tabela.sair_escopo();
+            break;
+        case STMT_VAZIO:
+            break;
+        }
+    }
+};
+
+vector<ErroSemantico> analise_semantica(const Programa &programa)
+{
+    Checker checker;
+    checker.check_programa(programa);
+    return checker.erros;
+}
@@ -0,0 +1,97 @@
+/*
+ * Trabalho de Compiladores - Análise Semântica
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo define a tabela de símbolos e a análise semântica da AST.
+ *
+ * A tabela de símbolos é uma única tabela hash de endereçamento aberto (sondagem
+ * linear) com um log de desfazer: ao declarar um nome que esconde outro, a
+ * ligação anterior vai para o log, e sair de um escopo apenas desfaz o log até a
+ * marca do escopo. Assim não existe um mapa por escopo e entrar/sair de bloco
+ * custa O(número de declarações do bloco).
+ *
+ * Data: Outubro de 2026
+ */
+
+#ifndef SEMANTIC_H
+#define SEMANTIC_H
+
+#include "ast.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+struct Simbolo
+{
+    enum Tipo
+    {
+        NENHUM,
+        VARIAVEL,
+        FUNCAO
+    } tipo = NENHUM;
+    int nivel = -1;  // profundidade do escopo da declaração (0 = global)
+    int aridade = 0; // FUNCAO
+    Token *decl = nullptr;
+};
+
+class TabelaSimbolos
+{
+public:
+    TabelaSimbolos(size_t capacidade = 64);
+
+    void entrar_escopo();
+    void sair_escopo();
+    int nivel() const { return marcas.size(); }
+
+    // Liga o nome ao símbolo no escopo atual; retorna false (sem alterar nada)
+    // se o nome já estava declarado neste mesmo escopo. O nome precisa continuar
+    // válido enquanto estiver na tabela (a tabela guarda apenas string_view).
+    bool declarar(string_view nome, const Simbolo &simbolo);
+
+    // Variáveis e funções vivem em espaços de nomes separados
+    const Simbolo *buscar(string_view nome, Simbolo::Tipo tipo) const;
+
+private:
+    struct Slot
+    {
+        uint64_t hash = 0;
+        string_view nome;
+        Simbolo::Tipo espaco = Simbolo::NENHUM; // NENHUM = slot vazio
+        Simbolo simbolo;                        // tipo NENHUM = nome sem ligação no momento
+    };
+
+    struct Desfazer
+    {
+        size_t slot;
+        Simbolo anterior;
+    };
+
+    vector<Slot> slots;
+    size_t ocupados = 0;
+    vector<Desfazer> log;
+    vector<size_t> marcas; // tamanho do log ao entrar em cada escopo
+
+    size_t procurar(string_view nome, Simbolo::Tipo espaco, uint64_t hash) const;
+    void crescer();
+};
+
+struct ErroSemantico
+{
+    string mensagem;
+    Token *token;
+};
+
+// Verifica declarações e chamadas em uma única passada: variáveis não
+// declaradas, redeclaradas no mesmo escopo, funções inexistentes, redefinidas
+// e chamadas com número de argumentos diferente do PARLIST.
+vector<ErroSemantico> analise_semantica(const Programa &programa);
+
+#endif // SEMANTIC_H
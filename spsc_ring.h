@@ -0,0 +1,117 @@
+/*
+ * Trabalho de Compiladores - Fila Circular SPSC
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo define uma fila circular sem locks para exatamente um produtor
+ * e um consumidor (SPSC), usada para passar tokens da thread do lexer para a
+ * do parser.
+ *
+ * Cada índice só é escrito por um lado: o produtor avança a cauda e o
+ * consumidor avança a cabeça. Os dois ficam em linhas de cache separadas,
+ * junto com a cópia local que cada lado guarda do índice do outro; assim o
+ * índice alheio só é relido (e a linha de cache só troca de dono) quando a
+ * cópia indica fila cheia ou vazia. As operações são em lote: um único
+ * store-release publica vários elementos.
+ *
+ * Data: Outubro de 2026
+ */
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+const size_t LINHA_CACHE = 64;
+
+// Espera do lado que encontrou a fila cheia ou vazia: gira um pouco antes de
+// ceder o processador
+inline void esperar_fila(unsigned &tentativas)
+{
+    if (++tentativas < 64)
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    }
+    else
+    {
+        this_thread::yield();
+    }
+}
+
+template <typename T>
+class SpscRing
+{
+public:
+    // A capacidade é arredondada para a próxima potência de 2
+    explicit SpscRing(size_t capacidade)
+    {
+        size_t n = 1;
+        while (n < capacidade)
+            n <<= 1;
+        buffer.resize(n);
+        mascara = n - 1;
+    }
+
+    size_t capacity() const { return buffer.size(); }
+
+    // Produtor: copia até n elementos e retorna quantos couberam
+    size_t push(const T *itens, size_t n)
+    {
+        size_t cauda_atual = cauda.load(memory_order_relaxed);
+        size_t livre = buffer.size() - (cauda_atual - cabeca_cache);
+        if (livre < n)
+        {
+            cabeca_cache = cabeca.load(memory_order_acquire);
+            livre = buffer.size() - (cauda_atual - cabeca_cache);
+        }
+        n = min(n, livre);
+        for (size_t i = 0; i < n; i++)
+            buffer[(cauda_atual + i) & mascara] = itens[i];
+        cauda.store(cauda_atual + n, memory_order_release);
+        return n;
+    }
+
+    // Consumidor: retira até n elementos e retorna quantos havia
+    size_t pop(T *itens, size_t n)
+    {
+        size_t cabeca_atual = cabeca.load(memory_order_relaxed);
+        size_t disponivel = cauda_cache - cabeca_atual;
+        if (disponivel < n)
+        {
+            cauda_cache = cauda.load(memory_order_acquire);
+            disponivel = cauda_cache - cabeca_atual;
+        }
+        n = min(n, disponivel);
+        for (size_t i = 0; i < n; i++)
+            itens[i] = buffer[(cabeca_atual + i) & mascara];
+        cabeca.store(cabeca_atual + n, memory_order_release);
+        return n;
+    }
+
+private:
+    // Lado do produtor
+    alignas(LINHA_CACHE) atomic<size_t> cauda{0};
+    size_t cabeca_cache = 0;
+
+    // Lado do consumidor
+    alignas(LINHA_CACHE) atomic<size_t> cabeca{0};
+    size_t cauda_cache = 0;
+
+    // Só leitura depois da construção
+    alignas(LINHA_CACHE) vector<T> buffer;
+    size_t mascara;
+};
+
+#endif // SPSC_RING_H
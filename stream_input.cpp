@@ -0,0 +1,186 @@
+/*
+ * Trabalho de Compiladores - Entrada em Fluxo
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo implementa o streambuf de janela fixa sobre um descritor.
+ *
+ * Data: Outubro de 2026
+ */
+
+#include "stream_input.h"
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+
+StreamInput::StreamInput(int fd, size_t tamanho_bloco) : fd(fd), bloco(tamanho_bloco), buffer(2 * tamanho_bloco)
+{
+    setg(buffer.data(), buffer.data(), buffer.data());
+}
+
+StreamInput::int_type StreamInput::underflow()
+{
+    if (gptr() < egptr())
+        return traits_type::to_int_type(*gptr());
+    if (fim)
+        return traits_type::eof();
+
+    // Descarta tudo antes da marca. Se depois da marca já foi consumido algum
+    // espaço, o Lexer está pulando espaços entre tokens e não volta mais antes
+    // do próximo tellg(), então a janela inteira pode sair.
+    size_t usados = egptr() - eback();
+    size_t descartar = marca > base ? min(marca - base, usados) : 0;
+    for (size_t i = descartar; i < usados; i++)
+    {
+        if (isspace(static_cast<unsigned char>(buffer[i])))
+        {
+            descartar = usados;
+            break;
+        }
+    }
+    return preencher(descartar) ? traits_type::to_int_type(*gptr()) : traits_type::eof();
+}
+
+bool StreamInput::next_block(size_t manter)
+{
+    if (fim)
+        return false;
+    return preencher(min(manter - base, size_t(egptr() - eback())));
+}
+
+void StreamInput::skip_rest()
+{
+    while (next_block(bytes_lidos()))
+        ;
+}
+
+// Tira os primeiros bytes da janela (contando as linhas) e lê um bloco depois
+// dos que ficaram, onde gptr passa a apontar; false no fim da entrada
+bool StreamInput::preencher(size_t descartar)
+{
+    size_t usados = egptr() - eback();
+    for (size_t i = 0; i < descartar; i++)
+    {
+        if (base + i == marca)
+        {
+            marca_salva = marca;
+            linhas_marca = linhas_antes;
+            inicio_linha_marca = inicio_linha;
+            quebra_marca = SIZE_MAX;
+        }
+        if (buffer[i] == '\n')
+        {
+            if (base + i >= marca_salva && quebra_marca == SIZE_MAX)
+                quebra_marca = base + i;
+            linhas_antes++;
+            inicio_linha = base + i + 1;
+        }
+    }
+    size_t mantidos = usados - descartar;
+    memmove(buffer.data(), buffer.data() + descartar, mantidos);
+    base += descartar;
+
+    // Só cresce quando a sequência a partir da marca não deixa espaço para um bloco
+    if (mantidos + bloco > buffer.size())
+        buffer.resize(2 * buffer.size());
+
+    size_t n = ler(buffer.data() + mantidos, bloco);
+    if (n == 0)
+    {
+        fim = true;
+        setg(buffer.data(), buffer.data() + mantidos, buffer.data() + mantidos);
+        return false;
+    }
+
+    setg(buffer.data(), buffer.data() + mantidos, buffer.data() + mantidos + n);
+    return true;
+}
+
+// Lê do descritor ou, se a entrada está comprimida, do descompressor; 0 no fim
+size_t StreamInput::ler(char *destino, size_t n)
+{
+    if (leitor)
+        return leitor->read(destino, n);
+
+    // Na primeira leitura junta ao menos 4 bytes para reconhecer o formato
+    size_t lidos = 0;
+    do
+    {
+        ssize_t r = read(fd, destino + lidos, n - lidos);
+        if (r < 0 && errno == EINTR)
+            continue;
+        if (r <= 0)
+            break;
+        lidos += r;
+    } while (!detectado && lidos < 4);
+
+    if (!detectado)
+    {
+        detectado = true;
+        formato = detect_compression(destino, lidos);
+        if (formato != SEM_COMPRESSAO)
+        {
+            // Os bytes lidos são o começo do arquivo comprimido
+            leitor.reset(new DecompressingReader(fd, formato, string(destino, lidos), bloco));
+            return leitor->read(destino, n);
+        }
+    }
+    return lidos;
+}
+
+StreamInput::pos_type StreamInput::seekoff(off_type off, ios_base::seekdir dir, ios_base::openmode modo)
+{
+    size_t atual = base + (gptr() - eback());
+    if (dir == ios_base::cur && off == 0)
+    {
+        // tellg(): o Lexer está no início de um token
+        marca = atual;
+        return pos_type(off_type(atual));
+    }
+    if (dir == ios_base::beg)
+        return seekpos(pos_type(off), modo);
+    if (dir == ios_base::cur)
+        return seekpos(pos_type(off_type(atual) + off), modo);
+    return pos_type(off_type(-1));
+}
+
+StreamInput::pos_type StreamInput::seekpos(pos_type pos, ios_base::openmode modo)
+{
+    size_t alvo = static_cast<size_t>(off_type(pos));
+    size_t fim_janela = base + (egptr() - eback());
+    if (!(modo & ios_base::in) || alvo < base || alvo > fim_janela)
+        return pos_type(off_type(-1));
+
+    setg(eback(), eback() + (alvo - base), egptr());
+    return pos;
+}
+
+string StreamInput::describe(size_t offset) const
+{
+    size_t linha = linhas_antes + 1;
+    size_t inicio = inicio_linha;
+
+    if (offset < inicio)
+    {
+        // Da marca descartada até a quebra seguinte a linha ainda é conhecida
+        if (offset >= marca_salva && offset <= quebra_marca)
+            return "linha " + to_string(linhas_marca + 1) + ", coluna " + to_string(offset - inicio_linha_marca + 1);
+        return "offset " + to_string(offset); // linha já saiu da janela
+    }
+
+    size_t fim_janela = base + (egptr() - eback());
+    for (size_t i = base; i < offset && i < fim_janela; i++)
+    {
+        if (buffer[i - base] == '\n')
+        {
+            linha++;
+            inicio = i + 1;
+        }
+    }
+    return "linha " + to_string(linha) + ", coluna " + to_string(offset - inicio + 1);
+}
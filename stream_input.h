@@ -0,0 +1,104 @@
+/*
+ * Trabalho de Compiladores - Entrada em Fluxo
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo define um streambuf de tamanho fixo que lê de um descritor
+ * (stdin, pipe) em blocos, para o Lexer poder consumir entradas que não cabem
+ * ou não estão inteiras em memória.
+ *
+ * O buffer guarda uma janela da entrada: ao recarregar, os bytes já consumidos
+ * são descartados, exceto os que vêm depois da última marca. A marca é a
+ * posição consultada por tellg(), que o Lexer chama no início de cada token;
+ * assim um token que atravessa o fim de um bloco continua inteiro na janela e
+ * o seekg() do retrocesso sempre cai dentro dela. O buffer só cresce se uma
+ * única sequência sem espaços for maior que um bloco; fora isso a memória é
+ * constante, qualquer que seja o tamanho da entrada.
+ *
+ * As quebras de linha dos bytes descartados são contadas no descarte, então
+ * os diagnósticos de tokens ainda na janela saem com linha/coluna corretas.
+ * A linha da última marca descartada também fica guardada, porque o $ é
+ * posto no fim do último token, que sai da janela com os espaços finais.
+ *
+ * A janela também é exposta como BlockSource (line_index.h), para o
+ * Recognizer do --check ler os bytes direto dela, sem o istream; aí quem
+ * decide o que descartar é o next_block, e não a marca.
+ *
+ * Se os primeiros bytes são de um arquivo gzip ou zstd, o resto passa por um
+ * DecompressingReader (compressed_input.h): a janela recebe o texto já
+ * descomprimido, que a thread auxiliar vai produzindo enquanto o Lexer
+ * consome, e offsets, linhas e colunas são os do texto descomprimido.
+ *
+ * Data: Outubro de 2026
+ */
+
+#ifndef STREAM_INPUT_H
+#define STREAM_INPUT_H
+
+#include "compressed_input.h"
+#include "line_index.h"
+#include <cstdint>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class StreamInput : public streambuf, public BlockSource
+{
+public:
+    StreamInput(int fd, size_t tamanho_bloco = 64 * 1024);
+
+    string describe(size_t offset) const override;
+
+    // Leitura direta da janela (Recognizer); não misturar com o istream
+    const char *window_begin() const override { return eback(); }
+    const char *window_end() const override { return egptr(); }
+    size_t window_offset() const override { return base; }
+    bool next_block(size_t manter) override;
+
+    size_t capacidade() const { return buffer.size(); }
+    size_t bytes_lidos() const { return base + (egptr() - eback()); }
+
+    // Formato reconhecido no início da entrada (depois da primeira leitura)
+    Compressao compressao() const { return formato; }
+    // Vazio se a entrada não estava comprimida ou foi descomprimida até o fim
+    string decompression_error() const { return leitor ? leitor->error() : string(); }
+    // Lê e descarta o resto da entrada. Depois de um erro de sintaxe no meio,
+    // só assim decompression_error() diz se o texto foi cortado ali
+    void skip_rest();
+
+protected:
+    int_type underflow() override;
+    pos_type seekoff(off_type off, ios_base::seekdir dir, ios_base::openmode modo) override;
+    pos_type seekpos(pos_type pos, ios_base::openmode modo) override;
+
+private:
+    int fd;
+    size_t bloco;
+    vector<char> buffer;
+    size_t base = 0;         // offset absoluto de buffer[0]
+    size_t marca = 0;        // offset absoluto que precisa continuar na janela
+    size_t linhas_antes = 0; // quantidade de '\n' em [0, base)
+    size_t inicio_linha = 0; // offset absoluto do início da linha que contém base
+    // Linha da última marca descartada: o fim do último token (onde o $ fica)
+    // pode sair da janela junto com os espaços que vêm depois dele
+    size_t marca_salva = SIZE_MAX;
+    size_t linhas_marca = 0;          // quantidade de '\n' em [0, marca_salva)
+    size_t inicio_linha_marca = 0;    // início da linha que contém marca_salva
+    size_t quebra_marca = SIZE_MAX;   // primeiro '\n' descartado depois dela
+    bool fim = false;
+    bool detectado = false;
+    Compressao formato = SEM_COMPRESSAO;
+    unique_ptr<DecompressingReader> leitor;
+
+    size_t ler(char *destino, size_t n);
+    bool preencher(size_t descartar);
+};
+
+#endif // STREAM_INPUT_H
@@ -0,0 +1,255 @@
+/*
+ * Trabalho de Compiladores - Índice Estrutural
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo implementa a classificação dos blocos de 64 bytes, a
+ * conversão das máscaras em posições e as duas versões do estágio 2: a
+ * sem desvios, para código balanceado, e a com pilha, que aponta os erros.
+ *
+ * Data: Outubro de 2026
+ */
+
+#include "structural.h"
+#include <algorithm>
+#include <cstring>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Um bit por byte do bloco: bit i ligado se o byte i é estrutural
+static inline uint64_t classificar_bloco(const char *p)
+{
+#if defined(__AVX2__)
+    uint64_t m = 0;
+    for (int meio = 0; meio < 2; meio++)
+    {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + 32 * meio));
+        __m256i e = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('{')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('}')));
+        e = _mm256_or_si256(e, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('(')));
+        e = _mm256_or_si256(e, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(')')));
+        e = _mm256_or_si256(e, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(';')));
+        m |= (uint64_t)(uint32_t)_mm256_movemask_epi8(e) << (32 * meio);
+    }
+    return m;
+#elif defined(__SSE2__)
+    uint64_t m = 0;
+    for (int quarto = 0; quarto < 4; quarto++)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 16 * quarto));
+        __m128i e = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('{')), _mm_cmpeq_epi8(v, _mm_set1_epi8('}')));
+        e = _mm_or_si128(e, _mm_cmpeq_epi8(v, _mm_set1_epi8('(')));
+        e = _mm_or_si128(e, _mm_cmpeq_epi8(v, _mm_set1_epi8(')')));
+        e = _mm_or_si128(e, _mm_cmpeq_epi8(v, _mm_set1_epi8(';')));
+        m |= (uint64_t)(uint16_t)_mm_movemask_epi8(e) << (16 * quarto);
+    }
+    return m;
+#else
+    uint64_t m = 0;
+    for (int i = 0; i < 64; i++)
+    {
+        char c = p[i];
+        m |= (uint64_t)(c == '{' || c == '}' || c == '(' || c == ')' || c == ';') << i;
+    }
+    return m;
+#endif
+}
+
+// Estágio 1: posições de todos os caracteres estruturais e os próprios
+// caracteres, lidos enquanto o bloco ainda está no cache (o estágio 2 não
+// precisa voltar ao código)
+static void estagio1(string_view fonte, vector<uint32_t> &posicoes, vector<char> &caracteres)
+{
+    size_t n = fonte.size();
+    posicoes.resize(n / 8 + 64);
+    caracteres.resize(posicoes.size());
+    size_t usados = 0;
+    auto converter = [&](uint64_t m, uint32_t base, const char *bloco)
+    {
+        // Cabe o pior caso (64 posições) antes de escrever sem checar
+        if (usados + 64 > posicoes.size())
+        {
+            posicoes.resize(posicoes.size() * 2);
+            caracteres.resize(posicoes.size());
+        }
+        uint32_t *saida = posicoes.data() + usados;
+        char *saida_c = caracteres.data() + usados;
+        usados += __builtin_popcountll(m);
+        for (; m != 0; m &= m - 1)
+        {
+            int i = __builtin_ctzll(m);
+            *saida++ = base + i;
+            *saida_c++ = bloco[i];
+        }
+    };
+
+    size_t i = 0;
+    for (; i + 64 <= n; i += 64)
+        converter(classificar_bloco(fonte.data() + i), i, fonte.data() + i);
+    if (i < n)
+    {
+        // Último bloco completado com espaços
+        char resto[64];
+        memset(resto, ' ', sizeof(resto));
+        memcpy(resto, fonte.data() + i, n - i);
+        converter(classificar_bloco(resto), i, resto);
+    }
+    posicoes.resize(usados);
+    caracteres.resize(usados);
+}
+
+// Classe de cada caractere estrutural: bit 0 abre, bit 1 fecha, e o tipo
+// nos bits 2 e 3 (1 para chaves, 2 para parênteses; 0 para ';')
+struct TabelaClasse
+{
+    uint8_t v[256] = {};
+    constexpr TabelaClasse()
+    {
+        v[(uint8_t)'{'] = 1 | 4;
+        v[(uint8_t)'}'] = 2 | 4;
+        v[(uint8_t)'('] = 1 | 8;
+        v[(uint8_t)')'] = 2 | 8;
+    }
+};
+static constexpr TabelaClasse CLASSE;
+
+// Caminho rápido, para código balanceado. A profundidade de cada caractere
+// é a soma de prefixos dos +1 (abertura) e -1 (fechamento), que não depende
+// do conteúdo da pilha; o fechamento na profundidade d casa com a última
+// abertura guardada em d. Assim o laço não tem desvios, e a única dependência
+// entre iterações é a própria soma. Retorna false se algum fechamento não
+// bate com o tipo da abertura, se a profundidade fica negativa ou se sobra
+// algo aberto; nesses casos o resultado é descartado.
+static bool casar_balanceado(const vector<char> &caracteres, StructuralIndex &indice)
+{
+    const uint32_t *__restrict pos = indice.posicoes.data();
+    const uint32_t n = indice.posicoes.size();
+    const char *__restrict texto = caracteres.data();
+    uint32_t *__restrict par = indice.par.data();
+    // Posição 0: sentinela com tipo 0, que não casa com nenhum fechamento.
+    // Crescem com a profundidade, que costuma ser pequena
+    vector<uint32_t> ultima_v(64, 0);
+    vector<uint8_t> tipos_v(64, 0);
+    uint32_t *ultima = ultima_v.data();
+    uint8_t *tipos = tipos_v.data();
+    vector<pair<uint32_t, uint32_t>> funcoes;
+    size_t d = 0;
+    uint32_t profundidade_maxima = 0, inicio_funcao = 0;
+    uint32_t erro = 0;
+    for (uint32_t k = 0; k < n; k++)
+    {
+        if (d + 2 > ultima_v.size())
+        {
+            ultima_v.resize(ultima_v.size() * 2);
+            tipos_v.resize(tipos_v.size() * 2);
+            ultima = ultima_v.data();
+            tipos = tipos_v.data();
+        }
+        uint8_t classe = CLASSE.v[(uint8_t)texto[k]];
+        uint8_t tipo = classe >> 2;
+        uint32_t abre = classe & 1;
+        uint32_t fecha = (classe >> 1) & 1;
+        uint32_t mascara = -fecha; // tudo 1 se fecha
+        // Escrita especulativa acima do topo; só vale se for abertura
+        ultima[d + 1] = k;
+        tipos[d + 1] = tipo;
+        uint32_t aberta = ultima[d];
+        erro |= fecha & (tipos[d] != tipo);
+        // Fechamento: par[k] = aberta e par[aberta] = k; senão par[k] = SEM_PAR
+        par[k] = aberta | ~mascara;
+        par[k ^ ((k ^ aberta) & mascara)] = k | ~mascara;
+        d = d + abre - (fecha & (d > 0));
+        profundidade_maxima = max<uint32_t>(profundidade_maxima, d);
+        if (fecha & (d == 0) & (tipo == 1))
+        {
+            funcoes.push_back({inicio_funcao, pos[k] + 1});
+            inicio_funcao = pos[k] + 1;
+        }
+    }
+    indice.funcoes = std::move(funcoes);
+    indice.profundidade_maxima = profundidade_maxima;
+    return erro == 0 && d == 0;
+}
+
+// Caminho exato, com pilha, que também aponta os erros. Um '}' fecha os '('
+// que ficaram abertos dentro do bloco (cada um vira um erro); um ')' nunca
+// fecha um '{', porque parênteses não contêm blocos nesta gramática
+static void casar_com_erros(string_view fonte, StructuralIndex &indice)
+{
+    const vector<uint32_t> &pos = indice.posicoes;
+    vector<uint32_t> pilha;
+    uint32_t inicio_funcao = 0;
+    for (uint32_t k = 0; k < pos.size(); k++)
+    {
+        char c = fonte[pos[k]];
+        if (c == '{' || c == '(')
+        {
+            pilha.push_back(k);
+            if (pilha.size() > indice.profundidade_maxima)
+                indice.profundidade_maxima = pilha.size();
+            continue;
+        }
+        if (c == ';')
+            continue;
+
+        char abre = c == '}' ? '{' : '(';
+        size_t topo = pilha.size();
+        if (c == '}')
+            while (topo > 0 && fonte[pos[pilha[topo - 1]]] == '(')
+                topo--;
+        if (topo == 0 || fonte[pos[pilha[topo - 1]]] != abre)
+        {
+            indice.erros.push_back({pos[k], false});
+            continue;
+        }
+        uint32_t aberta = pilha[topo - 1];
+        for (size_t j = topo; j < pilha.size(); j++)
+            indice.erros.push_back({pos[pilha[j]], true});
+        pilha.resize(topo - 1);
+        indice.par[aberta] = k;
+        indice.par[k] = aberta;
+        if (c == '}' && pilha.empty())
+        {
+            indice.funcoes.push_back({inicio_funcao, pos[k] + 1});
+            inicio_funcao = pos[k] + 1;
+        }
+    }
+    for (uint32_t k : pilha)
+        indice.erros.push_back({pos[k], true});
+    sort(indice.erros.begin(), indice.erros.end(),
+         [](const StructuralError &a, const StructuralError &b) { return a.offset < b.offset; });
+}
+
+bool build_structural_index(string_view fonte, StructuralIndex &indice, string &erro)
+{
+    if (fonte.size() >= UINT32_MAX)
+    {
+        erro = "código maior que 4 GB";
+        return false;
+    }
+    indice = StructuralIndex();
+    vector<char> caracteres;
+    estagio1(fonte, indice.posicoes, caracteres);
+
+    indice.par.assign(indice.posicoes.size(), SEM_PAR);
+    if (casar_balanceado(caracteres, indice))
+        return true;
+    indice.par.assign(indice.posicoes.size(), SEM_PAR);
+    indice.funcoes.clear();
+    indice.profundidade_maxima = 0;
+    casar_com_erros(fonte, indice);
+    return true;
+}
+
+string describe_structural_error(const StructuralError &e, string_view fonte, const PositionResolver &linhas)
+{
+    char c = fonte[e.offset];
+    string texto = "Erro estrutural (" + linhas.describe(e.offset) + "): '" + c + "' ";
+    if (e.aberto)
+        return texto + "não é fechado.";
+    return texto + "não tem '" + (c == '}' ? '{' : '(') + "' correspondente.";
+}
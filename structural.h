@@ -0,0 +1,62 @@
+/*
+ * Trabalho de Compiladores - Índice Estrutural
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo define uma passada anterior ao lexer que encontra a estrutura
+ * do programa só pelos caracteres { } ( ) e ;. A linguagem não tem strings
+ * nem comentários, então todo byte desses é estrutural. O estágio 1 lê o
+ * código em blocos de 64 bytes, compara cada bloco com os cinco caracteres
+ * usando SIMD (AVX2, SSE2 ou escalar) e transforma as máscaras de bits na
+ * lista de posições. O estágio 2 percorre só essa lista, bem menor que o
+ * código: liga cada abertura ao seu fechamento, mede a profundidade e
+ * separa os blocos de nível 0 (as funções, num programa FLIST). Se algo não
+ * fecha, uma segunda passada com pilha aponta todas as chaves e parênteses
+ * sem par de uma vez.
+ *
+ * Data: Outubro de 2026
+ */
+
+#ifndef STRUCTURAL_H
+#define STRUCTURAL_H
+
+#include "line_index.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+static const uint32_t SEM_PAR = UINT32_MAX;
+
+struct StructuralError
+{
+    uint32_t offset; // caractere sem par
+    bool aberto;     // true: abertura nunca fechada; false: fechamento sem abertura
+};
+
+struct StructuralIndex
+{
+    vector<uint32_t> posicoes; // offset de cada caractere estrutural, em ordem
+    vector<uint32_t> par;      // para cada posição, o índice do par em posicoes (SEM_PAR para ';' e sem par)
+    // [início, fim) em bytes de cada bloco { } de nível 0, contando o que vem
+    // antes dele desde o fim do anterior (num programa FLIST, "def F(...) {...}")
+    vector<pair<uint32_t, uint32_t>> funcoes;
+    vector<StructuralError> erros; // em ordem de offset
+    uint32_t profundidade_maxima = 0;
+
+    bool balanced() const { return erros.empty(); }
+};
+
+// Monta o índice; false (com erro) só se o código tem 4 GB ou mais
+bool build_structural_index(string_view fonte, StructuralIndex &indice, string &erro);
+
+// "Erro estrutural (linha L, coluna C): '{' não é fechado."
+string describe_structural_error(const StructuralError &e, string_view fonte, const PositionResolver &linhas);
+
+#endif // STRUCTURAL_H
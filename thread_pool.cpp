@@ -0,0 +1,117 @@
+/*
+ * Trabalho de Compiladores - Pool de Threads
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo implementa o ThreadPool.
+ *
+ * Data: Outubro de 2026
+ */
+
+#include "thread_pool.h"
+
+ThreadPool::ThreadPool(size_t threads)
+{
+    if (threads == 0)
+        threads = max(1u, thread::hardware_concurrency());
+    for (size_t i = 1; i < threads; i++)
+        trabalhadores.emplace_back(&ThreadPool::laco, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        lock_guard<mutex> guarda(trava);
+        parar = true;
+    }
+    tem_trabalho.notify_all();
+    for (auto &t : trabalhadores)
+        t.join();
+}
+
+// Pega índices até acabarem
+void ThreadPool::trabalhar(const function<void(size_t)> &tarefa, size_t total)
+{
+    size_t i;
+    while ((i = proximo.fetch_add(1, memory_order_relaxed)) < total)
+    {
+        try
+        {
+            tarefa(i);
+        }
+        catch (...)
+        {
+            lock_guard<mutex> guarda(trava);
+            if (!erro)
+                erro = current_exception();
+        }
+    }
+}
+
+void ThreadPool::laco()
+{
+    uint64_t vista = 0;
+    while (true)
+    {
+        const function<void(size_t)> *atual;
+        size_t n;
+        {
+            unique_lock<mutex> guarda(trava);
+            tem_trabalho.wait(guarda, [&] { return parar || geracao != vista; });
+            if (parar)
+                return;
+            vista = geracao;
+            atual = tarefa;
+            n = total;
+            ativos++;
+        }
+
+        trabalhar(*atual, n);
+
+        {
+            lock_guard<mutex> guarda(trava);
+            if (--ativos == 0)
+                terminou.notify_all();
+        }
+    }
+}
+
+void ThreadPool::parallel_for(size_t n, const function<void(size_t)> &tarefa)
+{
+    if (n == 0)
+        return;
+    if (trabalhadores.empty() || n == 1)
+    {
+        for (size_t i = 0; i < n; i++)
+            tarefa(i);
+        return;
+    }
+
+    {
+        lock_guard<mutex> guarda(trava);
+        this->tarefa = &tarefa;
+        total = n;
+        proximo.store(0, memory_order_relaxed);
+        erro = nullptr;
+        geracao++;
+    }
+    tem_trabalho.notify_all();
+
+    trabalhar(tarefa, n);
+
+    // Espera quem ainda está no meio de uma tarefa. Um trabalhador que acordar
+    // depois disso só encontra o contador esgotado.
+    exception_ptr falha;
+    {
+        unique_lock<mutex> guarda(trava);
+        terminou.wait(guarda, [&] { return ativos == 0; });
+        falha = erro;
+        erro = nullptr;
+    }
+    if (falha)
+        rethrow_exception(falha);
+}
@@ -0,0 +1,66 @@
+/*
+ * Trabalho de Compiladores - Pool de Threads
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo define um pool fixo de threads com uma única operação,
+ * parallel_for: executa tarefa(i) para cada i em [0, n). Os índices são
+ * distribuídos sob demanda por um contador atômico, então tarefas de
+ * tamanhos diferentes (funções grandes e pequenas) se equilibram sozinhas.
+ * A thread que chama também trabalha e só retorna quando todos os índices
+ * terminaram. A primeira exceção lançada por uma tarefa é relançada na
+ * chamadora (as tarefas seguintes ainda rodam).
+ *
+ * Data: Outubro de 2026
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+class ThreadPool
+{
+public:
+    // threads = total de threads trabalhando, contando a chamadora
+    // (0 = hardware_concurrency)
+    explicit ThreadPool(size_t threads = 0);
+    ~ThreadPool();
+
+    size_t size() const { return trabalhadores.size() + 1; }
+
+    void parallel_for(size_t n, const function<void(size_t)> &tarefa);
+
+private:
+    vector<thread> trabalhadores;
+    mutex trava;
+    condition_variable tem_trabalho;
+    condition_variable terminou;
+
+    // Trabalho atual; geracao muda a cada parallel_for
+    const function<void(size_t)> *tarefa = nullptr;
+    size_t total = 0;
+    atomic<size_t> proximo{0};
+    size_t ativos = 0; // trabalhadores ainda dentro do trabalho atual
+    uint64_t geracao = 0;
+    bool parar = false;
+    exception_ptr erro;
+
+    void trabalhar(const function<void(size_t)> &tarefa, size_t total);
+    void laco();
+};
+
+#endif // THREAD_POOL_H
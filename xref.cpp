@@ -0,0 +1,586 @@
+/*
+ * Trabalho de Compiladores - Índice de Referências Cruzadas
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo implementa a coleta das ocorrências na AST, a construção
+ * (paralela e incremental) do índice em disco e a leitura via mmap.
+ *
+ * Data: Outubro de 2026
+ */
+
+#include "xref.h"
+#include "ast.h"
+#include "cache.h"
+#include "compressed_input.h"
+#include "file_loader.h"
+#include "line_index.h"
+#include "parser.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+
+static const char XREF_MAGIC[8] = {'X', 'R', 'E', 'F', 'I', 'D', 'X', '1'};
+
+struct XrefHeader
+{
+    char magic[8];
+    uint32_t num_arquivos;
+    uint32_t reservado;
+    uint64_t num_simbolos;
+    uint64_t num_sites;
+    uint64_t tam_nomes;
+    uint64_t gramatica; // grammar_fingerprint(): muda o papel das ocorrências
+};
+
+static const char *NOMES_PAPEIS[XREF_NUM_ROLES] = {"def", "call", "param", "decl", "assign", "use"};
+
+const char *xref_role_name(int papel)
+{
+    return papel >= 0 && papel < XREF_NUM_ROLES ? NOMES_PAPEIS[papel] : "?";
+}
+
+int xref_role_from_name(const string &nome)
+{
+    for (int p = 0; p < XREF_NUM_ROLES; p++)
+        if (nome == NOMES_PAPEIS[p])
+            return p;
+    return -1;
+}
+
+// ==========================
+// Coleta na AST
+// ==========================
+
+struct Ocorrencia
+{
+    string nome;
+    size_t offset;
+    int papel;
+};
+
+static void coletar(const Ident &id, int papel, vector<Ocorrencia> &saida)
+{
+    if (id.token != nullptr && !id.nome.empty())
+        saida.push_back({id.nome, id.token->offset, papel});
+}
+
+static void coletar_expr(const Expr *e, vector<Ocorrencia> &saida)
+{
+    if (e == nullptr)
+        return;
+    if (e->tipo == EXPR_VAR)
+        coletar(e->var, XREF_USE, saida);
+    coletar_expr(e->esq, saida);
+    coletar_expr(e->dir, saida);
+}
+
+static void coletar_chamada(const Chamada *c, vector<Ocorrencia> &saida)
+{
+    coletar(c->funcao, XREF_CALL, saida);
+    for (const Ident &arg : c->args)
+        coletar(arg, XREF_USE, saida);
+}
+
+static void coletar_stmt(const Stmt *s, vector<Ocorrencia> &saida)
+{
+    if (s == nullptr)
+        return;
+    switch (s->tipo)
+    {
+    case STMT_DECL:
+        for (const Ident &nome : s->nomes)
+            coletar(nome, XREF_DECL, saida);
+        break;
+    case STMT_ATRIB:
+        // Lado direito é avaliado antes, mas a ordem final é por offset
+        coletar(s->alvo, XREF_ASSIGN, saida);
+        if (s->chamada != nullptr)
+            coletar_chamada(s->chamada, saida);
+        coletar_expr(s->expr, saida);
+        break;
+    case STMT_CHAMADA:
+        coletar_chamada(s->chamada, saida);
+        break;
+    case STMT_PRINT:
+        coletar_expr(s->expr, saida);
+        break;
+    case STMT_RETURN:
+        coletar(s->alvo, XREF_USE, saida);
+        break;
+    case STMT_IF:
+        coletar_expr(s->expr, saida);
+        coletar_stmt(s->entao, saida);
+        coletar_stmt(s->senao, saida);
+        break;
+    case STMT_BLOCO:
+        for (const Stmt *filho : s->corpo)
+            coletar_stmt(filho, saida);
+        break;
+    case STMT_VAZIO:
+        break;
+    }
+}
+
+// ==========================
+// Construção
+// ==========================
+
+// Resultado de um arquivo da lista nova
+struct ArquivoIndexado
+{
+    string nome;
+    uint64_t tamanho = 0;
+    int64_t mtime = 0;
+    uint64_t hash = 0;
+    bool com_erro = false;
+    int antigo = -1;            // posição no índice anterior
+    bool reaproveitado = false; // ocorrências vêm do índice anterior
+    string diagnostico;
+    vector<Ocorrencia> ocorrencias;
+    vector<Posicao> posicoes; // paralelo a ocorrencias
+};
+
+static bool ler_arquivo(const string &caminho, string &texto)
+{
+    ifstream in(caminho, ios::binary);
+    if (!in)
+        return false;
+    stringstream ss;
+    ss << in.rdbuf();
+    texto = ss.str();
+    return true;
+}
+
+static void analisar(ArquivoIndexado &a, const string &fonte, const string &backend, const DfaTables *tabelas)
+{
+    stringstream ss(fonte);
+    unique_ptr<LexerBackend> lexer(make_lexer(backend, ss, tabelas));
+    if (lexer == nullptr)
+    {
+        a.com_erro = true;
+        a.diagnostico = "Backend léxico desconhecido ou indisponível: " + backend;
+        return;
+    }
+
+    vector<Token *> tokens;
+    ParseNode *arvore = nullptr;
+    LineIndex linhas(fonte);
+    try
+    {
+        tokens = analise_lexica(*lexer);
+        VectorLexer lexer_tokens(tokens);
+        if (parse_tokens(lexer_tokens, &arvore, false, a.diagnostico, &linhas))
+        {
+            Programa *programa = build_ast(arvore);
+            for (const Funcao *f : programa->funcoes)
+            {
+                coletar(f->nome, XREF_DEF, a.ocorrencias);
+                for (const Ident &p : f->params)
+                    coletar(p, XREF_PARAM, a.ocorrencias);
+                for (const Stmt *s : f->corpo)
+                    coletar_stmt(s, a.ocorrencias);
+            }
+            free_ast(programa);
+
+            stable_sort(a.ocorrencias.begin(), a.ocorrencias.end(),
+                        [](const Ocorrencia &x, const Ocorrencia &y) { return x.offset < y.offset; });
+            for (const Ocorrencia &o : a.ocorrencias)
+                a.posicoes.push_back(linhas.locate(o.offset));
+        }
+        else
+        {
+            a.com_erro = true;
+        }
+    }
+    catch (const LexicalError &e)
+    {
+        // analise_lexica já liberou os tokens lidos
+        a.com_erro = true;
+        a.diagnostico = e.describe(&linhas);
+    }
+    catch (const exception &e)
+    {
+        a.com_erro = true;
+        a.diagnostico = string("Erro interno: ") + e.what();
+        a.ocorrencias.clear();
+        a.posicoes.clear();
+    }
+    free_parse_tree(arvore);
+    for (Token *tok : tokens)
+        delete tok;
+}
+
+bool build_xref_index(const string &caminho, const vector<string> &entradas, ThreadPool &pool, const string &backend,
+                      const DfaTables *tabelas, XrefStats &stats, vector<string> &erros, string &erro,
+                      const vector<string> &padroes)
+{
+    auto inicio = chrono::steady_clock::now();
+    stats = XrefStats();
+
+    vector<string> nomes_arquivos;
+    expand_paths(entradas, nomes_arquivos, padroes);
+    vector<ArquivoIndexado> arquivos;
+    unordered_map<string, size_t> vistos;
+    for (const string &nome : nomes_arquivos)
+        if (vistos.emplace(nome, arquivos.size()).second)
+        {
+            arquivos.emplace_back();
+            arquivos.back().nome = nome;
+        }
+
+    // O índice anterior, se existir e for da mesma gramática
+    XrefIndex antigo;
+    string erro_antigo;
+    bool tem_antigo = antigo.open(caminho, erro_antigo);
+    if (tem_antigo)
+        for (size_t i = 0; i < antigo.num_files(); i++)
+        {
+            auto it = vistos.find(string(antigo.file_name(i)));
+            if (it != vistos.end())
+                arquivos[it->second].antigo = i;
+        }
+
+    vector<string> falhas(arquivos.size());
+    pool.parallel_for(arquivos.size(), [&](size_t i)
+                      {
+                          ArquivoIndexado &a = arquivos[i];
+                          struct stat st;
+                          if (stat(a.nome.c_str(), &st) != 0 || !S_ISREG(st.st_mode))
+                          {
+                              falhas[i] = a.nome + ": não foi possível abrir o arquivo";
+                              return;
+                          }
+                          a.tamanho = st.st_size;
+                          a.mtime = (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+                          const XrefFile *velho = a.antigo != -1 ? &antigo.file(a.antigo) : nullptr;
+                          if (velho != nullptr && velho->tamanho == a.tamanho && velho->mtime == a.mtime)
+                          {
+                              a.hash = velho->hash;
+                              a.com_erro = velho->com_erro;
+                              a.reaproveitado = true;
+                              return;
+                          }
+
+                          string fonte;
+                          if (!ler_arquivo(a.nome, fonte))
+                          {
+                              falhas[i] = a.nome + ": não foi possível abrir o arquivo";
+                              return;
+                          }
+                          if (fonte.size() > UINT32_MAX)
+                          {
+                              falhas[i] = a.nome + ": arquivo maior que 4 GB";
+                              return;
+                          }
+                          a.tamanho = fonte.size();
+                          a.hash = xxhash64(fonte.data(), fonte.size(), 0);
+                          // Só o mtime mudou (ex.: touch ou checkout)
+                          if (velho != nullptr && velho->tamanho == a.tamanho && velho->hash == a.hash)
+                          {
+                              a.com_erro = velho->com_erro;
+                              a.reaproveitado = true;
+                              return;
+                          }
+                          // Tamanho e hash são os do arquivo em disco; gzip e zstd
+                          // são analisados descomprimidos
+                          Compressao formato = detect_compression(fonte.data(), fonte.size());
+                          if (formato != SEM_COMPRESSAO)
+                          {
+                              string texto, erro_descompressao;
+                              if (!decompress_buffer(fonte, formato, texto, erro_descompressao))
+                              {
+                                  falhas[i] = a.nome + ": " + erro_descompressao;
+                                  return;
+                              }
+                              if (texto.size() > UINT32_MAX)
+                              {
+                                  falhas[i] = a.nome + ": arquivo maior que 4 GB";
+                                  return;
+                              }
+                              fonte = move(texto);
+                          }
+                          analisar(a, fonte, backend, tabelas);
+                      });
+
+    // Arquivos que não puderam ser lidos ficam fora do índice
+    vector<ArquivoIndexado> lidos;
+    for (size_t i = 0; i < arquivos.size(); i++)
+    {
+        if (!falhas[i].empty())
+        {
+            erros.push_back(falhas[i]);
+            continue;
+        }
+        if (arquivos[i].com_erro && !arquivos[i].reaproveitado)
+            erros.push_back(arquivos[i].nome + ": " + arquivos[i].diagnostico);
+        lidos.push_back(std::move(arquivos[i]));
+    }
+    arquivos = std::move(lidos);
+
+    // Símbolos: cada nome vira um id; depois os ids são ordenados pelo nome
+    unordered_map<string, uint32_t> ids;
+    vector<string> nomes_simbolos;
+    auto simbolo = [&](string_view nome)
+    {
+        auto it = ids.find(string(nome));
+        if (it != ids.end())
+            return it->second;
+        uint32_t id = nomes_simbolos.size();
+        nomes_simbolos.emplace_back(nome);
+        ids.emplace(nomes_simbolos.back(), id);
+        return id;
+    };
+
+    struct Entrada
+    {
+        uint32_t simbolo;
+        XrefSite site;
+    };
+    vector<Entrada> entradas_sites;
+    vector<int> novo_id(tem_antigo ? antigo.num_files() : 0, -1);
+    for (size_t i = 0; i < arquivos.size(); i++)
+    {
+        const ArquivoIndexado &a = arquivos[i];
+        if (a.reaproveitado)
+        {
+            novo_id[a.antigo] = i;
+            stats.reaproveitados++;
+            continue;
+        }
+        stats.reindexados++;
+        for (size_t k = 0; k < a.ocorrencias.size(); k++)
+        {
+            const Ocorrencia &o = a.ocorrencias[k];
+            XrefSite s = {(uint32_t)i, (uint32_t)o.offset, (uint32_t)a.posicoes[k].linha, (uint32_t)a.posicoes[k].coluna,
+                          (uint32_t)o.papel};
+            entradas_sites.push_back({simbolo(o.nome), s});
+        }
+    }
+    if (tem_antigo && stats.reaproveitados > 0)
+        for (size_t k = 0; k < antigo.num_symbols(); k++)
+        {
+            auto trecho = antigo.symbol_sites(k);
+            uint32_t id = UINT32_MAX;
+            for (const XrefSite *s = trecho.first; s != trecho.second; s++)
+            {
+                if (s->arquivo >= novo_id.size() || novo_id[s->arquivo] == -1)
+                    continue;
+                if (id == UINT32_MAX)
+                    id = simbolo(antigo.symbol_name(k));
+                XrefSite copia = *s;
+                copia.arquivo = novo_id[s->arquivo];
+                entradas_sites.push_back({id, copia});
+            }
+        }
+    for (const auto &a : arquivos)
+        stats.com_erro += a.com_erro;
+
+    vector<uint32_t> ordem(nomes_simbolos.size());
+    for (size_t i = 0; i < ordem.size(); i++)
+        ordem[i] = i;
+    sort(ordem.begin(), ordem.end(), [&](uint32_t a, uint32_t b) { return nomes_simbolos[a] < nomes_simbolos[b]; });
+    vector<uint32_t> posicao(ordem.size());
+    for (size_t i = 0; i < ordem.size(); i++)
+        posicao[ordem[i]] = i;
+    sort(entradas_sites.begin(), entradas_sites.end(), [&](const Entrada &a, const Entrada &b)
+         {
+             if (a.simbolo != b.simbolo)
+                 return posicao[a.simbolo] < posicao[b.simbolo];
+             if (a.site.arquivo != b.site.arquivo)
+                 return a.site.arquivo < b.site.arquivo;
+             return a.site.offset < b.site.offset;
+         });
+
+    // Monta o arquivo inteiro em memória
+    string nomes;
+    vector<XrefFile> tabela_arquivos;
+    for (const auto &a : arquivos)
+    {
+        XrefFile f = {};
+        f.nome = nomes.size();
+        f.tam_nome = a.nome.size();
+        f.tamanho = a.tamanho;
+        f.mtime = a.mtime;
+        f.hash = a.hash;
+        f.com_erro = a.com_erro;
+        nomes += a.nome;
+        tabela_arquivos.push_back(f);
+    }
+    vector<XrefSymbol> tabela_simbolos(ordem.size());
+    for (size_t i = 0; i < ordem.size(); i++)
+    {
+        tabela_simbolos[i].nome = nomes.size();
+        tabela_simbolos[i].tam_nome = nomes_simbolos[ordem[i]].size();
+        nomes += nomes_simbolos[ordem[i]];
+    }
+    vector<XrefSite> tabela_sites(entradas_sites.size());
+    for (size_t k = 0; k < entradas_sites.size(); k++)
+    {
+        tabela_sites[k] = entradas_sites[k].site;
+        XrefSymbol &s = tabela_simbolos[posicao[entradas_sites[k].simbolo]];
+        if (s.num_sites++ == 0)
+            s.primeiro = k;
+    }
+
+    XrefHeader h = {};
+    memcpy(h.magic, XREF_MAGIC, sizeof(h.magic));
+    h.num_arquivos = tabela_arquivos.size();
+    h.num_simbolos = tabela_simbolos.size();
+    h.num_sites = tabela_sites.size();
+    h.tam_nomes = nomes.size();
+    h.gramatica = grammar_fingerprint();
+
+    // Escreve em um arquivo temporário e renomeia, para nunca expor um índice pela metade
+    string temporario = caminho + ".tmp" + to_string(getpid());
+    {
+        ofstream out(temporario, ios::binary | ios::trunc);
+        out.write(reinterpret_cast<const char *>(&h), sizeof(h));
+        out.write(reinterpret_cast<const char *>(tabela_arquivos.data()), tabela_arquivos.size() * sizeof(XrefFile));
+        out.write(reinterpret_cast<const char *>(tabela_simbolos.data()), tabela_simbolos.size() * sizeof(XrefSymbol));
+        out.write(reinterpret_cast<const char *>(tabela_sites.data()), tabela_sites.size() * sizeof(XrefSite));
+        out.write(nomes.data(), nomes.size());
+        if (!out.flush())
+        {
+            erro = "não foi possível gravar " + temporario;
+            unlink(temporario.c_str());
+            return false;
+        }
+    }
+    if (rename(temporario.c_str(), caminho.c_str()) != 0)
+    {
+        erro = "não foi possível gravar " + caminho;
+        unlink(temporario.c_str());
+        return false;
+    }
+
+    stats.arquivos = arquivos.size();
+    stats.simbolos = tabela_simbolos.size();
+    stats.sites = tabela_sites.size();
+    stats.ms = chrono::duration<double, milli>(chrono::steady_clock::now() - inicio).count();
+    return true;
+}
+
+// ==========================
+// Leitura
+// ==========================
+
+XrefIndex::~XrefIndex()
+{
+    if (mapa != nullptr)
+        munmap(mapa, tamanho);
+}
+
+bool XrefIndex::open(const string &caminho, string &erro)
+{
+    int fd = ::open(caminho.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        erro = "não foi possível abrir " + caminho;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(XrefHeader))
+    {
+        close(fd);
+        erro = caminho + ": não é um índice";
+        return false;
+    }
+    void *m = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (m == MAP_FAILED)
+    {
+        erro = "não foi possível mapear " + caminho;
+        return false;
+    }
+
+    const char *base = static_cast<const char *>(m);
+    XrefHeader h;
+    memcpy(&h, base, sizeof(h));
+    uint64_t esperado = sizeof(XrefHeader) + (uint64_t)h.num_arquivos * sizeof(XrefFile) +
+                        h.num_simbolos * sizeof(XrefSymbol) + h.num_sites * sizeof(XrefSite) + h.tam_nomes;
+    if (memcmp(h.magic, XREF_MAGIC, sizeof(h.magic)) != 0 || h.num_simbolos > (uint64_t)st.st_size ||
+        h.num_sites > (uint64_t)st.st_size || h.tam_nomes > (uint64_t)st.st_size || esperado != (uint64_t)st.st_size)
+    {
+        munmap(m, st.st_size);
+        erro = caminho + ": não é um índice (ou está corrompido)";
+        return false;
+    }
+    if (h.gramatica != grammar_fingerprint())
+    {
+        munmap(m, st.st_size);
+        erro = caminho + ": índice de outra versão da gramática";
+        return false;
+    }
+
+    if (mapa != nullptr)
+        munmap(mapa, tamanho);
+    mapa = m;
+    tamanho = st.st_size;
+    num_arquivos = h.num_arquivos;
+    num_simbolos = h.num_simbolos;
+    total_sites = h.num_sites;
+    tam_nomes = h.tam_nomes;
+    arquivos = reinterpret_cast<const XrefFile *>(base + sizeof(XrefHeader));
+    simbolos = reinterpret_cast<const XrefSymbol *>(arquivos + num_arquivos);
+    sites = reinterpret_cast<const XrefSite *>(simbolos + num_simbolos);
+    nomes = reinterpret_cast<const char *>(sites + total_sites);
+    return true;
+}
+
+// Fora dos limites (índice corrompido) vira nome vazio
+string_view XrefIndex::nome(uint64_t inicio, uint32_t tam) const
+{
+    if (inicio > tam_nomes || tam > tam_nomes - inicio)
+        return string_view();
+    return string_view(nomes + inicio, tam);
+}
+
+// i vem de XrefSite::arquivo, que num índice corrompido pode passar do fim
+string_view XrefIndex::file_name(size_t i) const
+{
+    if (i >= num_arquivos)
+        return string_view();
+    return nome(arquivos[i].nome, arquivos[i].tam_nome);
+}
+
+string_view XrefIndex::symbol_name(size_t i) const
+{
+    return nome(simbolos[i].nome, simbolos[i].tam_nome);
+}
+
+pair<const XrefSite *, const XrefSite *> XrefIndex::symbol_sites(size_t i) const
+{
+    const XrefSymbol &s = simbolos[i];
+    if (s.primeiro > total_sites || s.num_sites > total_sites - s.primeiro)
+        return {sites, sites};
+    return {sites + s.primeiro, sites + s.primeiro + s.num_sites};
+}
+
+pair<const XrefSite *, const XrefSite *> XrefIndex::find(string_view procurado) const
+{
+    size_t baixo = 0, alto = num_simbolos;
+    while (baixo < alto)
+    {
+        size_t meio = baixo + (alto - baixo) / 2;
+        if (symbol_name(meio) < procurado)
+            baixo = meio + 1;
+        else
+            alto = meio;
+    }
+    if (baixo < num_simbolos && symbol_name(baixo) == procurado)
+        return symbol_sites(baixo);
+    return {sites, sites};
+}
@@ -0,0 +1,142 @@
+/*
+ * Trabalho de Compiladores - Índice de Referências Cruzadas
+ *
+ * Autor: Caio Broering Pinho
+ * Sistema: GNU/Linux
+ * Linguagem: C++17
+ * Compilador: g++ versão 13.3.0
+ *
+ * Descrição:
+ * Este arquivo define o índice invertido de um conjunto de códigos: para cada
+ * identificador (variável ou IDFUN) guarda todas as ocorrências, com arquivo,
+ * offset, linha, coluna e papel (definição, chamada, parâmetro, declaração,
+ * atribuição ou leitura), tiradas da AST. O índice é um arquivo binário
+ * usado direto via mmap:
+ *
+ *   cabeçalho (XrefHeader, 48 bytes)
+ *   arquivos[num_arquivos]   nome, tamanho, mtime e XXH64 de cada código
+ *   símbolos[num_simbolos]   ordenados pelo nome; cada um aponta para um
+ *                            trecho contínuo das ocorrências
+ *   ocorrências[num_sites]   agrupadas por símbolo, em ordem de arquivo e offset
+ *   nomes[tam_nomes]         caminhos e identificadores, sem separadores
+ *
+ * Uma consulta é uma busca binária nos símbolos, sem ler nada além das
+ * páginas tocadas. A construção analisa os arquivos em paralelo; ao
+ * atualizar um índice existente, arquivos com mesmo tamanho e mtime (ou,
+ * se mudaram, com o mesmo conteúdo) reaproveitam as ocorrências antigas sem
+ * serem lidos de novo.
+ *
+ * Data: Outubro de 2026
+ */
+
+#ifndef XREF_H
+#define XREF_H
+
+#include "file_loader.h"
+#include "lexgen.h"
+#include "thread_pool.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+enum XrefRole
+{
+    XREF_DEF,    // def F(...)
+    XREF_CALL,   // F(...)
+    XREF_PARAM,  // def F(int a)
+    XREF_DECL,   // int a;
+    XREF_ASSIGN, // a = ...;
+    XREF_USE,    // leitura em expressão, argumento, print ou return
+    XREF_NUM_ROLES
+};
+
+// "def", "call", "param", "decl", "assign", "use"
+const char *xref_role_name(int papel);
+// Retorna -1 se o nome não é um papel
+int xref_role_from_name(const string &nome);
+
+// Formato em disco: só campos de tamanho fixo, sem enchimento
+struct XrefFile
+{
+    uint64_t nome; // offset em nomes
+    uint64_t tamanho;
+    int64_t mtime; // nanossegundos
+    uint64_t hash; // XXH64 do conteúdo
+    uint32_t tam_nome;
+    uint32_t com_erro; // não foi aceito pelo parser; fica sem ocorrências
+};
+
+struct XrefSymbol
+{
+    uint64_t nome;
+    uint64_t primeiro; // índice da primeira ocorrência
+    uint32_t tam_nome;
+    uint32_t num_sites;
+};
+
+struct XrefSite
+{
+    uint32_t arquivo;
+    uint32_t offset;
+    uint32_t linha;
+    uint32_t coluna;
+    uint32_t papel;
+};
+
+struct XrefStats
+{
+    size_t arquivos = 0;
+    size_t reindexados = 0;     // lidos e analisados
+    size_t reaproveitados = 0;  // ocorrências copiadas do índice anterior
+    size_t com_erro = 0;        // rejeitados pelo parser (sem ocorrências)
+    size_t simbolos = 0;
+    size_t sites = 0;
+    double ms = 0;
+};
+
+// Monta (ou atualiza, se o índice já existe) o índice dos arquivos; pastas
+// são percorridas recursivamente, tomando os arquivos cujo nome casa com
+// padroes (ver expand_paths). O índice passa a conter exatamente esses
+// arquivos. backend/tabelas escolhem o lexer, como na linha de comando.
+// erros recebe "arquivo: diagnóstico" de cada arquivo que não pôde ser indexado.
+bool build_xref_index(const string &caminho, const vector<string> &entradas, ThreadPool &pool, const string &backend,
+                      const DfaTables *tabelas, XrefStats &stats, vector<string> &erros, string &erro,
+                      const vector<string> &padroes = PADROES_FONTE);
+
+class XrefIndex
+{
+public:
+    XrefIndex() {}
+    ~XrefIndex();
+    XrefIndex(const XrefIndex &) = delete;
+    XrefIndex &operator=(const XrefIndex &) = delete;
+
+    bool open(const string &caminho, string &erro);
+
+    // Ocorrências do identificador, em ordem de arquivo e offset (vazio se não existe)
+    pair<const XrefSite *, const XrefSite *> find(string_view nome) const;
+
+    size_t num_files() const { return num_arquivos; }
+    size_t num_symbols() const { return num_simbolos; }
+    size_t num_sites() const { return total_sites; }
+    const XrefFile &file(size_t i) const { return arquivos[i]; }
+    string_view file_name(size_t i) const;
+    string_view symbol_name(size_t i) const;
+    pair<const XrefSite *, const XrefSite *> symbol_sites(size_t i) const;
+
+private:
+    void *mapa = nullptr;
+    size_t tamanho = 0;
+    const XrefFile *arquivos = nullptr;
+    const XrefSymbol *simbolos = nullptr;
+    const XrefSite *sites = nullptr;
+    const char *nomes = nullptr;
+    size_t num_arquivos = 0, num_simbolos = 0, total_sites = 0, tam_nomes = 0;
+
+    string_view nome(uint64_t inicio, uint32_t tam) const;
+};
+
+#endif // XREF_H